@@ -0,0 +1,102 @@
+#include "arena.h"
+
+// Every allocation is rounded up to this, so that the next one is aligned too
+#define _ARENA_ALIGNMENT sizeof(max_align_t)
+
+arena create_arena(const size_t block_size) {
+    const arena arena = {
+        .first = NULL,
+        .current = NULL,
+        .block_size = block_size != 0 ? block_size : ARENA_DEFAULT_BLOCK_SIZE,
+    };
+
+    return arena;
+}
+
+void free_arena(arena arena) {
+    arena_block* block = arena.first;
+
+    while(block != NULL) {
+        arena_block* next = block->next;
+        free(block);
+        block = next;
+    }
+}
+
+void* arena_allocate(arena* arena, const size_t size) {
+    const size_t rounded = (size + _ARENA_ALIGNMENT - 1) / _ARENA_ALIGNMENT * _ARENA_ALIGNMENT;
+
+    arena_block* block = arena->current;
+
+    if(block == NULL || block->capacity - block->used < rounded) block = _arena_next_block(arena,rounded);
+
+    void* memory = (unsigned char*) block->memory + block->used;
+    block->used += rounded;
+
+    arena->stats.allocations += 1;
+
+    return memory;
+}
+
+arena_mark arena_position(const arena* arena) {
+    const arena_mark mark = {
+        .block = arena->current,
+        .used = arena->current != NULL ? arena->current->used : 0,
+    };
+
+    return mark;
+}
+
+void arena_rewind(arena* arena, const arena_mark mark) {
+    // A mark taken before the first allocation rewinds to the very start
+    arena->current = mark.block != NULL ? mark.block : arena->first;
+
+    if(arena->current != NULL) arena->current->used = mark.block != NULL ? mark.used : 0;
+}
+
+void arena_reset(arena* arena) {
+    arena->current = arena->first;
+
+    if(arena->current != NULL) arena->current->used = 0;
+
+    arena->stats.resets += 1;
+}
+
+arena_block* _arena_next_block(arena* arena, const size_t size) {
+    arena_block* previous = arena->current;
+    arena_block* block = previous != NULL ? previous->next : arena->first;
+
+    // Blocks after the current one are free, skip those too small for this allocation
+    while(block != NULL) {
+        if(block->capacity >= size) {
+            block->used = 0;
+            arena->current = block;
+            return block;
+        }
+
+        previous = block;
+        block = block->next;
+    }
+
+    const size_t capacity = size > arena->block_size ? size : arena->block_size;
+
+    block = malloc(sizeof(arena_block) + capacity);
+
+    if(block == NULL) {
+        perror("malloc has failed");
+        exit(1);
+    }
+
+    block->next = NULL;
+    block->capacity = capacity;
+    block->used = 0;
+
+    if(previous != NULL) previous->next = block;
+    else arena->first = block;
+
+    arena->current = block;
+    arena->stats.system_allocations += 1;
+    arena->stats.reserved_bytes += capacity;
+
+    return block;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file CSnakeLadderArena.h
+ * @brief Header file containing the region allocator boards are carved from.
+ *
+ * This header file defines functions for an `arena`: allocating is bumping a pointer, and a board (or a whole batch of boards) is torn down by resetting the arena or rewinding it to an `arena_mark`, without freeing anything piece by piece. The blocks of an arena are kept for reuse, so generating board after board into the same arena does not touch the system allocator once it has warmed up.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_ARENA_H
+#define CSNAKE_LADDER_ARENA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+
+#include "types.h"
+
+/**
+ * @def ARENA_DEFAULT_BLOCK_SIZE
+ * @brief The block size used when `create_arena` is given 0.
+ */
+#define ARENA_DEFAULT_BLOCK_SIZE (256 * 1024)
+
+/**
+ * @brief Function to create an empty arena. No memory is reserved until the first allocation.
+ *
+ * @param block_size The smallest capacity of a block, or 0 for `ARENA_DEFAULT_BLOCK_SIZE`. Larger allocations get a block of their own size.
+ * @return The `arena`. (Caller needs to release it with `free_arena`)
+ */
+arena create_arena(const size_t block_size);
+
+/**
+ * @brief Frees every block of an arena, which invalidates all memory carved from it.
+ */
+void free_arena(arena arena);
+
+/**
+ * @brief Function to carve memory from an arena.
+ *
+ * The memory is aligned for any type and is not initialised.
+ *
+ * @param arena Pointer to the arena.
+ * @param size The number of bytes.
+ * @return Pointer to the memory, which stays valid until the arena is reset, rewound past it or freed.
+ */
+void* arena_allocate(arena* arena, const size_t size);
+
+/**
+ * @brief Function to record the current position of an arena.
+ *
+ * @param arena Pointer to the arena.
+ * @return The `arena_mark` to pass to `arena_rewind`.
+ */
+arena_mark arena_position(const arena* arena);
+
+/**
+ * @brief Gives back everything carved from an arena since `mark` was taken.
+ *
+ * @param arena Pointer to the arena.
+ * @param mark A mark taken from the same arena, after its last reset.
+ */
+void arena_rewind(arena* arena, const arena_mark mark);
+
+/**
+ * @brief Gives back everything carved from an arena, keeping its blocks for reuse.
+ *
+ * @param arena Pointer to the arena.
+ */
+void arena_reset(arena* arena);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief Function to move an arena on to a block with room for `size` bytes, reusing the blocks after the current one before asking the system allocator for a new one.
+ *
+ * @param arena Pointer to the arena.
+ * @param size The number of bytes needed.
+ * @return Pointer to the block, which becomes `arena->current`.
+ */
+arena_block* _arena_next_block(arena* arena, const size_t size);
+
+#endif // CSNAKE_LADDER_ARENA_H
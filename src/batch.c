@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "types.h"
+#include "jobs.h"
+#include "arena.h"
+#include "simulation.h"
+
+// Works through a stream of jobs without any prompts, see jobs.h for the format of a job.
+//
+// Usage: batch [jobs file] [output file]
+//        batch --check-lanes
+//
+// Jobs are read from `jobs file` (stdin by default or with `-`) and their results written to `output file`
+// (stdout by default or with `-`). The output is fully buffered, so a long queue is written in large blocks
+// instead of a line at a time; rejected jobs are reported on stderr with their line and skipped. Every board
+// is generated into the same arena, which is reset after each job. The exit status is 1 if any job failed.
+//
+// With --check-lanes, short ranges of games that do not fill every lane of `simulate_games` are played on a few
+// boards and compared with the same games played one at a time by `simulate_game`. The exit status is 2 if any
+// of them differ.
+//
+// Built with -DCSNAKE_TRACE, the instrumentation of all jobs is printed to stderr at the end, and written
+// as a Chrome trace to the file named by $CSNAKE_TRACE_EVENTS.
+
+#define BATCH_OUTPUT_BUFFER_SIZE (1 << 16)
+#define BATCH_CHECK_BOARDS 8
+#define BATCH_CHECK_MAXIMUM_GAMES 17
+
+static bool _same_result(const game_result left, const game_result right) {
+    return left.finished == right.finished && left.winner == right.winner && left.rounds == right.rounds && left.turns == right.turns
+        && left.rolls == right.rolls && left.ladder_hits == right.ladder_hits && left.snake_hits == right.snake_hits
+        && left.invalidated_moves == right.invalidated_moves;
+}
+
+static int _check_lanes(void) {
+    // Fewer games than lanes, a lane short of a full block, one over, and ranges that refill some lanes but not all
+    const unsigned int counts[] = { 1, 7, 8, 9, 15, 17 };
+    const simulation_options options = { 0 };
+
+    unsigned int checked = 0, mismatched = 0;
+
+    for(unsigned int seed = 1;seed <= BATCH_CHECK_BOARDS;seed++) {
+        const config config = { .number_of_players = 1 + seed % MAXIMUM_NUMBER_OF_PLAYERS, .difficulty = 1 + seed % 10, .seed = seed };
+        board board = generate_board_from_config(config);
+
+        for(unsigned int i = 0;i < sizeof(counts) / sizeof(counts[0]);i++) {
+            game_result results[BATCH_CHECK_MAXIMUM_GAMES];
+
+            // The range starts at a different game for every board, so the streams are not always the first ones
+            simulate_games(board,seed,counts[i],options,results);
+
+            for(unsigned int game = 0;game < counts[i];game++) {
+                const game_result expected = simulate_game(board,rng_stream_seed(config.seed,seed + game + 1),options);
+
+                if(!_same_result(results[game],expected)) mismatched += 1;
+                checked += 1;
+            }
+        }
+
+        free_board(board);
+    }
+
+    fprintf(stderr,"%u games checked against simulate_game, %u mismatched\n",checked,mismatched);
+
+    return mismatched == 0 ? 0 : 2;
+}
+
+int main(int argc, char** argv) {
+    if(argc == 2 && strcmp(argv[1],"--check-lanes") == 0) return _check_lanes();
+
+    const char *const jobs_path = argc > 1 ? argv[1] : "-";
+    const char *const output_path = argc > 2 ? argv[2] : "-";
+
+    if(argc > 3) {
+        fprintf(stderr,"Usage: %s [jobs file] [output file]\n       %s --check-lanes\n",argv[0],argv[0]);
+        return 1;
+    }
+
+    validate_message error;
+    job_reader reader = open_job_reader(jobs_path,&error);
+
+    if(error != NULL) {
+        fprintf(stderr,"%s: %s",jobs_path,error);
+        return 1;
+    }
+
+    FILE* output = strcmp(output_path,"-") == 0 ? stdout : fopen(output_path,"w");
+
+    if(output == NULL) {
+        perror("fopen has failed");
+        close_job_reader(reader);
+        return 1;
+    }
+
+    if(setvbuf(output,NULL,_IOFBF,BATCH_OUTPUT_BUFFER_SIZE) != 0) {
+        perror("setvbuf has failed");
+    }
+
+    arena boards = create_arena(0);
+    trace_begin_session(getenv(TRACE_EVENTS_VARIABLE));
+    unsigned long jobs = 0, failed = 0;
+    job job;
+
+    while(read_job(&reader,&job,&error)) {
+        if(error == NULL) error = run_job(job,reader.line_number,&boards,output);
+
+        if(error != NULL) {
+            fprintf(stderr,"%s:%lu: %s",jobs_path,reader.line_number,error);
+            failed += 1;
+        }
+
+        jobs += 1;
+    }
+
+    if(ferror(reader.input)) {
+        perror("Reading the job stream has failed");
+        failed += 1;
+    }
+
+    trace_end_session(stderr);
+    close_job_reader(reader);
+    free_arena(boards);
+
+    if(fflush(output) != 0 || ferror(output)) {
+        perror("Writing the results has failed");
+        failed += 1;
+    }
+
+    if(output != stdout) fclose(output);
+
+    fprintf(stderr,"%lu jobs, %lu failed\n",jobs,failed);
+
+    return failed == 0 ? 0 : 1;
+}
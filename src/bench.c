@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "types.h"
+#include "config.h"
+#include "board.h"
+#include "timer.h"
+#include "arena.h"
+
+// Benchmark of board generation over every difficulty x players combination the config accepts.
+//
+// Usage: bench [repetitions] [output.csv]
+//
+// Every combination is generated `repetitions` times with the seeds 1..repetitions, so two runs of the
+// same version generate the very same boards. The latency of each generation phase is written as
+// p50/p99 in nanoseconds, next to the allocations and retries per board, as CSV to `output.csv`.
+// Boards are generated into one arena that is reset after each of them, the way batch workloads do,
+// so `system_allocations_per_board` shows how often generation still reaches the system allocator.
+//
+// After that, a lobby where players join one at a time up to 10 and leave again is played through for every
+// difficulty, and the mean time of a change with `regenerate_board` is printed next to generating the board anew.
+//
+// Built with -DCSNAKE_TRACE, the counters and latency histograms of the whole run are printed to stderr at
+// the end, and every phase is written as a Chrome trace to the file named by $CSNAKE_TRACE_EVENTS.
+
+#define BENCH_DEFAULT_REPETITIONS 25
+#define BENCH_DEFAULT_OUTPUT "bench_generation.csv"
+
+static const char *const _phase_names[number_of_generation_phases] = {
+    "create_labeled_board",
+    "generate_ladders",
+    "generate_snakes",
+    "suggested_end_point",
+    "draw_line",
+};
+
+typedef struct samples {
+    uint64_t* values;
+    size_t count;
+    size_t capacity;
+} samples;
+
+static samples _samples[number_of_generation_phases];
+
+static void _record_sample(const generation_phase phase, const uint64_t nanoseconds) {
+    samples* samples = &_samples[phase];
+
+    if(samples->count == samples->capacity) {
+        samples->capacity = samples->capacity == 0 ? 1024 : samples->capacity * 2;
+        samples->values = realloc(samples->values,samples->capacity * sizeof(uint64_t));
+
+        if(samples->values == NULL) {
+            perror("realloc has failed");
+            exit(1);
+        }
+    }
+
+    samples->values[samples->count++] = nanoseconds;
+}
+
+static int _compare_samples(const void* a, const void* b) {
+    const uint64_t left = *(const uint64_t*) a;
+    const uint64_t right = *(const uint64_t*) b;
+
+    return (left > right) - (left < right);
+}
+
+static uint64_t _percentile(const samples samples, const double percentile) {
+    if(samples.count == 0) return 0;
+
+    // Nearest rank on the sorted samples
+    size_t rank = (size_t)(percentile * samples.count + 0.999999);
+    if(rank == 0) rank = 1;
+    if(rank > samples.count) rank = samples.count;
+
+    return samples.values[rank - 1];
+}
+
+static void _bench_lobby(const unsigned int repetitions) {
+    printf("%4s %14s %14s\n","diff","regenerate","generate");
+
+    for(unsigned int difficulty = 1;difficulty <= 10;difficulty++) {
+        uint64_t regenerating = 0, generating = 0;
+        unsigned long long changes = 0;
+
+        for(unsigned int repetition = 0;repetition < repetitions;repetition++) {
+            const config first = { .number_of_players = 1, .difficulty = difficulty, .seed = repetition + 1 };
+            board lobby = generate_board_from_config(first);
+
+            // 2, 3, ... 10 players and back down to 1
+            for(unsigned int step = 1;step < 19;step++) {
+                const config config = {
+                    .number_of_players = step < 10 ? step + 1 : 19 - step,
+                    .difficulty = difficulty,
+                    .seed = repetition + 1,
+                };
+
+                uint64_t started = monotonic_nanoseconds();
+                regenerate_board(&lobby,config);
+                regenerating += monotonic_nanoseconds() - started;
+
+                started = monotonic_nanoseconds();
+                const board board = generate_board_from_config(config);
+                generating += monotonic_nanoseconds() - started;
+
+                free_board(board);
+                changes += 1;
+            }
+
+            free_board(lobby);
+        }
+
+        printf("%4u %12lluns %12lluns\n",difficulty,(unsigned long long)(regenerating / changes),(unsigned long long)(generating / changes));
+    }
+}
+
+int main(int argc, char** argv) {
+    const unsigned int repetitions = argc > 1 ? (unsigned int) strtoul(argv[1],NULL,10) : BENCH_DEFAULT_REPETITIONS;
+    const char *const output_path = argc > 2 ? argv[2] : BENCH_DEFAULT_OUTPUT;
+
+    if(repetitions == 0) {
+        fprintf(stderr,"Usage: %s [repetitions] [output.csv]\n",argv[0]);
+        return 1;
+    }
+
+    FILE* output = fopen(output_path,"w");
+
+    if(output == NULL) {
+        perror("fopen has failed");
+        return 1;
+    }
+
+    fprintf(output,"difficulty,players,board_size,ladders,snakes,boards");
+    for(int phase = 0;phase < number_of_generation_phases;phase++) {
+        fprintf(output,",%s_calls,%s_p50_ns,%s_p99_ns",_phase_names[phase],_phase_names[phase],_phase_names[phase]);
+    }
+    fprintf(output,",missing_ladders_per_board,missing_snakes_per_board,allocations_per_board,system_allocations_per_board,start_retries_per_board,start_retries_max,end_retries_per_board,end_retries_max,shortened_lines_per_board\n");
+
+    printf("%4s %4s %6s %8s %8s %14s %14s %14s %12s %12s\n","diff","plrs","size","ladders","snakes","ladders p50","ladders p99","snakes p99","start retry","end retry");
+
+    set_generation_probe(&_record_sample);
+    trace_begin_session(getenv(TRACE_EVENTS_VARIABLE));
+
+    arena boards = create_arena(0);
+
+    // Only combinations the interactive game would accept are measured
+    for(unsigned int difficulty = 0;difficulty <= 11;difficulty++) {
+        if(ensure_difficulty_within_1_10(difficulty) != NULL) continue;
+
+        for(unsigned int players = 0;players <= 11;players++) {
+            if(ensure_players_within_1_10(players) != NULL) continue;
+
+            for(int phase = 0;phase < number_of_generation_phases;phase++) _samples[phase].count = 0;
+
+            unsigned int board_size = 0;
+            unsigned long long ladders = 0;
+            unsigned long long missing_ladders = 0;
+            unsigned long long snakes = 0;
+            unsigned long long missing_snakes = 0;
+            unsigned long long allocations = 0;
+            const unsigned long long system_allocations_before = boards.stats.system_allocations;
+            unsigned long long start_retries = 0, start_retries_max = 0;
+            unsigned long long end_retries = 0, end_retries_max = 0;
+            unsigned long long shortened_lines = 0;
+
+            for(unsigned int repetition = 0;repetition < repetitions;repetition++) {
+                const config config = {
+                    .number_of_players = players,
+                    .difficulty = difficulty,
+                    .seed = repetition + 1,
+                };
+
+                reset_generation_stats();
+
+                const board board = generate_board_in_arena(config,&boards);
+                const generation_stats stats = current_generation_stats();
+
+                board_size = board.board_size;
+                ladders += board.number_of_ladders;
+                missing_ladders += board.requested_ladders - board.number_of_ladders;
+                snakes += board.number_of_snakes;
+                missing_snakes += board.requested_snakes - board.number_of_snakes;
+                allocations += stats.allocations;
+                start_retries += stats.start_retries;
+                end_retries += stats.end_retries;
+                shortened_lines += stats.shortened_lines;
+
+                if(stats.start_retries > start_retries_max) start_retries_max = stats.start_retries;
+                if(stats.end_retries > end_retries_max) end_retries_max = stats.end_retries;
+
+                arena_reset(&boards);
+            }
+
+            for(int phase = 0;phase < number_of_generation_phases;phase++) {
+                qsort(_samples[phase].values,_samples[phase].count,sizeof(uint64_t),&_compare_samples);
+            }
+
+            fprintf(output,"%u,%u,%u,%.2f,%.2f,%u",difficulty,players,board_size,(double) ladders / repetitions,(double) snakes / repetitions,repetitions);
+            for(int phase = 0;phase < number_of_generation_phases;phase++) {
+                fprintf(output,",%zu,%llu,%llu",
+                    _samples[phase].count,
+                    (unsigned long long) _percentile(_samples[phase],0.50),
+                    (unsigned long long) _percentile(_samples[phase],0.99)
+                );
+            }
+            fprintf(output,",%.2f,%.2f,%.2f,%.2f,%.2f,%llu,%.2f,%llu,%.2f\n",
+                (double) missing_ladders / repetitions,
+                (double) missing_snakes / repetitions,
+                (double) allocations / repetitions,
+                (double)(boards.stats.system_allocations - system_allocations_before) / repetitions,
+                (double) start_retries / repetitions, start_retries_max,
+                (double) end_retries / repetitions, end_retries_max,
+                (double) shortened_lines / repetitions
+            );
+
+            printf("%4u %4u %6u %8.1f %8.1f %12lluns %12lluns %12lluns %12.1f %12.1f\n",
+                difficulty,players,board_size,(double) ladders / repetitions,(double) snakes / repetitions,
+                (unsigned long long) _percentile(_samples[phase_generate_ladders],0.50),
+                (unsigned long long) _percentile(_samples[phase_generate_ladders],0.99),
+                (unsigned long long) _percentile(_samples[phase_generate_snakes],0.99),
+                (double) start_retries / repetitions,
+                (double) end_retries / repetitions
+            );
+        }
+    }
+
+    set_generation_probe(NULL);
+    trace_end_session(stderr);
+    fclose(output);
+
+    printf("arena: %llu allocations, %llu system allocations, %zu bytes reserved\n",
+        boards.stats.allocations,boards.stats.system_allocations,boards.stats.reserved_bytes);
+    free_arena(boards);
+
+    for(int phase = 0;phase < number_of_generation_phases;phase++) free(_samples[phase].values);
+
+    _bench_lobby(repetitions);
+
+    return 0;
+}
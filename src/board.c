@@ -1,32 +1,365 @@
 #include "board.h"
+#include "storage.h"
+
+// Counters are per thread, so boards can be generated on many threads at once
+static _Thread_local generation_stats _stats;
+static _Thread_local generation_probe _probe;
+
+// The arena the board being generated on this thread is carved from, or NULL for the system allocator
+static _Thread_local arena* _arena;
+
+// Starts timing a phase, only reads the clock while a probe is installed or tracing is compiled in
+static inline uint64_t _phase_started() {
+#if defined(CSNAKE_TRACE)
+    return monotonic_nanoseconds();
+#else
+    return _probe != NULL ? monotonic_nanoseconds() : 0;
+#endif
+}
+
+static inline void _phase_finished(const generation_phase phase,const uint64_t started) {
+#if defined(CSNAKE_TRACE)
+    const uint64_t finished = monotonic_nanoseconds();
+
+    trace_record((trace_span) phase,started,finished);
+    if(_probe != NULL) _probe(phase,finished - started);
+#else
+    if(_probe != NULL) _probe(phase,monotonic_nanoseconds() - started);
+#endif
+}
+
+static void* _allocate(const size_t size) {
+    _stats.allocations += 1;
+
+    if(_arena != NULL) return arena_allocate(_arena,size);
+
+    void* memory = malloc(size);
+
+    if(size != 0 && memory == NULL) {
+        perror("malloc has failed");
+        exit(1);
+    }
+
+    return memory;
+}
+
+// Memory carved from an arena is given back with the arena, not one piece at a time
+static void _release(void* memory) {
+    if(_arena == NULL) free(memory);
+}
+
+// An arena cannot grow a piece in place, so the contents move to a new one
+static void* _reallocate(void* memory, const size_t size, const size_t new_size) {
+    if(_arena != NULL) {
+        void* moved = _allocate(new_size);
+        memcpy(moved,memory,size < new_size ? size : new_size);
+        return moved;
+    }
+
+    _stats.allocations += 1;
+
+    void* moved = realloc(memory,new_size);
+
+    if(new_size != 0 && moved == NULL) {
+        perror("realloc has failed");
+        exit(1);
+    }
+
+    return moved;
+}
+
+// The scratch memory of a generation step can be handed back to the arena as soon as the step is done
+static arena_mark _scratch_begin() {
+    const arena_mark none = { 0 };
+    return _arena != NULL ? arena_position(_arena) : none;
+}
+
+static void _scratch_end(const arena_mark mark) {
+    if(_arena != NULL) arena_rewind(_arena,mark);
+}
 
 board generate_board_from_config(config config) {
-    // Calculate the board size based on the difficulty
-    const unsigned int board_size = (1 + (config.difficulty - 1) * 0.15) * sqrt(config.number_of_players) * 10;
+    return generate_board_in_arena(config,NULL);
+}
 
-    srand(time(NULL));
+board generate_board_in_arena(config config, arena* arena) {
+    const unsigned int board_size = board_size_of(config);
+
+    // Every random choice made while generating comes from this one stream, so the seed alone reproduces the board
+    rng rng = rng_from_seed(config.seed);
+
+    const bool sparse = _is_sparse(config,board_size);
+
+    _arena = arena;
 
     board board = {
+        .arena = arena,
+        .config = config,
         .board_size = board_size,
         .players = _create_players(config.number_of_players),
-        .inner_board = _create_labeled_board(board_size)
+        .number_of_players = config.number_of_players,
     };
 
-    _generate_snake_and_ladders(config,board);
+    const uint64_t started = _phase_started();
+    if(!sparse) {
+        board.inner_board = _create_labeled_board(board_size);
+        _create_occupancy_grids(&board);
+    }
+    _create_segment_index(&board);
+    _phase_finished(phase_create_labeled_board,started);
+
+    _generate_snake_and_ladders(&rng,config,&board);
+
+    TRACE_BEGIN(jumps);
+    board.jumps = _compile_jump_table(board);
+    TRACE_END(span_compile_jump_table,jumps);
+
+    _arena = NULL;
 
     return board;
 }
 
+void regenerate_board(board* board, const config config) {
+    const unsigned int board_size = board_size_of(config);
+
+    // A loaded board is a read-only file, and a board that changes representation has no cells to keep
+    if(board->mapping.address != NULL || _is_sparse(config,board_size) != board_is_sparse(*board)) {
+        arena* arena = board->arena;
+        free_board(*board);
+
+        // `board` has constant members, so it is built in place
+        const struct board generated = generate_board_in_arena(config,arena);
+        memcpy(board,&generated,sizeof(generated));
+        return;
+    }
+
+    _arena = board->arena;
+
+    const bool resized = board_size != board->board_size;
+    const bool patch_jumps = !resized && !board_is_sparse(*board);
+
+    unsigned int requested_ladders, requested_snakes;
+    _requested_entities(config,board_size,&requested_ladders,&requested_snakes);
+
+    // Keep the oldest ladders and snakes that still fit on the board, the cells of the others are cleared
+    unsigned int kept_ladders = 0;
+
+    for(unsigned int i = 0;i < board->number_of_ladders;i++) {
+        const ladder ladder = board->ladders[i];
+        const bool fits = kept_ladders < requested_ladders
+            && ladder.start.x < board_size && ladder.end.x < board_size && ladder.end.y < board_size;
+
+        if(fits) {
+            memcpy(&board->ladders[kept_ladders],&ladder,sizeof(ladder));
+            memcpy(&board->ladder_aims[kept_ladders],&board->ladder_aims[i],sizeof(point));
+            kept_ladders += 1;
+        }
+        else if(!resized) {
+            _set_line_roles(*board,ladder.start,board->ladder_aims[i],ladder.end,none,none,none);
+            if(patch_jumps) board->jumps.destination[label_for_point(*board,ladder.start)] = label_for_point(*board,ladder.start);
+        }
+    }
+
+    unsigned int kept_snakes = 0;
+
+    for(unsigned int i = 0;i < board->number_of_snakes;i++) {
+        const snake snake = board->snakes[i];
+
+        // A snake head on the final cell would make the game impossible to win
+        const bool fits = kept_snakes < requested_snakes
+            && snake.head.x < board_size && snake.tail.x < board_size && snake.head.y < board_size
+            && !(snake.head.x == board_size - 1 && snake.head.y == board_size - 1);
+
+        if(fits) {
+            memcpy(&board->snakes[kept_snakes],&snake,sizeof(snake));
+            memcpy(&board->snake_aims[kept_snakes],&board->snake_aims[i],sizeof(point));
+            kept_snakes += 1;
+        }
+        else if(!resized) {
+            _set_line_roles(*board,snake.tail,board->snake_aims[i],snake.head,none,none,none);
+            if(patch_jumps) board->jumps.destination[label_for_point(*board,snake.head)] = label_for_point(*board,snake.head);
+        }
+    }
+
+    board->number_of_ladders = kept_ladders;
+    board->number_of_snakes = kept_snakes;
+
+    if(resized) {
+        const uint64_t started = _phase_started();
+
+        // `board_size` is constant for everyone else, like the rest of the board it is written in place
+        memcpy((void*) &board->board_size,&board_size,sizeof(board_size));
+
+        // The labels of the cells follow from the size, so the cells are laid out again and only the kept ladders and snakes are drawn on them.
+        // A sparse board has no cells, the index below is all it needs
+        if(!board_is_sparse(*board)) {
+            _release(board->inner_board);
+            _release(board->occupied.words);
+
+            board->inner_board = _create_labeled_board(board_size);
+            _create_occupancy_grids(board);
+
+            for(unsigned int i = 0;i < kept_ladders;i++) {
+                const ladder ladder = board->ladders[i];
+                _set_line_roles(*board,ladder.start,board->ladder_aims[i],ladder.end,is_ladder_start,is_ladder,is_ladder);
+            }
+
+            for(unsigned int i = 0;i < kept_snakes;i++) {
+                const snake snake = board->snakes[i];
+                _set_line_roles(*board,snake.tail,board->snake_aims[i],snake.head,is_snake,is_snake,is_snake_head);
+            }
+        }
+
+        _phase_finished(phase_create_labeled_board,started);
+    }
+
+    // The kept ladders and snakes have moved down their arrays, so they are indexed again under their new numbers
+    if(board->arena == NULL) free_segment_index(*board->segments);
+    *board->segments = create_segment_index(board_size,board->arena);
+
+    _index_segments(board,entity_ladder,0,kept_ladders);
+    _index_segments(board,entity_snake,0,kept_snakes);
+
+    // The arrays were allocated for the counts requested before
+    if(requested_ladders > board->requested_ladders) {
+        board->ladders = _reallocate(board->ladders,board->requested_ladders * sizeof(ladder),requested_ladders * sizeof(ladder));
+        board->ladder_aims = _reallocate(board->ladder_aims,board->requested_ladders * sizeof(point),requested_ladders * sizeof(point));
+        board->requested_ladders = requested_ladders;
+    }
+
+    if(requested_snakes > board->requested_snakes) {
+        board->snakes = _reallocate(board->snakes,board->requested_snakes * sizeof(snake),requested_snakes * sizeof(snake));
+        board->snake_aims = _reallocate(board->snake_aims,board->requested_snakes * sizeof(point),requested_snakes * sizeof(point));
+        board->requested_snakes = requested_snakes;
+    }
+
+    // The stream numbers of the dice of a game are small, so a change never repeats the rolls of one
+    rng rng = rng_for_stream(config.seed,REGENERATION_STREAMS + board->revision);
+
+    // Only the missing ladders and snakes are placed, on cells sampled at random instead of an index of the whole board
+    cell_index eligible_starts = _create_sampled_cell_index(*board);
+
+    uint64_t started = _phase_started();
+    board->number_of_ladders = _place_ladders(&rng,board,&eligible_starts,kept_ladders,requested_ladders);
+    _phase_finished(phase_generate_ladders,started);
+
+    cell_index eligible_tails = _create_sampled_cell_index(*board);
+
+    started = _phase_started();
+    board->number_of_snakes = _place_snakes(&rng,board,&eligible_tails,kept_snakes,requested_snakes);
+    _phase_finished(phase_generate_snakes,started);
+
+    // A sparse board indexed its new ladders and snakes as it placed them
+    if(!board_is_sparse(*board)) {
+        _index_segments(board,entity_ladder,kept_ladders,board->number_of_ladders);
+        _index_segments(board,entity_snake,kept_snakes,board->number_of_snakes);
+    }
+
+    TRACE_BEGIN(jumps);
+
+    if(patch_jumps) {
+        for(unsigned int i = kept_ladders;i < board->number_of_ladders;i++) {
+            board->jumps.destination[label_for_point(*board,board->ladders[i].start)] = label_for_point(*board,board->ladders[i].end);
+        }
+
+        for(unsigned int i = kept_snakes;i < board->number_of_snakes;i++) {
+            board->jumps.destination[label_for_point(*board,board->snakes[i].head)] = label_for_point(*board,board->snakes[i].tail);
+        }
+    }
+    else {
+        _release(board->jumps.destination);
+        _release(board->jumps.from);
+        _release(board->jumps.to);
+
+        board->jumps = _compile_jump_table(*board);
+    }
+
+    TRACE_END(span_compile_jump_table,jumps);
+
+    // Players who stay keep their places, as long as those are still on the board
+    if(config.number_of_players != board->number_of_players) {
+        board->players = _reallocate(board->players,board->number_of_players * sizeof(struct player),config.number_of_players * sizeof(struct player));
+
+        for(unsigned int i = board->number_of_players;i < config.number_of_players;i++) {
+            const struct player player = { .position = 1 };
+            board->players[i] = player;
+        }
+
+        board->number_of_players = config.number_of_players;
+    }
+
+    for(unsigned int i = 0;i < board->number_of_players;i++) {
+        if(board->players[i].position > board_size * board_size) board->players[i].position = 1;
+    }
+
+    memcpy(&board->config,&config,sizeof(config));
+    board->revision += 1;
+
+    _arena = NULL;
+}
+
+generation_parameters generation_parameters_of(const config config) {
+    // The constants the difficulty levels were originally defined with
+    static const generation_parameters defaults = {
+        .board_size_base = 10,
+        .board_size_growth = 0.15,
+        .ladder_divisor = 7.5,
+        .snake_divisor = 10,
+        .players_modifier = 10,
+    };
+
+    return config.parameters != NULL ? *config.parameters : defaults;
+}
+
+unsigned int board_size_of(const config config) {
+    // Calculate the board size based on the difficulty
+    const generation_parameters parameters = generation_parameters_of(config);
+
+    return (1 + (config.difficulty - 1) * parameters.board_size_growth) * sqrt(config.number_of_players) * parameters.board_size_base;
+}
+
+generation_stats current_generation_stats() {
+    return _stats;
+}
+
+void reset_generation_stats() {
+    const generation_stats empty = { 0 };
+    _stats = empty;
+}
+
+void set_generation_probe(generation_probe probe) {
+    _probe = probe;
+}
+
 void free_board(board board) {
+    // The arena owns the memory, tearing the board down is up to whoever resets it
+    if(board.arena != NULL) return;
+
+    // A loaded board only allocated its players, the rest is the mapped file
+    if(board.mapping.address != NULL) {
+        free(board.players);
+        unmap_board_file(board.mapping);
+        return;
+    }
+
     // Free memory
     free(board.players);
     free(board.ladders);
+    free(board.snakes);
+    free(board.ladder_aims);
+    free(board.snake_aims);
+    free(board.inner_board);
+    free(board.jumps.destination);
+    free(board.jumps.from);
+    free(board.jumps.to);
 
-    for (int i = 0; i < board.board_size; i++) {
-        free(board.inner_board[i]);
+    if(board.segments != NULL) {
+        free_segment_index(*board.segments);
+        free(board.segments);
     }
 
-    free(board.inner_board);
+    // All grids share the block of the first one
+    free(board.occupied.words);
 }
 
 players_array_pointer _create_players(const unsigned int number_of_players) {
@@ -36,15 +369,10 @@ players_array_pointer _create_players(const unsigned int number_of_players) {
     //    - The return value of `malloc` is a pointer to the allocated memory
     //      block, or `NULL` if the allocation fails (there's not enough memory
     //      available).
-    players_array_pointer players = malloc(number_of_players * sizeof(struct player));
-
-    if(players == NULL) {
-        perror("malloc has failed");
-        exit(1);
-    }
+    players_array_pointer players = _allocate(number_of_players * sizeof(struct player));
 
     for(int i = 0;i < number_of_players;i++) {
-        const struct player player = { 0, 0}; 
+        const struct player player = { .position = 1 };
         players[i] = player;
     }
 
@@ -52,58 +380,211 @@ players_array_pointer _create_players(const unsigned int number_of_players) {
 }
 
 board_cell_array_pointer _create_labeled_board(const unsigned int board_size) {
-    board_cell** inner_board = malloc(board_size * sizeof(struct board_cell*));
+    // One block for the whole grid, so that neighbouring cells are neighbours in memory too
+    const size_t number_of_cells = (size_t) board_size * board_size;
+    board_cell_array_pointer inner_board = _allocate(number_of_cells * sizeof(struct board_cell));
 
-    if(inner_board == NULL) {
-        perror("malloc has failed");
-        exit(1);
+    // Initalize board, row by row
+    for (size_t i = 0; i < number_of_cells; i++) {
+        const board_cell cell = { 
+            .label = i + 1,
+            .role = none
+        };
+
+        inner_board[i] = cell;
     }
+    
+    return inner_board;
+}
+
+void _create_occupancy_grids(board* board) {
+    const size_t words = occupancy_grid_words(board->board_size);
+
+    // One block for the occupied grid and the role grids after it
+    uint64_t* block = _allocate((1 + NUMBER_OF_ROLES) * words * sizeof(uint64_t));
 
-    // Initalize board
-    unsigned int count = 1;
-    for (int i = 0; i < board_size; i++) {
-        inner_board[i] = malloc(board_size * sizeof(struct board_cell));
+    board->occupied = create_occupancy_grid_in(board->board_size,block);
+
+    for (int role = 0; role < NUMBER_OF_ROLES; role++) {
+        board->role_grids[role] = create_occupancy_grid_in(board->board_size,block + (1 + role) * words);
+    }
+}
+
+void _create_segment_index(board* board) {
+    board->segments = _allocate(sizeof(segment_index));
+    *board->segments = create_segment_index(board->board_size,board->arena);
+}
 
-        if(inner_board[i] == NULL) {
-            perror("malloc has failed");
-            exit(1);
+void _index_segments(board* board,const entity_kind kind,const unsigned int from,const unsigned int to) {
+    for(unsigned int i = from;i < to;i++) {
+        const board_entity entity = { .kind = kind, .index = i };
+
+        if(kind == entity_ladder) segment_index_add(board->segments,entity,board->ladders[i].start,board->ladder_aims[i],board->ladders[i].end,board->arena);
+        else segment_index_add(board->segments,entity,board->snakes[i].tail,board->snake_aims[i],board->snakes[i].head,board->arena);
+    }
+}
+
+board_entity board_entity_at(const board board, const unsigned int x, const unsigned int y) {
+    if(board.segments != NULL) return segment_index_entity_at(board.segments,x,y);
+
+    // A loaded board does not know the cells in between, only the ends
+    for(unsigned int i = 0;i < board.number_of_ladders;i++) {
+        const ladder ladder = board.ladders[i];
+
+        if((ladder.start.x == x && ladder.start.y == y) || (ladder.end.x == x && ladder.end.y == y)) {
+            const board_entity entity = { .kind = entity_ladder, .index = i };
+            return entity;
         }
+    }
 
-        for(int j = 0;j < board_size;j++) {
-            const board_cell cell = { 
-                .label = count,
-                .role = none
-            };
+    for(unsigned int i = 0;i < board.number_of_snakes;i++) {
+        const snake snake = board.snakes[i];
 
-            inner_board[i][j] = cell;
-            count += 1;
+        if((snake.head.x == x && snake.head.y == y) || (snake.tail.x == x && snake.tail.y == y)) {
+            const board_entity entity = { .kind = entity_snake, .index = i };
+            return entity;
         }
     }
-    
-    return (board_cell_array_pointer) inner_board;
+
+    const board_entity nothing = { .kind = entity_none };
+
+    return nothing;
 }
 
-void _generate_snake_and_ladders(config config,board board) {
+void set_cell_role(const board board, const unsigned int x, const unsigned int y, const role role) {
+    if(board_is_sparse(board)) return;
+
+    board_cell* cell = board_cell_at(board,x,y);
+
+    if(cell->role != none) occupancy_clear(board.role_grids[cell->role],x,y);
+
+    if(role != none) {
+        occupancy_set(board.role_grids[role],x,y);
+        occupancy_set(board.occupied,x,y);
+    } else occupancy_clear(board.occupied,x,y);
+
+    cell->role = role;
+}
+
+bool _is_sparse(const config config,const unsigned int board_size) {
+    return config.representation == representation_sparse
+        || (config.representation == representation_automatic && board_size >= SPARSE_BOARD_MINIMUM_SIZE);
+}
+
+void _requested_entities(const config config,const unsigned int board_size,unsigned int* ladders,unsigned int* snakes) {
     // Calculate the number of entities on the grid
-    const unsigned int adjusted_players_modifier = sqrt(config.number_of_players) * 10;
-    const unsigned int number_of_ladders = abs(floor(config.difficulty * (board.board_size / 7.5)) - adjusted_players_modifier);
+    const generation_parameters parameters = generation_parameters_of(config);
+    const unsigned int adjusted_players_modifier = sqrt(config.number_of_players) * parameters.players_modifier;
 
-    board.ladders = _genereate_ladders(board,number_of_ladders);
-    // TODO : Generate snakes but i dont know how
-    const unsigned int number_of_snakes = floor(config.difficulty * (board.board_size / 10)) + adjusted_players_modifier;
+    *ladders = abs((int)(floor(config.difficulty * (board_size / parameters.ladder_divisor)) - adjusted_players_modifier));
+    *snakes = floor(config.difficulty * floor(board_size / parameters.snake_divisor)) + adjusted_players_modifier;
 }
 
-unsigned int _random_between(const unsigned int min,const unsigned int max) {
-    return min + rand() / (RAND_MAX / (max - min + 1) + 1);
+void _generate_snake_and_ladders(rng* rng,config config,board* board) {
+    unsigned int number_of_ladders, number_of_snakes;
+    _requested_entities(config,board->board_size,&number_of_ladders,&number_of_snakes);
+
+    uint64_t started = _phase_started();
+    board->number_of_ladders = _genereate_ladders(rng,board,number_of_ladders);
+    _phase_finished(phase_generate_ladders,started);
+
+    board->requested_ladders = number_of_ladders;
+
+    started = _phase_started();
+    board->number_of_snakes = _generate_snakes(rng,board,number_of_snakes);
+    _phase_finished(phase_generate_snakes,started);
+
+    board->requested_snakes = number_of_snakes;
 }
 
-point point_for_length(const board board,const point start,const unsigned int length) {
-    const unsigned int direction = _random_between(0,7);
+static int _compare_jumps(const void* a, const void* b) {
+    const uint64_t left = *(const uint64_t*) a;
+    const uint64_t right = *(const uint64_t*) b;
+
+    return (left > right) - (left < right);
+}
+
+jump_table _compile_jump_table(const board board) {
+    const unsigned int number_of_cells = board.board_size * board.board_size;
+
+    if(board_is_sparse(board)) {
+        const unsigned int number_of_jumps = board.number_of_ladders + board.number_of_snakes;
 
-    unsigned int x = start.x;
-    unsigned int y = start.y;
+        // The kept arrays come first, so that giving the scratch back to an arena leaves them alone
+        const jump_table jumps = {
+            .number_of_cells = number_of_cells,
+            .destination = NULL,
+            .number_of_jumps = number_of_jumps,
+            .from = _allocate(number_of_jumps * sizeof(unsigned int)),
+            .to = _allocate(number_of_jumps * sizeof(unsigned int)),
+        };
+
+        // Sorted as (from, to) pairs packed into one word, then split
+        const arena_mark scratch = _scratch_begin();
+        uint64_t* pairs = _allocate(number_of_jumps * sizeof(uint64_t));
 
-    const unsigned int half_length = length / 2;
+        for(unsigned int i = 0;i < board.number_of_ladders;i++) {
+            const ladder ladder = board.ladders[i];
+            pairs[i] = (uint64_t) label_for_point(board,ladder.start) << 32 | label_for_point(board,ladder.end);
+        }
+
+        for(unsigned int i = 0;i < board.number_of_snakes;i++) {
+            const snake snake = board.snakes[i];
+            pairs[board.number_of_ladders + i] = (uint64_t) label_for_point(board,snake.head) << 32 | label_for_point(board,snake.tail);
+        }
+
+        qsort(pairs,number_of_jumps,sizeof(uint64_t),&_compare_jumps);
+
+        for(unsigned int i = 0;i < number_of_jumps;i++) {
+            jumps.from[i] = (unsigned int)(pairs[i] >> 32);
+            jumps.to[i] = (unsigned int) pairs[i];
+        }
+
+        _release(pairs);
+        _scratch_end(scratch);
+
+        return jumps;
+    }
+
+    unsigned int* destination = _allocate((number_of_cells + 1) * sizeof(unsigned int));
+
+    for(unsigned int label = 0;label <= number_of_cells;label++) {
+        destination[label] = label;
+    }
+
+    for(unsigned int i = 0;i < board.number_of_ladders;i++) {
+        const ladder ladder = board.ladders[i];
+
+        destination[label_for_point(board,ladder.start)] = label_for_point(board,ladder.end);
+    }
+
+    for(unsigned int i = 0;i < board.number_of_snakes;i++) {
+        const snake snake = board.snakes[i];
+
+        destination[label_for_point(board,snake.head)] = label_for_point(board,snake.tail);
+    }
+
+    const jump_table jumps = {
+        .number_of_cells = number_of_cells,
+        .destination = destination,
+    };
+
+    return jumps;
+}
+
+unsigned int _random_between(rng* rng,const unsigned int min,const unsigned int max) {
+    return min + rng_below(rng,max - min + 1);
+}
+
+point point_for_length(rng* rng,const board board,const point start,const unsigned int length) {
+    return _point_in_direction(board,start,length,_random_between(rng,0,6));
+}
+
+point _point_in_direction(const board board,const point start,const unsigned int length,const unsigned int direction) {
+    int x = start.x;
+    int y = start.y;
+
+    const int half_length = length / 2;
 
     switch (direction){
         case 6:
@@ -141,11 +622,12 @@ point point_for_length(const board board,const point start,const unsigned int le
             break;
     }
 
-    const unsigned int board_size_minus_1 = board.board_size - 1;
+    const int board_size_minus_1 = board.board_size - 1;
     
     // keep in board range 
     if(y > board_size_minus_1) y = board_size_minus_1;
     if(x > board_size_minus_1) x = board_size_minus_1;
+    if(x < 0) x = 0;
 
     const point point = {
         .x = x,
@@ -155,127 +637,388 @@ point point_for_length(const board board,const point start,const unsigned int le
     return point;
 }
 
-bool all_neighbors_have_labels(const board board, const int start_x, const int start_y) {
-    board.inner_board[start_x];
-    board.inner_board[start_x][start_y];
-    board.inner_board[start_x][start_y]->role;
-    board.inner_board[start_x][start_y]->role != none;
+cell_index _create_sampled_cell_index(const board board) {
+    const cell_index sampled = {
+        .cells = NULL,
+        .slot = NULL,
+        .count = board.board_size >= 2 ? (board.board_size - 1) * (board.board_size - 1) : 0,
+        .misses = 0,
+    };
 
-    board.inner_board[start_x + 1];
-    board.inner_board[start_x + 1][start_y];
-    board.inner_board[start_x + 1][start_y]->role;
-    board.inner_board[start_x + 1][start_y]->role != none;
+    return sampled;
+}
+
+cell_index _create_cell_index(const board board) {
+    const unsigned int number_of_cells = board.board_size * board.board_size;
 
-    board.inner_board[start_x - 1];
-    board.inner_board[start_x - 1][start_y];
-    board.inner_board[start_x - 1][start_y]->role;
-    board.inner_board[start_x - 1][start_y]->role != none;
+    // A sparse board samples its starts instead of listing them
+    if(board_is_sparse(board)) return _create_sampled_cell_index(board);
 
+    cell_index index = {
+        .cells = _allocate(number_of_cells * sizeof(unsigned int)),
+        .slot = _allocate(number_of_cells * sizeof(unsigned int)),
+        .count = 0,
+    };
+
+    for(unsigned int cell = 0;cell < number_of_cells;cell++) {
+        index.slot[cell] = UINT_MAX;
+    }
 
-    board.inner_board[start_x];
-    board.inner_board[start_x][start_y  + 1];
-    board.inner_board[start_x][start_y + 1]->role;
-    board.inner_board[start_x][start_y + 1]->role != none;
+    uint64_t* free_cells = _allocate(board.occupied.words_per_row * sizeof(uint64_t));
 
+    // board.board_size - 2 so that the ladder is not on the last column or row of the grid
+    for(unsigned int y = 0;y <= board.board_size - 2;y++) {
+        occupancy_free_neighbourhoods(board.occupied,y,free_cells);
 
-    board.inner_board[start_x];
-    board.inner_board[start_x][start_y - 1];
-    board.inner_board[start_x][start_y - 1]->role;
-    board.inner_board[start_x][start_y - 1]->role != none;
+        for(unsigned int w = 0;w < board.occupied.words_per_row;w++) {
+            uint64_t bits = free_cells[w];
 
-    return board.inner_board[start_x][start_y]->role != none && board.inner_board[start_x + 1][start_y]->role != none; //&&
-          //  board.inner_board[start_x - 1][start_y]->role != none && board.inner_board[start_x][start_y - 1]->role != none &&
-         //   board.inner_board[start_x][start_y + 1]->role != none;
+            // Visit the set bits only, lowest first
+            while(bits != 0) {
+                const unsigned int x = w * 64 + __builtin_ctzll(bits) - 1;
+                bits &= bits - 1;
+
+                if(x > board.board_size - 2) continue;
+
+                const unsigned int cell = board_index_of(board,x,y);
+
+                index.slot[cell] = index.count;
+                index.cells[index.count++] = cell;
+            }
+        }
+    }
+
+    _release(free_cells);
+
+    return index;
 }
 
-point _draw_line_on_board(board board,const point start,const point suggested_end){
-    unsigned int x0 = start.x;
-    unsigned int y0 = start.y;
-    const unsigned int x1 = suggested_end.x;
-    const unsigned int y1 = suggested_end.y;
+bool _cell_index_sample(rng* rng,cell_index* index,const board board,const unsigned int first_row,unsigned int* cell) {
+    if(index->count == 0) return false;
 
-    const unsigned int dx = abs(x1 - x0);
-    const int sx = (x0 < x1) ? 1 : -1;
-    const int dy = -abs(y1-y0);
-    const int sy = (y0 < y1) ? 1 : -1;
+    if(index->cells != NULL) {
+        *cell = index->cells[_random_between(rng,0,index->count - 1)];
+        return true;
+    }
 
-    int error = dx + dy;
+    // board.board_size - 2 so that the ladder is not on the last column or row of the grid, like the dense index
+    const unsigned int last = board.board_size - 2;
 
-    while(true) {
-        // Do not place on ladder or the snake head
-        // So either stop placing by breaking
-        // Or set the role of this cell as ladder
-        if(board.inner_board[x0][y1]->role == is_ladder 
-            || board.inner_board[x0][y1]->role == is_ladder_start 
-            || board.inner_board[x0][y1]->role == is_snake_head
-            ) break;
-        else board.inner_board[x0][y0]->role = is_ladder_start; // Create ladder here
+    while(first_row <= last && index->misses < SPARSE_SAMPLE_ATTEMPTS) {
+        index->misses += 1;
+
+        const unsigned int x = _random_between(rng,0,last);
+        const unsigned int y = _random_between(rng,first_row,last);
 
-        if(x0 == x1 && y0 == y1) break;
+        if(all_neighbors_have_labels(board,x,y)) {
+            *cell = board_index_of(board,x,y);
+            return true;
+        }
+
+        _stats.start_retries += 1;
+        TRACE_COUNT(counter_start_retries);
+    }
+
+    // Nothing was placed for too long, the board counts as full
+    index->count = 0;
+
+    return false;
+}
+
+void _cell_index_remove(cell_index* index,const unsigned int cell) {
+    if(index->cells == NULL) return;
+
+    const unsigned int slot = index->slot[cell];
+
+    if(slot == UINT_MAX) return;
+
+    // Move the last member into the hole, so that the members stay packed
+    const unsigned int last = index->cells[--index->count];
+
+    index->cells[slot] = last;
+    index->slot[last] = slot;
+    index->slot[cell] = UINT_MAX;
+}
+
+void _mark_cell_taken(cell_index* index,const board board,const unsigned int x,const unsigned int y) {
+    // A sampled index checks every sample, so it only has to know that sampling still pays off
+    if(index->cells == NULL) {
+        index->misses = 0;
+        return;
+    }
+
+    // A start needs the cell and its four neighbours to be free, so taking a cell closes all five
+    const unsigned int cell = board_index_of(board,x,y);
+
+    _cell_index_remove(index,cell);
+
+    if(x + 1 < board.board_size) _cell_index_remove(index,cell + 1);
+    if(x > 0) _cell_index_remove(index,cell - 1);
+    if(y + 1 < board.board_size) _cell_index_remove(index,cell + board.board_size);
+    if(y > 0) _cell_index_remove(index,cell - board.board_size);
+}
+
+void _free_cell_index(cell_index index) {
+    _release(index.cells);
+    _release(index.slot);
+}
+
+bool all_neighbors_have_labels(const board board, const int start_x, const int start_y) {
+    // A cell "has a label" when it is only its position number, i.e. no ladder or snake goes through it
+    if(!board_is_sparse(board)) return occupancy_neighbourhood_is_clear(board.occupied,start_x,start_y);
+
+    // Cells off the board count as free, like the padding of the grids
+    return segment_index_neighbourhood_is_clear(board.segments,start_x,start_y);
+}
 
-        const int e2 = 2 * error;
+unsigned int _unblocked_cells_on_line(const board board, const point start, const point end, unsigned int* length) {
+    if(board_is_sparse(board)) return segment_index_unblocked_cells(board.segments,start,end,length);
 
-        if(e2 >= dy) {
-            if(x0 == x1) break;
+    bresenham_line line = line_between(start,end);
+
+    unsigned int cells_before_run = 0;
+
+    // A line visits each row in one horizontal run of cells, which is checked as a whole
+    while(true) {
+        const int run_y = line.y;
+        const int run_first_x = line.x;
+        int run_last_x = line.x;
+        unsigned int run_length = 1;
 
-            error += dy;
-            x0 += sx;
+        bool more = line_step(&line);
+
+        while(more && line.y == run_y) {
+            run_last_x = line.x;
+            run_length += 1;
+            more = line_step(&line);
         }
 
-        if(e2 <= dx) {
-            if(y0 == y1) break;
+        const unsigned int low = run_first_x < run_last_x ? run_first_x : run_last_x;
+        const unsigned int high = run_first_x < run_last_x ? run_last_x : run_first_x;
+
+        // Walk the run in chunks of up to 64 columns, in the direction the line travels
+        for(unsigned int done = 0;done < run_length;) {
+            const unsigned int count = run_length - done < 64 ? run_length - done : 64;
+            const unsigned int chunk_low = run_first_x <= run_last_x ? low + done : high - done - count + 1;
+
+            // Do not place a ladder or snake on anything
+            const uint64_t blocked = occupancy_run(board.occupied,chunk_low,run_y,count);
+
+            if(blocked != 0) {
+                // The first blocked cell in the direction of travel
+                const unsigned int offset = run_first_x <= run_last_x
+                    ? (unsigned int) __builtin_ctzll(blocked)
+                    : count - 1 - (63 - (unsigned int) __builtin_clzll(blocked));
+
+                // Finish counting the length of the line
+                unsigned int total = cells_before_run + run_length;
+                while(more) {
+                    total += 1;
+                    more = line_step(&line);
+                }
+                *length = total;
 
-            error += dx;
-            y0 += sy;
+                return cells_before_run + done + offset;
+            }
+
+            done += count;
         }
+
+        cells_before_run += run_length;
+
+        if(!more) break;
+    }
+
+    *length = cells_before_run;
+
+    return cells_before_run;
+}
+
+point _draw_line_on_board(board board,const point start,const point suggested_end,const role body,cell_index* eligible_starts){
+    unsigned int length;
+    unsigned int cells_to_draw = _unblocked_cells_on_line(board,start,suggested_end,&length);
+
+    if(body == is_snake) {
+        // A snake head on the final cell would make the game impossible to win
+        const bool ends_on_final_cell = suggested_end.x == board.board_size - 1 && suggested_end.y == board.board_size - 1;
+        if(cells_to_draw == length && ends_on_final_cell) cells_to_draw -= 1;
+    }
+
+    // A line cut short on the row it starts on can end behind its start, a ladder has to lead up the board
+    // and a snake needs a head above its tail
+    bresenham_line probe = line_between(start,suggested_end);
+    for(unsigned int stepped = 1;stepped < cells_to_draw;stepped++) line_step(&probe);
+
+    const point last = {
+        .x = probe.x,
+        .y = probe.y,
+    };
+
+    if(cells_to_draw < 2 || label_for_point(board,last) <= label_for_point(board,start)) {
+        const point invalid = {
+            .x = INVALID_COORDINATE,
+            .y = INVALID_COORDINATE,
+        };
+
+        return invalid;
     }
 
+    if(cells_to_draw < length) {
+        _stats.shortened_lines += 1;
+        TRACE_COUNT(counter_shortened_lines);
+    }
+
+    const role first_role = body == is_snake ? is_snake : is_ladder_start;
+
+    // The last cell that was actually drawn, which becomes the top of the ladder or the head of the snake
+    int last_x = start.x;
+    int last_y = start.y;
+
+    bresenham_line line = line_between(start,suggested_end);
+
+    for(unsigned int drawn = 0;drawn < cells_to_draw;drawn++) {
+        // Create ladder or snake here
+        set_cell_role(board,line.x,line.y,drawn == 0 ? first_role : body);
+        if(eligible_starts != NULL) _mark_cell_taken(eligible_starts,board,line.x,line.y);
+
+        last_x = line.x;
+        last_y = line.y;
+
+        line_step(&line);
+    }
+
+    if(body == is_snake) set_cell_role(board,last_x,last_y,is_snake_head);
+
     const point end = {
-        .x = x0,
-        .y = y0
+        .x = last_x,
+        .y = last_y
     };
 
     return end;
 }
 
-point _suggested_end_point_for(const board board,const point start,const unsigned int calculated_length) {
-    while(true) {
-        const point suggested_end = point_for_length(board,start,calculated_length);
+void _set_line_roles(const board board,const point start,const point aim,const point end,const role first,const role body,const role last) {
+    bresenham_line line = line_between(start,aim);
+
+    set_cell_role(board,line.x,line.y,first);
+
+    // The line was cut short at `end` when it was drawn, which lies on the board, so its coordinates fit an `int`
+    const int end_x = (int) end.x;
+    const int end_y = (int) end.y;
+
+    while((line.x != end_x || line.y != end_y) && line_step(&line)) {
+        set_cell_role(board,line.x,line.y,line.x == end_x && line.y == end_y ? last : body);
+    }
+}
+
+point _suggested_end_point_for(rng* rng,const board board,const point start,const unsigned int calculated_length) {
+    // Start with the calculated length and only shorten the ladder when no direction fits
+    for(unsigned int length = calculated_length;length >= 2;length--) {
+        unsigned int directions[7];
+        unsigned int number_of_directions = 0;
+
+        for(unsigned int direction = 0;direction < 7;direction++) {
+            const point candidate = _point_in_direction(board,start,length,direction);
+            TRACE_COUNT(counter_end_candidates);
 
-        // This ensures that the ladder doesn't end over , or in the way of an other ladder
-        if(!all_neighbors_have_labels(board,suggested_end.x,suggested_end.y)) {
-            return suggested_end;
+            // This ensures that the ladder doesn't end over , or in the way of an other ladder
+            if(all_neighbors_have_labels(board,candidate.x,candidate.y)) directions[number_of_directions++] = direction;
+            else {
+                _stats.end_retries += 1;
+                TRACE_COUNT(counter_end_rejections);
+            }
+        }
+
+        if(number_of_directions != 0) {
+            const unsigned int direction = directions[_random_between(rng,0,number_of_directions - 1)];
+            return _point_in_direction(board,start,length,direction);
         }
     }
+
+    const point invalid = {
+        .x = INVALID_COORDINATE,
+        .y = INVALID_COORDINATE,
+    };
+
+    return invalid;
 }
 
-ladders_array_pointer _genereate_ladders(const board board,const unsigned int count) {
-    ladder* ladders = malloc(count * sizeof(ladder));
-    
-    unsigned int minimum_start_y = 0;
-    unsigned int maximum_length = (int)(board.board_size * 0.5);
+unsigned int _genereate_ladders(rng* rng,board* board,const unsigned int count) {
+    board->ladders = _allocate(count * sizeof(ladder));
+    board->ladder_aims = _allocate(count * sizeof(point));
+
+    // Every cell a ladder can still start on, kept up to date as ladders are drawn,
+    // so a start is sampled directly instead of by trial and error
+    const arena_mark scratch = _scratch_begin();
+    cell_index eligible_starts = _create_cell_index(*board);
+
+    const unsigned int ladders_placed = _place_ladders(rng,board,&eligible_starts,0,count);
 
-    unsigned int ladders_placed = 0;
+    _free_cell_index(eligible_starts);
+
+    // The index of a sparse board is sampled and took no scratch, while the segments it grew as it went must stay
+    if(!board_is_sparse(*board)) {
+        _scratch_end(scratch);
+        _index_segments(board,entity_ladder,0,ladders_placed);
+    }
+
+    return ladders_placed;
+}
+
+unsigned int _place_ladders(rng* rng,board* board,cell_index* eligible_starts,const unsigned int placed,const unsigned int count) {
+    const unsigned int initial_maximum_length = (int)(board->board_size * 0.5);
+
+    unsigned int ladders_placed = placed;
 
     while(ladders_placed < count) {
-        // board.board_size - 2 so that the ladder is not on the last column of the grid
-        const unsigned int _start_x = _random_between(0,board.board_size - 2);
-        const unsigned int _start_y = _random_between(minimum_start_y,board.board_size - 2);
+        // The minimum start_y increases with every 3rd ladder, and hence the maximum length decreases
+        const unsigned int steps = (ladders_placed + 2) / 3;
+        const unsigned int minimum_start_y = steps;
 
-        // This ensures that the ladder doesn't start over , or in the way of an other ladder
-        if(!all_neighbors_have_labels(board,_start_x,_start_y)) {
-            continue;
-        }
+        unsigned int maximum_length = initial_maximum_length;
+        if(maximum_length > 2) maximum_length = maximum_length - 2 > steps ? maximum_length - steps : 2;
+
+        unsigned int cell;
+        if(!_cell_index_sample(rng,eligible_starts,*board,minimum_start_y,&cell)) break;
 
-        const unsigned int calculated_length = _random_between(2,maximum_length);
-        
         const point start = {
-            .x = _start_x,
-            .y = _start_y,
+            .x = cell % board->board_size,
+            .y = cell / board->board_size,
         };
 
-        const point suggested_end = _suggested_end_point_for(board,start,calculated_length);
-        const point end = _draw_line_on_board(board,start,suggested_end);
+        // Rows below minimum_start_y never open again, so the cell can be dropped for good
+        if(start.y < minimum_start_y) {
+            _cell_index_remove(eligible_starts,cell);
+            _stats.start_retries += 1;
+            TRACE_COUNT(counter_start_retries);
+            continue;
+        }
+
+        const unsigned int calculated_length = _random_between(rng,2,maximum_length < 2 ? 2 : maximum_length);
+
+        uint64_t started = _phase_started();
+        const point suggested_end = _suggested_end_point_for(rng,*board,start,calculated_length);
+        _phase_finished(phase_suggested_end_point,started);
+
+        // No end fits around this start, and as the board only fills up none ever will
+        if(!point_is_valid(suggested_end)) {
+            _cell_index_remove(eligible_starts,cell);
+            _stats.start_retries += 1;
+            TRACE_COUNT(counter_start_retries);
+            continue;
+        }
+
+        started = _phase_started();
+        const point end = _draw_line_on_board(*board,start,suggested_end,is_ladder,eligible_starts);
+        _phase_finished(phase_draw_line,started);
+
+        // The ladder was cut short before it climbed, nothing was drawn and the start stays free
+        if(!point_is_valid(end)) {
+            _cell_index_remove(eligible_starts,cell);
+            _stats.start_retries += 1;
+            TRACE_COUNT(counter_start_retries);
+            continue;
+        }
 
         const ladder new_ladder = {
             .start = start,
@@ -283,16 +1026,90 @@ ladders_array_pointer _genereate_ladders(const board board,const unsigned int co
         };
     
         // https://stackoverflow.com/a/77446759
-        memcpy(&ladders[ladders_placed],&new_ladder, sizeof(ladder));
+        memcpy(&board->ladders[ladders_placed],&new_ladder, sizeof(ladder));
+        memcpy(&board->ladder_aims[ladders_placed],&suggested_end, sizeof(point));
 
-        // Increase the minimum start_y on every 3rd iteration, and hence decrease the maximum length
-        if(ladders_placed %3 == 0) {
-            minimum_start_y += 1;
-            maximum_length -= 1;
+        // A sparse board has nothing else to block the next lines with, a dense one indexes its ladders once they are all placed
+        if(board_is_sparse(*board)) {
+            const board_entity entity = { .kind = entity_ladder, .index = ladders_placed };
+            segment_index_add(board->segments,entity,start,suggested_end,end,board->arena);
         }
 
         ladders_placed += 1;
     }
-    
-    return ladders;
-}
\ No newline at end of file
+
+    return ladders_placed;
+}
+
+unsigned int _generate_snakes(rng* rng,board* board,const unsigned int count) {
+    board->snakes = _allocate(count * sizeof(snake));
+    board->snake_aims = _allocate(count * sizeof(point));
+
+    // Built after the ladders, so it only holds cells that are clear of them
+    const arena_mark scratch = _scratch_begin();
+    cell_index eligible_tails = _create_cell_index(*board);
+
+    const unsigned int snakes_placed = _place_snakes(rng,board,&eligible_tails,0,count);
+
+    _free_cell_index(eligible_tails);
+
+    if(!board_is_sparse(*board)) {
+        _scratch_end(scratch);
+        _index_segments(board,entity_snake,0,snakes_placed);
+    }
+
+    return snakes_placed;
+}
+
+unsigned int _place_snakes(rng* rng,board* board,cell_index* eligible_tails,const unsigned int placed,const unsigned int count) {
+    const unsigned int maximum_length = (int)(board->board_size * 0.5);
+
+    unsigned int snakes_placed = placed;
+
+    unsigned int cell;
+
+    while(snakes_placed < count && _cell_index_sample(rng,eligible_tails,*board,0,&cell)) {
+
+        const point tail = {
+            .x = cell % board->board_size,
+            .y = cell / board->board_size,
+        };
+
+        const unsigned int calculated_length = _random_between(rng,2,maximum_length < 2 ? 2 : maximum_length);
+
+        uint64_t started = _phase_started();
+        const point suggested_head = _suggested_end_point_for(rng,*board,tail,calculated_length);
+        _phase_finished(phase_suggested_end_point,started);
+
+        started = _phase_started();
+        const point head = point_is_valid(suggested_head)
+            ? _draw_line_on_board(*board,tail,suggested_head,is_snake,eligible_tails)
+            : suggested_head;
+        _phase_finished(phase_draw_line,started);
+
+        // Nothing fits around this tail, and as the board only fills up nothing ever will
+        if(!point_is_valid(head)) {
+            _cell_index_remove(eligible_tails,cell);
+            _stats.start_retries += 1;
+            TRACE_COUNT(counter_start_retries);
+            continue;
+        }
+
+        const snake new_snake = {
+            .head = head,
+            .tail = tail
+        };
+
+        memcpy(&board->snakes[snakes_placed],&new_snake, sizeof(snake));
+        memcpy(&board->snake_aims[snakes_placed],&suggested_head, sizeof(point));
+
+        if(board_is_sparse(*board)) {
+            const board_entity entity = { .kind = entity_snake, .index = snakes_placed };
+            segment_index_add(board->segments,entity,tail,suggested_head,head,board->arena);
+        }
+
+        snakes_placed += 1;
+    }
+
+    return snakes_placed;
+}
@@ -15,19 +15,304 @@
 
 #include "types.h"
 #include "config.h"
+#include "rng.h"
+#include "timer.h"
+#include "occupancy.h"
+#include "arena.h"
+#include "segments.h"
+#include "trace.h"
 
 /**
  * @brief Function to generate a game board based on a provided configuration.
+ *
+ * The same configuration, including its `seed`, always generates the same board. When the board runs out of room, fewer ladders than `requested_ladders` (or snakes than `requested_snakes`) are placed instead of retrying forever; compare `number_of_ladders` (or `number_of_snakes`) with it to find out.
+ *
+ * `config.representation` decides whether the board is dense, with a cell, occupancy bits and a jump for every label, or sparse, with only the ladders and snakes as segments of its `segment_index` and only their jumps. Moves (`jump_destination`), cell roles (`board_role_at`) and rendering work the same on both.
+ *
  * @param config The configuration structure containing game setup details (number of players, difficulty, etc.).
  * @return A `board` structure representing the generated game board.
  */
 board generate_board_from_config(config config);
 
 /**
- * @brief Frees the memory allocated for the `board` structure and its elements.
+ * @brief Function to generate a game board whose memory is all carved from an arena.
+ *
+ * The board is the same one `generate_board_from_config` generates for the configuration. `free_board` does nothing for it; it is torn down by resetting the arena, or by rewinding it to an `arena_mark` taken before the board was generated. A batch of boards can share one arena, and an arena reset between generations is reused without calling the system allocator.
+ *
+ * @param config The configuration structure containing game setup details (number of players, difficulty, etc.).
+ * @param arena Pointer to the `arena` to carve the board from, or `NULL` to use the system allocator like `generate_board_from_config`.
+ * @return A `board` structure representing the generated game board.
+ */
+board generate_board_in_arena(config config, arena* arena);
+
+/**
+ * @brief Function to change the configuration of a board, keeping as much of it as still fits.
+ *
+ * The board is resized when `board_size_of(config)` differs, after which only the ladders and snakes that are missing for the new requested counts are placed, and only those that no longer fit are taken away: the ones that reach past the new edge, snakes whose head ends up on the final cell, and the most recently placed ones beyond the new counts. Players who stay keep their positions, players who join start on the first cell. In a lobby where players keep joining and leaving, the cost of a change follows the number of ladders and snakes it touches rather than the size of the board. Resizing a dense board still lays out its cells again, which is a single pass over memory.
+ *
+ * The result is a valid board for the configuration, with the same counts and rules, but it is not the board `generate_board_from_config` generates for it. The same sequence of changes on the same board always gives the same result. A loaded board (see `load_board`), or one whose representation changes with the size, is generated again from the start instead. An arena board takes the memory it needs from its arena, and what it gave up is only returned when the arena is reset.
+ *
+ * @param board Pointer to the `board` to change, which no game may be playing on at the time.
+ * @param config The new configuration.
+ */
+void regenerate_board(board* board, const config config);
+
+/**
+ * @brief Frees the memory allocated for the `board` structure and its elements, unless it was carved from an `arena`. A board loaded with `load_board` has its file unmapped.
  */
 void free_board(board board);
 
+/**
+ * @brief Function to get the `generation_parameters` a configuration is generated with.
+ *
+ * @param config The configuration structure.
+ * @return `*config.parameters`, or the default parameters if it is `NULL`.
+ */
+generation_parameters generation_parameters_of(const config config);
+
+/**
+ * @brief Function to compute the width of the board a configuration generates, without generating it.
+ *
+ * @param config The configuration structure.
+ * @return The number of cells per row and column.
+ */
+unsigned int board_size_of(const config config);
+
+/**
+ * @brief Function to read the generation counters of the current thread.
+ *
+ * @return The `generation_stats` accumulated since the last `reset_generation_stats`.
+ */
+generation_stats current_generation_stats();
+
+/**
+ * @brief Function to reset the generation counters of the current thread to zero.
+ */
+void reset_generation_stats();
+
+/**
+ * @brief Function to install a probe that receives the duration of every generation phase on the current thread.
+ *
+ * Phases are only timed while a probe is installed, so generation pays nothing for it otherwise.
+ *
+ * @param probe The `generation_probe` to install, or `NULL` to stop timing.
+ */
+void set_generation_probe(generation_probe probe);
+
+/**
+ * @brief Returns the index of the cell at column `x` and row `y` in the row-major `inner_board` buffer.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param x The x-coordinate (column) of the cell.
+ * @param y The y-coordinate (row) of the cell.
+ * @return The offset of the cell from the start of `inner_board`.
+ */
+static inline unsigned int board_index_of(const board board, const unsigned int x, const unsigned int y) {
+  return y * board.board_size + x;
+}
+
+/**
+ * @brief Returns a pointer to the cell at column `x` and row `y` of a dense board.
+ *
+ * The coordinates are not bounds checked; callers are expected to keep them within `0..board_size - 1`. A sparse board has no cells to point to, use `board_role_at` for either kind of board.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param x The x-coordinate (column) of the cell.
+ * @param y The y-coordinate (row) of the cell.
+ * @return A pointer to the requested `board_cell`.
+ */
+static inline board_cell* board_cell_at(const board board, const unsigned int x, const unsigned int y) {
+  return board.inner_board + board_index_of(board, x, y);
+}
+
+/**
+ * @brief Checks whether a board is sparse, i.e. has no cells and knows its ladders and snakes only from its `segment_index`.
+ *
+ * @param board The `board` structure representing the game board.
+ * @return True for a sparse board, False for a dense one.
+ */
+static inline bool board_is_sparse(const board board) {
+  return board.inner_board == NULL;
+}
+
+/**
+ * @brief Returns the role of the cell at column `x` and row `y`, for a dense or a sparse board.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param x The x-coordinate (column) of the cell.
+ * @param y The y-coordinate (row) of the cell.
+ * @return The role of the cell.
+ */
+static inline role board_role_at(const board board, const unsigned int x, const unsigned int y) {
+  if(board_is_sparse(board)) {
+    // The role follows from the ladder or snake that covers the cell
+    const board_entity entity = segment_index_entity_at(board.segments, x, y);
+
+    if(entity.kind == entity_ladder) {
+      const point start = board.ladders[entity.index].start;
+      return start.x == x && start.y == y ? is_ladder_start : is_ladder;
+    }
+
+    if(entity.kind == entity_snake) {
+      const point head = board.snakes[entity.index].head;
+      return head.x == x && head.y == y ? is_snake_head : is_snake;
+    }
+
+    return none;
+  }
+
+  return board_cell_at(board, x, y)->role;
+}
+
+/**
+ * @brief Function to find the ladder or snake that covers a cell, for a dense or a sparse board.
+ *
+ * A generated board answers from its `segment_index`, looking only at the few ladders and snakes near the cell. A loaded board does not know which cells lie between the ends of its ladders and snakes, so it only finds them at their ends, by looking at all of them.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param x The x-coordinate (column) of the cell.
+ * @param y The y-coordinate (row) of the cell.
+ * @return The ladder or snake, whose `kind` is `entity_none` if no ladder or snake covers the cell.
+ */
+board_entity board_entity_at(const board board, const unsigned int x, const unsigned int y);
+
+/**
+ * @brief Returns the label a player landing on a cell ends up on: the top of a ladder, the tail of a snake or the cell itself.
+ *
+ * @param jumps The `jump_table` of the board.
+ * @param label The label of the cell, starting from 1.
+ * @return The destination label.
+ */
+static inline unsigned int jump_destination(const jump_table jumps, const unsigned int label) {
+  if(jumps.destination != NULL) return jumps.destination[label];
+
+  // A sparse board only stores its jumps, sorted by the label they start from
+  unsigned int low = 0;
+  unsigned int high = jumps.number_of_jumps;
+
+  while(low < high) {
+    const unsigned int middle = low + (high - low) / 2;
+
+    if(jumps.from[middle] < label) low = middle + 1;
+    else high = middle;
+  }
+
+  return low < jumps.number_of_jumps && jumps.from[low] == label ? jumps.to[low] : label;
+}
+
+/**
+ * @brief Returns the label (position number) of the cell at a point.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param point The coordinates of the cell.
+ * @return The label of the cell, starting from 1.
+ */
+static inline unsigned int label_for_point(const board board, const point point) {
+  return board_index_of(board, point.x, point.y) + 1;
+}
+
+/**
+ * @brief Returns the coordinates of the cell with a label.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param label The label of the cell, starting from 1.
+ * @return The coordinates of the cell.
+ */
+static inline point point_for_label(const board board, const unsigned int label) {
+  const point point = {
+    .x = (label - 1) % board.board_size,
+    .y = (label - 1) / board.board_size,
+  };
+
+  return point;
+}
+
+/**
+ * @brief Checks whether a point lies on a board, i.e. is not the invalid point returned when no suitable point exists.
+ *
+ * @param point The point to check.
+ * @return True if the point is valid, False otherwise.
+ */
+static inline bool point_is_valid(const point point) {
+  return point.x != INVALID_COORDINATE && point.y != INVALID_COORDINATE;
+}
+
+/**
+ * @brief Starts a walk along the line between two points, positioned on `start`.
+ *
+ * @param start The first cell of the line.
+ * @param end The last cell of the line.
+ * @return The `bresenham_line` to walk with `line_step`.
+ */
+static inline bresenham_line line_between(const point start, const point end) {
+  const int dx = abs((int) end.x - (int) start.x);
+  const int dy = -abs((int) end.y - (int) start.y);
+
+  const bresenham_line line = {
+    .x = start.x,
+    .y = start.y,
+    .end_x = end.x,
+    .end_y = end.y,
+    .dx = dx,
+    .dy = dy,
+    .sx = start.x < end.x ? 1 : -1,
+    .sy = start.y < end.y ? 1 : -1,
+    .error = dx + dy,
+  };
+
+  return line;
+}
+
+/**
+ * @brief Moves a walk along a line on to its next cell.
+ *
+ * @param line Pointer to the `bresenham_line` being walked.
+ * @return True if the walk moved to a new cell, False if it was already on the last one.
+ */
+static inline bool line_step(bresenham_line* line) {
+  if(line->x == line->end_x && line->y == line->end_y) return false;
+
+  const int e2 = 2 * line->error;
+
+  if(e2 >= line->dy) {
+    if(line->x == line->end_x) return false;
+
+    line->error += line->dy;
+    line->x += line->sx;
+  }
+
+  if(e2 <= line->dx) {
+    if(line->y == line->end_y) return false;
+
+    line->error += line->dx;
+    line->y += line->sy;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Sets the role of a cell of a dense board, keeping its occupancy grids in step. A sparse board has no cells, the roles of its cells follow from its `segment_index`, so nothing is set.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param x The x-coordinate of the cell.
+ * @param y The y-coordinate of the cell.
+ * @param role The new role of the cell.
+ */
+void set_cell_role(const board board, const unsigned int x, const unsigned int y, const role role);
+
+/**
+ * @def SPARSE_SAMPLE_ATTEMPTS
+ * @brief The number of random cells a sparse board tries in a row without placing a ladder or snake before it counts as full.
+ */
+#define SPARSE_SAMPLE_ATTEMPTS 256
+
+/**
+ * @def REGENERATION_STREAMS
+ * @brief The first stream of the board seed that `regenerate_board` draws from, one stream per change. The dice of the games on a board use the streams below it.
+ */
+#define REGENERATION_STREAMS ((uint64_t) 1 << 32)
+
 // Function prototypes for internal helper functions:
 
 /**
@@ -41,64 +326,135 @@ void free_board(board board);
 players_array_pointer _create_players(const unsigned int number_of_players);
 
 /**
- * @brief Function to create a 2D array representing the game board with labeled cells.
+ * @brief Function to create the game board with labeled cells.
  * 
- * This internal function likely allocates memory for a 2D array and initializes each cell with appropriate labels or values.
+ * This internal function allocates a single row-major block of `board_size * board_size` cells and labels each cell with its position number.
  * 
  * @param board_size The size of the game board (number of squares on each side, assuming a square board).
- * @return A pointer to the newly created 2D board cell array.
+ * @return A pointer to the newly created board cell array.
  */
 board_cell_array_pointer _create_labeled_board(const unsigned int board_size);
 
+/**
+ * @brief Function to find out whether a configuration generates a sparse board.
+ *
+ * @param config The configuration structure.
+ * @param board_size The size of the board the configuration generates.
+ * @return True for a sparse board, False for a dense one.
+ */
+bool _is_sparse(const config config,const unsigned int board_size);
+
+/**
+ * @brief Function to compute the number of ladders and snakes a configuration asks for on a board of a size.
+ *
+ * @param config The configuration structure.
+ * @param board_size The size of the board.
+ * @param ladders Pointer that receives the number of ladders.
+ * @param snakes Pointer that receives the number of snakes.
+ */
+void _requested_entities(const config config,const unsigned int board_size,unsigned int* ladders,unsigned int* snakes);
+
 /**
  * @brief Function to generate snakes and ladders on the provided game board based on configuration.
  *
  * This internal function interacts with the `config` structure and the `board` structure to place snakes and ladders on the game board.
  * The specific placement logic depends on the game's rules and difficulty settings.
  *
+ * @param rng Pointer to the random number generator used for the placement.
  * @param config The configuration structure containing game setup details.
- * @param board The `board` structure representing the game board to be modified.
+ * Ladders are placed first and snakes after them, so a snake never blocks a ladder but always avoids one.
+ *
+ * @param board Pointer to the `board` structure representing the game board to be modified; its `ladders`, `snakes` and their counts are filled in.
+ */
+void _generate_snake_and_ladders(rng* rng, config config, board* board);
+
+/**
+ * @brief Function to compile the `jump_table` of a board once its ladders and snakes have been placed.
+ *
+ * Every label starts out pointing to itself, after which the start of each ladder is pointed at its end and the head of each snake at its tail. A sparse board only gets the jumps of its ladders and snakes, sorted by the label they start from.
+ *
+ * @param board The `board` structure representing the game board.
+ * @return The compiled `jump_table`. (Released by `free_board`)
  */
-void _generate_snake_and_ladders(config config, board board);
+jump_table _compile_jump_table(const board board);
 
 /**
- * @brief Generates a specified number of ladders on the board.
+ * @brief Generates up to a specified number of ladders on the board.
  *
  * This function takes a `board` structure and a desired `count` of ladders as input. 
- * It allocates memory for an array of `ladder` structs and populates it with randomly generated ladders.
+ * It allocates memory for an array of `ladder` structs, populates it with randomly generated ladders and stores it in `board->ladders`.
  *
  * The algorithm follows these steps:
- *   1. Allocate memory for the ladder array.
- *   2. Initialize variables:
+ *   1. Allocate memory for the ladder array (and `ladder_aims`), the rest is done by `_place_ladders`.
+ *   2. Build a `cell_index` of every cell a ladder can start on (not in the last row or column, and free according to `all_neighbors_have_labels`).
+ *   3. Initialize variables:
  *      - `minimum_start_y`: This controls the minimum starting y-coordinate for ladders, ensuring they don't concentrate at the bottom.
  *      - `maximum_length`: This represents the maximum length of a ladder, gradually decreasing as ladders are placed.
- *   3. Loop until the desired number of ladders (`count`) is generated.
- *      - Choose a random starting x-coordinate within valid board boundaries (excluding the last column).
- *      - Choose a random starting y-coordinate within the allowed range (`minimum_start_y` to `board.board_size`).
- *      - Check if the starting position's neighbors are empty using `all_neighbors_have_labels`. If not, skip and try a new starting position.
+ *   4. Loop until the desired number of ladders (`count`) is generated, or no eligible start is left.
+ *      - Sample a starting cell uniformly from the index. Cells below `minimum_start_y` are dropped from the index.
  *      - Choose a random length for the ladder between 2 and `maximum_length`.
- *      - Calculate the potential ending point using `point_for_length`.
- *      - Loop until a valid ending point is found:
- *          - Check if the neighbors of the potential ending point are empty using `all_neighbors_have_labels`. If empty, accept this point and break the loop.
- *      - If no valid ending point is found within the loop, choose a new ending position and repeat.
- *      - Create a `ladder` struct containing the start and end points.
+ *      - Find an ending point with `_suggested_end_point_for`. If none fits, drop the start from the index.
+ *      - Draw the ladder on the board using `_draw_line_on_board`. If it would be cut short before it climbs, nothing is drawn and the start is dropped from the index.
+ *        Otherwise every cell it covers (and their neighbours) is removed from the index.
  *      - Store the ladder in the ladders array.
- *      - Draw the ladder on the board using `_draw_line_on_board`.
  *      - Update `minimum_start_y` and `maximum_length` periodically to encourage ladder distribution across the board.
- *   4. Return the pointer to the allocated ladders array.
+ *   5. Return the number of ladders placed.
  *
- * @param board The `board` structure representing the game board.
+ * The board only ever fills up, so a start that is dropped can never become eligible again. Every iteration either places a ladder or shrinks the index, which bounds the work by the number of cells plus the number of ladders.
+ *
+ * @param rng Pointer to the random number generator used for the placement.
+ * @param board Pointer to the `board` structure representing the game board, whose `ladders` are set. (Released by `free_board`)
  * @param count The desired number of ladders to generate.
- * @return A pointer to an array of `ladder` structs representing the generated ladders. (Caller needs to free the memory later)
+ * @return The number of ladders that were placed, which is less than `count` if the board ran out of room.
+ */
+unsigned int _genereate_ladders(rng* rng, board* board, const unsigned int count);
+
+/**
+ * @brief Places ladders on a board until it has `count` of them, or no start is left in `eligible_starts`.
+ *
+ * The start rows and lengths follow from the number of ladders already on the board, as listed at `_genereate_ladders`, so placing them one call at a time or all at once gives the same board.
+ *
+ * @param rng Pointer to the random number generator used for the placement.
+ * @param board Pointer to the `board` structure, whose `ladders` and `ladder_aims` have room for `count` ladders.
+ * @param eligible_starts Pointer to the `cell_index` the starts are sampled from.
+ * @param placed The number of ladders already on the board.
+ * @param count The number of ladders the board should have.
+ * @return The number of ladders on the board.
+ */
+unsigned int _place_ladders(rng* rng, board* board, cell_index* eligible_starts, const unsigned int placed, const unsigned int count);
+
+/**
+ * @brief Generates up to a specified number of snakes on the board.
+ *
+ * This function shares its machinery with `_genereate_ladders`: a snake is drawn from its tail up to its head, so the tail is sampled from a `cell_index` of free cells, the head is found with `_suggested_end_point_for` and the body is drawn with `_draw_line_on_board`. Unlike a ladder, a snake stops short of any occupied cell, so it never touches a ladder or another snake, and it never puts its head on the final cell.
+ *
+ * As with ladders, every iteration either places a snake or drops a start from the index for good, so the work grows linearly with the number of snakes (plus the number of cells), without rejection loops.
+ *
+ * @param rng Pointer to the random number generator used for the placement.
+ * @param board Pointer to the `board` structure representing the game board, whose `snakes` are set. (Released by `free_board`)
+ * @param count The desired number of snakes to generate.
+ * @return The number of snakes that were placed, which is less than `count` if the board ran out of room.
  */
-ladders_array_pointer _genereate_ladders(const board board, const unsigned int count);
+unsigned int _generate_snakes(rng* rng, board* board, const unsigned int count);
+
+/**
+ * @brief Places snakes on a board until it has `count` of them, or no tail is left in `eligible_tails`.
+ *
+ * @param rng Pointer to the random number generator used for the placement.
+ * @param board Pointer to the `board` structure, whose `snakes` and `snake_aims` have room for `count` snakes.
+ * @param eligible_tails Pointer to the `cell_index` the tails are sampled from.
+ * @param placed The number of snakes already on the board.
+ * @param count The number of snakes the board should have.
+ * @return The number of snakes on the board.
+ */
+unsigned int _place_snakes(rng* rng, board* board, cell_index* eligible_tails, const unsigned int placed, const unsigned int count);
 
 /**
  * @brief Calculates the ending point on the board after a specified movement length from a starting point.
  *
  * This function takes a `board` structure, a starting `point`, and a movement `length` as input and returns the ending point on the board after the movement. It considers the board boundaries and wraps around if necessary.
  *
- * The movement direction is determined randomly using the `_random_between` function, which generates a number between 0 and 7 (inclusive). Here's the breakdown of possible directions based on the generated value:
+ * The movement direction is determined randomly using the `_random_between` function, which generates a number between 0 and 6 (inclusive), and passed on to `_point_in_direction`. Here's the breakdown of possible directions based on the generated value:
  *  - **0:** Left, low diagonal (more right than left, no vertical movement)
  *  - **1:** Left, mid diagonal (more left than up)
  *  - **2:** Left, high diagonal (more up than left)
@@ -109,35 +465,50 @@ ladders_array_pointer _genereate_ladders(const board board, const unsigned int c
  *
  * If the movement would cause the ending point to go beyond the board boundaries, the function adjusts the coordinates to stay within the valid range.
  *
+ * @param rng Pointer to the random number generator used to pick the direction.
+ * @param board The `board` structure representing the game board.
+ * @param start The starting point on the board (coordinates).
+ * @param length The movement length (number of squares to move).
+ * @return The ending point on the board after the movement.
+ */
+point point_for_length(rng* rng,const board board,const point start,const unsigned int length);
+
+/**
+ * @brief Calculates the ending point on the board after a movement of `length` in one of the seven directions listed at `point_for_length`.
+ *
+ * If the movement would cause the ending point to go beyond the board boundaries, the coordinates are clamped to the valid range.
+ *
  * @param board The `board` structure representing the game board.
  * @param start The starting point on the board (coordinates).
  * @param length The movement length (number of squares to move).
+ * @param direction The direction of the movement (0-6).
  * @return The ending point on the board after the movement.
  */
-point point_for_length(const board board,const point start,const unsigned int length);
+point _point_in_direction(const board board,const point start,const unsigned int length,const unsigned int direction);
 
 /**
  * @brief Function to generate a random number between a specified minimum and maximum value (inclusive).
  *
- * This internal function generates a random unsigned integer within the specified range (inclusive). It's likely used for various purposes within the game logic, such as determining ladder lengths or random placements.
+ * This internal function generates a random unsigned integer within the specified range (inclusive). It's used for various purposes within the game logic, such as determining ladder lengths, random placements or dice rolls.
  *
+ * @param rng Pointer to the random number generator to draw from.
  * @param min The minimum value (inclusive) for the random number.
  * @param max The maximum value (inclusive) for the random number.
  * @return A random unsigned integer between `min` and `max`.
  */
-unsigned int _random_between(const unsigned int min,const unsigned int max);
+unsigned int _random_between(rng* rng,const unsigned int min,const unsigned int max);
 
 /**
  * @brief Checks if all surrounding squares (neighbors) of a given position on the board have labels.
  *
- * This function takes a `board` structure, a starting `start_x` coordinate, and a starting `start_y` coordinate as input and returns a boolean value indicating whether all surrounding squares (up, down, left, and right) have labels assigned.
+ * This function takes a `board` structure, a starting `start_x` coordinate, and a starting `start_y` coordinate as input and returns a boolean value indicating whether the square and all surrounding squares (up, down, left, and right) only carry their label, i.e. no ladder or snake passes through them.
  * 
- * The function considers the board boundaries and ignores squares outside the valid range.
+ * The check is a handful of masks on the `occupied` grid of the board, whose padding makes squares outside the valid range count as free.
  *
  * @param board The `board` structure representing the game board.
  * @param start_x The x-coordinate of the starting position.
  * @param start_y The y-coordinate of the starting position.
- * @return True if all surrounding squares have labels, False otherwise.
+ * @return True if the square and all surrounding squares are free, False otherwise.
  */
 bool all_neighbors_have_labels(const board board, const int start_x, const int start_y);
 
@@ -146,28 +517,134 @@ bool all_neighbors_have_labels(const board board, const int start_x, const int s
  *
  * This internal function takes a `board` structure, a starting `point`, and a suggested ending `point` as input. It utilizes [Bresenham's line algorithm](https://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm#:~:text=Bresenham's%20line%20algorithm%20is%20a,straight%20line%20between%20two%20points.) to calculate the intermediate points along the line and updates the corresponding elements in the board's inner cell array (`inner_board`).
  *
- * The function avoids drawing over existing elements on the board (e.g., snake bodies, ladder endpoints) to maintain board integrity.
+ * The function avoids drawing over existing elements on the board, so that every cell belongs to one ladder or snake at most and either can be taken away again (see `_set_line_roles`). Before anything is written, the line is walked row by row and every row's stretch is checked against the role grids of the board a word at a time, which tells how many cells can be drawn.
  * 
  * @param board The `board` structure representing the game board.
  * @param start The starting point (coordinates) for the line.
  * @param suggested_end The suggested ending point (coordinates) for the line.
+ * @param body The role of the line, `is_ladder` or `is_snake`. A ladder starts with `is_ladder_start`, a snake ends with `is_snake_head`.
+ * @param eligible_starts Pointer to the `cell_index` of eligible ladder starts, from which every drawn cell is removed with `_mark_cell_taken`, or `NULL`.
  *
- * @return The end point used to draw the line
+ * @return The end point used to draw the line, or a point with `INVALID_COORDINATE` coordinates if the line would be cut short to less than 2 cells or to an end whose label is not above the label of its start, in which case nothing is drawn.
  */
-point _draw_line_on_board(board board,const point start,const point suggested_end);
+point _draw_line_on_board(board board,const point start,const point suggested_end,const role body,cell_index* eligible_starts);
+
+/**
+ * @brief Sets the role of every cell of a ladder or snake, which is drawn from `start` towards `aim` and cut short at `end` like `_draw_line_on_board` drew it.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param start The first cell, the start of a ladder or the tail of a snake.
+ * @param aim The point the line was drawn towards.
+ * @param end The last cell, the end of a ladder or the head of a snake.
+ * @param first The role of the first cell.
+ * @param body The role of the cells in between.
+ * @param last The role of the last cell, unless it is the first one too.
+ */
+void _set_line_roles(const board board,const point start,const point aim,const point end,const role first,const role body,const role last);
 
 /**
  * @brief Finds a suggested ending point for a ladder based on a starting point and desired length, considering board boundaries and empty spaces.
  *
- * This function takes a `board` structure, a starting `point`, and a calculated `length` for the ladder as input. It iterates through potential ending points based on the calculated length and checks if the corresponding cells on the board are empty using `all_neighbors_have_labels`.
+ * This function takes a `board` structure, a starting `point`, and a calculated `length` for the ladder as input. It computes the ending point in each of the seven directions (see `_point_in_direction`) and keeps those whose cells are empty according to `all_neighbors_have_labels`, then picks one of them at random.
  *
- * If all neighbors of a potential ending point are empty, the function returns that point as the suggested ending point. Otherwise, it continues searching until the end of the board is reached or a suitable ending point is found.
+ * If no direction fits, the length is shortened one square at a time down to 2. The work is therefore bounded by seven candidates per length, rather than by retrying random points.
  *
+ * @param rng Pointer to the random number generator used to pick among the fitting directions.
  * @param board The `board` structure representing the game board.
  * @param start The starting point (coordinates) for the ladder.
  * @param calculated_length The calculated length (number of squares) for the ladder.
- * @return A `point` representing the suggested ending point for the ladder, or an invalid point (e.g., with negative coordinates) if no suitable point is found. 
+ * @return A `point` representing the suggested ending point for the ladder, or a point with `INVALID_COORDINATE` coordinates (see `point_is_valid`) if no suitable point is found. 
+ */
+point _suggested_end_point_for(rng* rng,const board board,const point start,const unsigned int calculated_length);
+
+/**
+ * @brief Function to count the cells of a line that can be drawn before the first blocked cell.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param start The first cell of the line.
+ * @param end The last cell of the line.
+ * @param length Pointer that receives the total number of cells of the line.
+ * @return The number of cells, counted from `start`, that are not blocked.
+ */
+unsigned int _unblocked_cells_on_line(const board board, const point start, const point end, unsigned int* length);
+
+/**
+ * @brief Function to create the occupancy grids of a board.
+ *
+ * @param board Pointer to the `board` structure, whose `occupied` and `role_grids` are set. (Released by `free_board`)
+ */
+void _create_occupancy_grids(board* board);
+
+/**
+ * @brief Function to create the empty `segment_index` of a board, which every ladder and snake is added to. A sparse board adds them as they are placed, since the index is what blocks the next ones, a dense board once they are all placed (see `_index_segments`).
+ *
+ * @param board Pointer to the `board` structure, whose `segments` is set. (Released by `free_board`)
+ */
+void _create_segment_index(board* board);
+
+/**
+ * @brief Function to add ladders or snakes of a board to its `segment_index`, under their numbers in `ladders` or `snakes`.
+ *
+ * @param board Pointer to the `board` structure.
+ * @param kind Whether the ladders or the snakes are added.
+ * @param from The number of the first one to add.
+ * @param to The number after the last one to add.
+ */
+void _index_segments(board* board,const entity_kind kind,const unsigned int from,const unsigned int to);
+
+/**
+ * @brief Function to create a `cell_index` that samples the cells a ladder or snake can start on (see `_cell_index_sample`) instead of listing them, so it costs no memory or time per cell.
+ *
+ * @param board The `board` structure representing the game board.
+ * @return The index. (Caller needs to release it with `_free_cell_index`)
+ */
+cell_index _create_sampled_cell_index(const board board);
+
+/**
+ * @brief Function to create a `cell_index` of every cell a ladder or snake can start on.
+ *
+ * The index of a sparse board is a sampled one (see `_create_sampled_cell_index`).
+ *
+ * @param board The `board` structure representing the game board.
+ * @return The index. (Caller needs to release it with `_free_cell_index`)
+ */
+cell_index _create_cell_index(const board board);
+
+/**
+ * @brief Function to pick a random member of a `cell_index`.
+ *
+ * For an index that lists its members this is a uniform pick among them. A sampled index (see `_create_sampled_cell_index`) tries random cells from row `first_row` on, not in the last row or column, until one is free according to `all_neighbors_have_labels`; after `SPARSE_SAMPLE_ATTEMPTS` tries without a cell being taken (see `_mark_cell_taken`) the index counts as empty.
+ *
+ * @param rng Pointer to the random number generator.
+ * @param index Pointer to the index.
+ * @param board The `board` structure representing the game board.
+ * @param first_row The lowest row a sampled index samples from. A listing index leaves dropping lower cells to the caller.
+ * @param cell Pointer that receives the row-major index of the cell.
+ * @return `false` if the index is empty.
+ */
+bool _cell_index_sample(rng* rng,cell_index* index,const board board,const unsigned int first_row,unsigned int* cell);
+
+/**
+ * @brief Removes a cell from a `cell_index`, if it is a member.
+ *
+ * @param index Pointer to the index.
+ * @param cell The row-major index of the cell.
+ */
+void _cell_index_remove(cell_index* index,const unsigned int cell);
+
+/**
+ * @brief Removes a cell that has been taken by a ladder or snake, and its four neighbours, from the index of eligible starts.
+ *
+ * @param index Pointer to the index of eligible starts.
+ * @param board The `board` structure representing the game board.
+ * @param x The x-coordinate of the taken cell.
+ * @param y The y-coordinate of the taken cell.
+ */
+void _mark_cell_taken(cell_index* index,const board board,const unsigned int x,const unsigned int y);
+
+/**
+ * @brief Frees the memory allocated for a `cell_index`.
  */
-point _suggested_end_point_for(const board board,const point start,const unsigned int calculated_length);
+void _free_cell_index(cell_index index);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include "campaign.h"
+
+static const char _magic[8] = { 'C', 'S', 'L', 'S', 'H', 'A', 'R', 'D' };
+
+#define _BYTE_ORDER_MARK 0x01020304u
+
+validate_message check_campaign(const campaign campaign) {
+    validate_message message = ensure_players_within_1_10(campaign.number_of_players);
+    if(message == NULL) message = ensure_difficulty_within_1_10(campaign.difficulty);
+    if(message != NULL) return message;
+
+    if(campaign.number_of_seeds == 0 || campaign.games_per_seed == 0) return "A campaign needs at least one seed and one game per seed!\n";
+
+    // The units are counted in 64 bits
+    if(campaign.number_of_seeds > UINT64_MAX / campaign.games_per_seed) return "The campaign has too many games!\n";
+
+    return NULL;
+}
+
+uint64_t campaign_units(const campaign campaign) {
+    return campaign.number_of_seeds * campaign.games_per_seed;
+}
+
+void run_campaign_shard(const campaign campaign, const unsigned int shard, const unsigned int shards, arena* boards, shard_result* result) {
+    const uint64_t units = campaign_units(campaign);
+    const uint64_t first_unit = _shard_first_unit(units,shard,shards);
+    const uint64_t last_unit = _shard_first_unit(units,shard + 1,shards);
+
+    _start_shard_result(result,campaign,first_unit,last_unit);
+
+    result->shard = shard;
+    result->shards = shards;
+
+    const simulation_options options = { .maximum_rounds = campaign.maximum_rounds };
+
+    game_result results[SIMULATION_BATCH_SIZE];
+
+    uint64_t unit = first_unit;
+
+    // A shard starts and ends anywhere on a board, so only the games of the shard are played on it
+    while(unit < last_unit) {
+        const uint64_t seed_index = unit / campaign.games_per_seed;
+        const unsigned int first_game = (unsigned int)(unit % campaign.games_per_seed);
+
+        const uint64_t remaining = last_unit - unit;
+        const unsigned int games = campaign.games_per_seed - first_game < remaining ? campaign.games_per_seed - first_game : (unsigned int) remaining;
+
+        const config config = {
+            .number_of_players = campaign.number_of_players,
+            .difficulty = campaign.difficulty,
+            .seed = campaign.first_seed + seed_index,
+        };
+
+        const board board = generate_board_in_arena(config,boards);
+
+        for(unsigned int first = 0;first < games;first += SIMULATION_BATCH_SIZE) {
+            const unsigned int count = games - first < SIMULATION_BATCH_SIZE ? games - first : SIMULATION_BATCH_SIZE;
+
+            simulate_games(board,first_game + first,count,options,results);
+
+            for(unsigned int i = 0;i < count;i++) _add_to_shard_result(result,results[i]);
+        }
+
+        arena_reset(boards);
+
+        unit += games;
+    }
+}
+
+validate_message merge_shard_results(shard_result* results, const unsigned int number_of_results, shard_result* merged) {
+    if(number_of_results == 0) return "There are no shard results to merge!\n";
+
+    qsort(results,number_of_results,sizeof(shard_result),_compare_shard_results);
+
+    const campaign campaign = results[0].campaign;
+
+    _start_shard_result(merged,campaign,0,campaign_units(campaign));
+
+    uint64_t next_unit = 0;
+
+    for(unsigned int i = 0;i < number_of_results;i++) {
+        const shard_result* result = results + i;
+
+        if(memcmp(&result->campaign,&campaign,sizeof(campaign)) != 0) return "The shard results belong to different campaigns!\n";
+        if(result->first_unit < next_unit) return "The shard results overlap, some games would be counted twice!\n";
+        if(result->first_unit > next_unit) return "The shard results leave a gap, some shards are missing!\n";
+
+        next_unit = result->last_unit;
+
+        // An empty shard has no extremes to merge
+        if(result->games != 0) {
+            if(merged->games == 0 || result->minimum_rounds < merged->minimum_rounds) merged->minimum_rounds = result->minimum_rounds;
+            if(result->maximum_rounds > merged->maximum_rounds) merged->maximum_rounds = result->maximum_rounds;
+        }
+
+        merged->games += result->games;
+        merged->finished_games += result->finished_games;
+
+        for(unsigned int player = 0;player < MAXIMUM_NUMBER_OF_PLAYERS;player++) merged->wins[player] += result->wins[player];
+
+        merged->total_rounds += result->total_rounds;
+        merged->total_turns += result->total_turns;
+        merged->total_rolls += result->total_rolls;
+        merged->total_ladder_hits += result->total_ladder_hits;
+        merged->total_snake_hits += result->total_snake_hits;
+        merged->total_invalidated_moves += result->total_invalidated_moves;
+
+        for(unsigned int bucket = 0;bucket < CAMPAIGN_HISTOGRAM_BUCKETS;bucket++) merged->rounds_histogram[bucket] += result->rounds_histogram[bucket];
+    }
+
+    if(next_unit != merged->last_unit) return "The shard results leave a gap, some shards are missing!\n";
+
+    return NULL;
+}
+
+unsigned int shard_result_percentile(const shard_result* result, const double fraction) {
+    // The smallest rounds with at least `fraction` of the games at or below them
+    const double wanted = fraction * result->games;
+    uint64_t seen = 0;
+
+    for(unsigned int bucket = 0;bucket < CAMPAIGN_HISTOGRAM_BUCKETS;bucket++) {
+        seen += result->rounds_histogram[bucket];
+
+        if(seen != 0 && seen >= wanted) {
+            const uint32_t last = _bucket_last_rounds(bucket);
+            return last < result->maximum_rounds ? last : result->maximum_rounds;
+        }
+    }
+
+    return result->maximum_rounds;
+}
+
+validate_message save_shard_result(const shard_result* result, const char *const path) {
+    struct {
+        shard_file_header header;
+        shard_result result;
+    } file;
+
+    // Padding is zeroed, so equal results give equal files
+    memset(&file,0,sizeof(file));
+
+    memcpy(file.header.magic,_magic,sizeof(_magic));
+    file.header.version = SHARD_FILE_VERSION;
+    file.header.byte_order = _BYTE_ORDER_MARK;
+
+    file.result = *result;
+    file.header.checksum = board_file_checksum(&file.result,sizeof(shard_result));
+
+    return _write_file_atomically(path,&file,sizeof(file));
+}
+
+validate_message load_shard_result(const char *const path, shard_result* result) {
+    const board_mapping mapping = _map_file(path);
+    if(mapping.address == NULL) return "The shard file could not be mapped!\n";
+
+    const shard_file_header* header = mapping.address;
+    const unsigned char* base = mapping.address;
+
+    validate_message error = NULL;
+
+    if(mapping.length != sizeof(shard_file_header) + sizeof(shard_result)) error = "The file is not a shard file of this version!\n";
+    else if(memcmp(header->magic,_magic,sizeof(_magic)) != 0) error = "The file is not a shard file!\n";
+    else if(header->byte_order != _BYTE_ORDER_MARK) error = "The shard file was written on a machine with another byte order!\n";
+    else if(header->version != SHARD_FILE_VERSION) error = "The shard file was written by another version!\n";
+    else if(board_file_checksum(base + sizeof(shard_file_header),sizeof(shard_result)) != header->checksum) error = "The shard file is corrupt, its checksum does not match!\n";
+
+    if(error == NULL) memcpy(result,base + sizeof(shard_file_header),sizeof(shard_result));
+
+    unmap_board_file(mapping);
+
+    return error;
+}
+
+uint64_t _shard_first_unit(const uint64_t units, const unsigned int shard, const unsigned int shards) {
+    // The first `units % shards` shards get one unit more, without multiplying anything that could overflow
+    const uint64_t size = units / shards;
+    const uint64_t larger = units % shards;
+
+    return size * shard + (shard < larger ? shard : larger);
+}
+
+void _start_shard_result(shard_result* result, const campaign campaign, const uint64_t first_unit, const uint64_t last_unit) {
+    memset(result,0,sizeof(shard_result));
+
+    result->campaign = campaign;
+    result->first_unit = first_unit;
+    result->last_unit = last_unit;
+    result->shard = 0;
+    result->shards = 1;
+}
+
+void _add_to_shard_result(shard_result* result, const game_result game) {
+    if(result->games == 0 || game.rounds < result->minimum_rounds) result->minimum_rounds = game.rounds;
+    if(game.rounds > result->maximum_rounds) result->maximum_rounds = game.rounds;
+
+    result->games += 1;
+
+    if(game.finished) {
+        result->finished_games += 1;
+        result->wins[game.winner] += 1;
+    }
+
+    result->total_rounds += game.rounds;
+    result->total_turns += game.turns;
+    result->total_rolls += game.rolls;
+    result->total_ladder_hits += game.ladder_hits;
+    result->total_snake_hits += game.snake_hits;
+    result->total_invalidated_moves += game.invalidated_moves;
+
+    result->rounds_histogram[_rounds_bucket(game.rounds)] += 1;
+}
+
+unsigned int _rounds_bucket(const uint32_t rounds) {
+    if(rounds < CAMPAIGN_HISTOGRAM_EXACT_ROUNDS) return rounds;
+
+    const unsigned int highest_bit = 31 - (unsigned int) __builtin_clz(rounds);
+    const unsigned int within = (rounds >> (highest_bit - 5)) & (CAMPAIGN_HISTOGRAM_BUCKETS_PER_DOUBLING - 1);
+
+    return CAMPAIGN_HISTOGRAM_EXACT_ROUNDS + (highest_bit - 8) * CAMPAIGN_HISTOGRAM_BUCKETS_PER_DOUBLING + within;
+}
+
+uint32_t _bucket_last_rounds(const unsigned int bucket) {
+    if(bucket < CAMPAIGN_HISTOGRAM_EXACT_ROUNDS) return bucket;
+
+    const unsigned int highest_bit = 8 + (bucket - CAMPAIGN_HISTOGRAM_EXACT_ROUNDS) / CAMPAIGN_HISTOGRAM_BUCKETS_PER_DOUBLING;
+    const uint64_t within = (bucket - CAMPAIGN_HISTOGRAM_EXACT_ROUNDS) % CAMPAIGN_HISTOGRAM_BUCKETS_PER_DOUBLING;
+
+    // The next bucket starts one past the last rounds of this one
+    return (uint32_t)(((CAMPAIGN_HISTOGRAM_BUCKETS_PER_DOUBLING + within + 1) << (highest_bit - 5)) - 1);
+}
+
+int _compare_shard_results(const void* left, const void* right) {
+    const uint64_t left_unit = ((const shard_result*) left)->first_unit;
+    const uint64_t right_unit = ((const shard_result*) right)->first_unit;
+
+    return (left_unit > right_unit) - (left_unit < right_unit);
+}
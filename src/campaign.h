@@ -0,0 +1,129 @@
+/**
+ * @file CSnakeLadderCampaign.h
+ * @brief Header file containing simulation campaigns of Snake and Ladder that are split over many processes.
+ *
+ * A `campaign` plays `games_per_seed` games on each of `number_of_seeds` boards. Its games are numbered as units and split into `shards` contiguous ranges that differ in size by at most one unit, so every worker process knows which games are its own from nothing but the campaign and its shard index, whatever machine it runs on. A worker writes its `shard_result` to a small shard file, and merging the shard files of all workers gives the same result as a single process playing the whole campaign.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_CAMPAIGN_H
+#define CSNAKE_LADDER_CAMPAIGN_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "config.h"
+#include "board.h"
+#include "arena.h"
+#include "simulation.h"
+#include "storage.h"
+
+/**
+ * @def SHARD_FILE_VERSION
+ * @brief The version of the shard file format written by `save_shard_result`. Files of other versions are refused.
+ */
+#define SHARD_FILE_VERSION 2
+
+/**
+ * @brief Function to check that a campaign can be played.
+ *
+ * @param campaign The `campaign` to check.
+ * @return A validation message, or `NULL` if the campaign is valid.
+ */
+validate_message check_campaign(const campaign campaign);
+
+/**
+ * @brief Function to compute the number of units (games) of a campaign.
+ */
+uint64_t campaign_units(const campaign campaign);
+
+/**
+ * @brief Function to play the games of one shard of a campaign.
+ *
+ * Every board of the shard is generated into `boards`, which is reset before the next one.
+ *
+ * @param campaign The `campaign` to play.
+ * @param shard The index of the shard, below `shards`.
+ * @param shards The number of shards the campaign is split into.
+ * @param boards Pointer to the `arena` the boards are generated into.
+ * @param result Pointer to the `shard_result` that is filled in.
+ */
+void run_campaign_shard(const campaign campaign, const unsigned int shard, const unsigned int shards, arena* boards, shard_result* result);
+
+/**
+ * @brief Function to merge the results of the shards of a campaign.
+ *
+ * The results may be given in any order and are sorted by their first unit. They have to belong to the same campaign and cover every unit exactly once, as they do when every shard of one split has been played.
+ *
+ * @param results Array of the results, which is sorted in place.
+ * @param number_of_results The number of results.
+ * @param merged Pointer to the `shard_result` that receives the merged result, a single shard covering the whole campaign.
+ * @return A message describing why the results could not be merged, or `NULL` on success.
+ */
+validate_message merge_shard_results(shard_result* results, const unsigned int number_of_results, shard_result* merged);
+
+/**
+ * @brief Function to find the number of rounds below which a fraction of the games ended, from the histogram of a result.
+ *
+ * Below `CAMPAIGN_HISTOGRAM_EXACT_ROUNDS` the rounds are exact, above they are the last rounds of their bucket, at most 1/32 too many, and never more than the `maximum_rounds` of the result.
+ *
+ * @param result Pointer to the `shard_result`.
+ * @param fraction The fraction of the games, between 0 and 1.
+ * @return The rounds.
+ */
+unsigned int shard_result_percentile(const shard_result* result, const double fraction);
+
+/**
+ * @brief Function to write a shard result to a file, replacing it atomically.
+ *
+ * @param result Pointer to the `shard_result`.
+ * @param path The path of the file.
+ * @return A message describing why the file could not be written, or `NULL` on success.
+ */
+validate_message save_shard_result(const shard_result* result, const char *const path);
+
+/**
+ * @brief Function to read a shard result from a file written by `save_shard_result`.
+ *
+ * @param path The path of the file.
+ * @param result Pointer to the `shard_result` that is filled in.
+ * @return A message describing why the file could not be read, or `NULL` on success.
+ */
+validate_message load_shard_result(const char *const path, shard_result* result);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief Function to compute the first unit of a shard, which is also the unit after the last one of the previous shard.
+ */
+uint64_t _shard_first_unit(const uint64_t units, const unsigned int shard, const unsigned int shards);
+
+/**
+ * @brief Function to start an empty result for the units `first_unit`..`last_unit - 1` of a campaign.
+ */
+void _start_shard_result(shard_result* result, const campaign campaign, const uint64_t first_unit, const uint64_t last_unit);
+
+/**
+ * @brief Function to add the result of a single game to a shard result.
+ */
+void _add_to_shard_result(shard_result* result, const game_result game);
+
+/**
+ * @brief Function to find the bucket of the rounds histogram that counts a number of rounds.
+ *
+ * From `CAMPAIGN_HISTOGRAM_EXACT_ROUNDS` on, the highest bit of the rounds picks the doubling and the 5 bits below it the bucket within it.
+ */
+unsigned int _rounds_bucket(const uint32_t rounds);
+
+/**
+ * @brief Function to find the largest number of rounds counted by a bucket of the rounds histogram.
+ */
+uint32_t _bucket_last_rounds(const unsigned int bucket);
+
+/**
+ * @brief Function to compare two shard results by their first unit, for `qsort`.
+ */
+int _compare_shard_results(const void* left, const void* right);
+
+#endif // CSNAKE_LADDER_CAMPAIGN_H
@@ -10,9 +10,38 @@
 #define CSNAKE_LADDER_CONFIG_H
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <stdbool.h>
+#include <time.h>
 #include "types.h"
 
+/**
+ * @brief Validation function accepting between 1 and 10 players.
+ *
+ * @param input The number of players.
+ * @return A validation message, or `NULL` if the number of players is valid.
+ */
+validate_message ensure_players_within_1_10(validate_int input);
+
+/**
+ * @brief Validation function accepting difficulty levels between 1 and 10.
+ *
+ * @param input The difficulty level.
+ * @return A validation message, or `NULL` if the difficulty level is valid.
+ */
+validate_message ensure_difficulty_within_1_10(validate_int input);
+
+/**
+ * @brief Validation function accepting difficulty levels between 1 and 1000, for sparse boards (see `representation_sparse`).
+ *
+ * The board grows with the difficulty, and only sparse boards stay small enough for the levels above 10.
+ *
+ * @param input The difficulty level.
+ * @return A validation message, or `NULL` if the difficulty level is valid.
+ */
+validate_message ensure_difficulty_within_1_1000(validate_int input);
+
 /**
  * @brief Function to receive game configuration from the user.
  *
@@ -21,6 +50,8 @@
  *
  * The specific implementation details of this function depend on the game's configuration options and validation logic.
  *
+ * The seed is taken from the current time; it can be printed to replay the same game.
+ *
  * @return A `config` structure containing the collected game configuration details.
  */
 config receive_config_from_user();
@@ -31,6 +62,8 @@ config receive_config_from_user();
  * This function prompts the user for an integer value with a provided label and performs basic validation using a supplied validation function.
  * It's likely defined elsewhere (perhaps in "types.h") and expected to handle error scenarios appropriately.
  *
+ * Every answer is read as a whole line, so answers piped in one per line are read in order. The program exits if the input ends before a valid answer was given. For scripted runs without prompts see `read_job`.
+ *
  * @param label A constant character pointer representing the label to display to the user before input.
  * @param validate A validation function pointer that takes an `unsigned int` and returns a `const char*` (validation message) or `NULL` if valid.
  *
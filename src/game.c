@@ -0,0 +1,95 @@
+#include "game.h"
+
+game new_game(const board board, players_array_pointer players) {
+    for(unsigned int i = 0;i < board.number_of_players;i++) {
+        const struct player player = { .position = 1 };
+        players[i] = player;
+    }
+
+    game game = {
+        .board = board,
+        .players = players,
+        .last_move = moved,
+    };
+
+    return game;
+}
+
+turn_outcome game_apply_roll(game* game, const unsigned int roll) {
+    TRACE_BEGIN(roll);
+    TRACE_COUNT(counter_rolls);
+
+    game->rolls += 1;
+
+    // Keep on rolling if get 6s, but invalidate move for 3 consecutive sixes
+    if(roll == 6) game->consecutive_sixes += 1;
+
+    turn_outcome outcome;
+
+    if(game->consecutive_sixes == 3) {
+        game->invalidated_moves += 1;
+        TRACE_COUNT(counter_three_sixes);
+        outcome = three_sixes;
+    } else {
+        player* player = game->players + game->current_player;
+
+        game->last_move = move_player(game->board,player,roll);
+
+        switch (game->last_move) {
+            case climbed_ladder: game->ladder_hits += 1; TRACE_COUNT(counter_ladder_hits); break;
+            case bitten_by_snake: game->snake_hits += 1; TRACE_COUNT(counter_snake_hits); break;
+            case move_past_finish: game->invalidated_moves += 1; TRACE_COUNT(counter_moves_past_finish); break;
+            default: break;
+        }
+
+        if(player_has_finished(game->board,*player)) {
+            game->finished = true;
+            game->winner = game->current_player;
+            game->turns += 1;
+            TRACE_END(span_apply_roll,roll);
+            return game_won;
+        }
+
+        if(roll == 6) {
+            TRACE_COUNT(counter_rolls_again);
+            TRACE_END(span_apply_roll,roll);
+            return roll_again;
+        }
+
+        outcome = turn_over;
+    }
+
+    // Update Round and Player
+    game->turns += 1;
+    game->consecutive_sixes = 0;
+
+    if(game->current_player == game->board.number_of_players - 1) {
+        game->round += 1;
+        game->current_player = 0;
+    } else game->current_player += 1;
+
+    TRACE_END(span_apply_roll,roll);
+    return outcome;
+}
+
+move_result move_player(const board board,player* player,const unsigned int roll) {
+    const unsigned int target = player->position + roll;
+
+    // If the sum of their current position and the roll value exceeds the total number of spaces on the board,
+    // then invalidate the roll.
+    if(target > board.jumps.number_of_cells) return move_past_finish;
+
+    // Ladders and snakes are already folded into the jump table
+    const unsigned int destination = jump_destination(board.jumps,target);
+
+    player->position = destination;
+
+    if(destination > target) return climbed_ladder;
+    if(destination < target) return bitten_by_snake;
+
+    return moved;
+}
+
+bool player_has_finished(const board board, const player player) {
+    return player.position == board.jumps.number_of_cells;
+}
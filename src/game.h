@@ -0,0 +1,58 @@
+/**
+ * @file CSnakeLadderGame.h
+ * @brief Header file containing the rules of Snake and Ladder.
+ *
+ * This header file defines functions for moving players and applying dice rolls to a `game`. The rules perform no input or output, so they are shared by the interactive game and the headless simulation.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_GAME_H
+#define CSNAKE_LADDER_GAME_H
+
+#include <stdbool.h>
+
+#include "types.h"
+#include "board.h"
+#include "trace.h"
+
+/**
+ * @brief Function to start a new game on the given board.
+ *
+ * Every player in `players` is placed back on the first cell, and the first player is the one to roll.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param players Pointer to at least `board.number_of_players` players, whose positions will be used for this game.
+ * @return A `game` structure holding the initial turn state.
+ */
+game new_game(const board board, players_array_pointer players);
+
+/**
+ * @brief Function to apply a single dice roll for the current player.
+ *
+ * Sixes let the player roll again, but a third six in a row invalidates the move and ends the turn. Once the turn is over the next player is up.
+ *
+ * @param game Pointer to the `game` to advance.
+ * @param roll The value rolled (1-6).
+ * @return The `turn_outcome` describing what the game expects next.
+ */
+turn_outcome game_apply_roll(game* game, const unsigned int roll);
+
+/**
+ * @brief Function to move a player forward by a roll, following any ladder or snake it lands on.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param player Pointer to the player to move.
+ * @param roll The value rolled (1-6).
+ * @return The `move_result` describing the move.
+ */
+move_result move_player(const board board, player* player, const unsigned int roll);
+
+/**
+ * @brief Checks whether a player stands on the final cell of the board.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param player The player to check.
+ * @return True if the player has finished, False otherwise.
+ */
+bool player_has_finished(const board board, const player player);
+
+#endif // CSNAKE_LADDER_GAME_H
@@ -0,0 +1,230 @@
+#include "jobs.h"
+
+job_reader open_job_reader(const char *const path, validate_message* error) {
+    job_reader reader = { 0 };
+
+    *error = NULL;
+
+    if(strcmp(path,"-") == 0) reader.input = stdin;
+    else reader.input = fopen(path,"r");
+
+    if(reader.input == NULL) *error = "The job stream could not be opened!\n";
+
+    return reader;
+}
+
+void close_job_reader(job_reader reader) {
+    if(reader.input != NULL && reader.input != stdin) fclose(reader.input);
+
+    free(reader.line);
+}
+
+bool read_job(job_reader* reader, job* job, validate_message* error) {
+    *error = NULL;
+
+    while(_read_line(reader)) {
+        const char* first = reader->line + strspn(reader->line," \t\r");
+
+        // Empty lines and comments are not jobs
+        if(*first == '\0' || *first == '#') continue;
+
+        *error = parse_job(reader->line,job);
+
+        return true;
+    }
+
+    return false;
+}
+
+validate_message parse_job(char* line, job* job) {
+    const struct job defaults = {
+        .number_of_players = 0,
+        .difficulty = 0,
+        .seed = 1,
+        .number_of_games = 1,
+        .maximum_rounds = JOB_DEFAULT_MAXIMUM_ROUNDS,
+        .output = output_summary,
+        .representation = representation_automatic,
+        .save_path = NULL,
+    };
+
+    *job = defaults;
+
+    char* field = line;
+
+    while(true) {
+        field += strspn(field," \t\r");
+        if(*field == '\0') break;
+
+        // Split the field off in place and cut it at the `=`
+        char* end = field + strcspn(field," \t\r");
+        const bool last = *end == '\0';
+        *end = '\0';
+
+        char* value = strchr(field,'=');
+        if(value == NULL) return "Every field of a job has to be written as key=value!\n";
+        *value++ = '\0';
+
+        unsigned long long number;
+
+        if(strcmp(field,"players") == 0) {
+            if(!_parse_number(value,UINT_MAX,&number)) return "The number of players has to be a number!\n";
+            job->number_of_players = (unsigned int) number;
+        }
+        else if(strcmp(field,"difficulty") == 0) {
+            if(!_parse_number(value,UINT_MAX,&number)) return "The difficulty level has to be a number!\n";
+            job->difficulty = (unsigned int) number;
+        }
+        else if(strcmp(field,"seed") == 0) {
+            if(!_parse_number(value,UINT64_MAX,&number)) return "The seed has to be a number!\n";
+            job->seed = number;
+        }
+        else if(strcmp(field,"games") == 0) {
+            if(!_parse_number(value,UINT_MAX,&number)) return "The number of games has to be a number!\n";
+            job->number_of_games = (unsigned int) number;
+        }
+        else if(strcmp(field,"rounds") == 0) {
+            if(!_parse_number(value,UINT_MAX,&number)) return "The maximum number of rounds has to be a number!\n";
+            job->maximum_rounds = (unsigned int) number;
+        }
+        else if(strcmp(field,"output") == 0) {
+            if(strcmp(value,"summary") == 0) job->output = output_summary;
+            else if(strcmp(value,"games") == 0) job->output = output_games;
+            else if(strcmp(value,"none") == 0) job->output = output_none;
+            else return "The output has to be summary, games or none!\n";
+        }
+        else if(strcmp(field,"board") == 0) {
+            if(strcmp(value,"auto") == 0) job->representation = representation_automatic;
+            else if(strcmp(value,"dense") == 0) job->representation = representation_dense;
+            else if(strcmp(value,"sparse") == 0) job->representation = representation_sparse;
+            else return "The board has to be auto, dense or sparse!\n";
+        }
+        else if(strcmp(field,"save") == 0) {
+            if(*value == '\0') return "The path to save the board to is empty!\n";
+            job->save_path = value;
+        }
+        else return "Unknown field in job, the fields are players, difficulty, seed, games, rounds, output, board and save!\n";
+
+        if(last) break;
+        field = end + 1;
+    }
+
+    // The same checks as the interactive prompts, only sparse boards may grow beyond them
+    validate_message message = ensure_players_within_1_10(job->number_of_players);
+    if(message == NULL) {
+        message = job->representation == representation_sparse
+            ? ensure_difficulty_within_1_1000(job->difficulty)
+            : ensure_difficulty_within_1_10(job->difficulty);
+    }
+
+    return message;
+}
+
+validate_message run_job(const job job, const unsigned long line_number, arena* boards, FILE* output) {
+    const config config = {
+        .number_of_players = job.number_of_players,
+        .difficulty = job.difficulty,
+        .seed = job.seed,
+        .representation = job.representation,
+    };
+
+    const board board = generate_board_in_arena(config,boards);
+
+    const simulation_options options = { .maximum_rounds = job.maximum_rounds };
+    simulation_summary summary = { 0 };
+
+    game_result results[SIMULATION_BATCH_SIZE];
+
+    for(unsigned int first = 0;first < job.number_of_games;first += SIMULATION_BATCH_SIZE) {
+        const unsigned int count = job.number_of_games - first < SIMULATION_BATCH_SIZE ? job.number_of_games - first : SIMULATION_BATCH_SIZE;
+
+        simulate_games(board,first,count,options,results);
+
+        for(unsigned int i = 0;i < count;i++) {
+            const game_result result = results[i];
+
+            _add_to_summary(&summary,result);
+
+            if(job.output == output_games) {
+                fprintf(output,"line=%lu game=%u finished=%d winner=%u rounds=%u turns=%u rolls=%u ladder_hits=%u snake_hits=%u\n",
+                    line_number,first + i + 1,result.finished,result.finished ? result.winner + 1 : 0,
+                    result.rounds,result.turns,result.rolls,result.ladder_hits,result.snake_hits
+                );
+            }
+        }
+    }
+
+    if(job.output != output_none) _write_job_summary(output,line_number,job,board,summary);
+
+    const validate_message error = job.save_path != NULL ? save_board(board,job.save_path) : NULL;
+
+    arena_reset(boards);
+
+    return error;
+}
+
+bool _read_line(job_reader* reader) {
+    size_t length = 0;
+
+    while(true) {
+        if(reader->capacity - length < 2) {
+            reader->capacity = reader->capacity == 0 ? 256 : reader->capacity * 2;
+            reader->line = realloc(reader->line,reader->capacity);
+
+            if(reader->line == NULL) {
+                perror("realloc has failed");
+                exit(1);
+            }
+        }
+
+        if(fgets(reader->line + length,(int)(reader->capacity - length),reader->input) == NULL) {
+            // A last line without a newline still counts
+            if(length == 0) return false;
+            break;
+        }
+
+        length += strlen(reader->line + length);
+
+        if(reader->line[length - 1] == '\n') {
+            reader->line[--length] = '\0';
+            break;
+        }
+    }
+
+    reader->line_number += 1;
+
+    return true;
+}
+
+bool _parse_number(const char* value, const unsigned long long maximum, unsigned long long* number) {
+    if(*value < '0' || *value > '9') return false;
+
+    char* end;
+
+    errno = 0;
+    *number = strtoull(value,&end,10);
+
+    return *end == '\0' && errno == 0 && *number <= maximum;
+}
+
+void _write_job_summary(FILE* output, const unsigned long line_number, const job job, const board board, const simulation_summary summary) {
+    // A board that ran out of room has fewer ladders or snakes than its configuration asked for
+    fprintf(output,"line=%lu players=%u difficulty=%u seed=%llu board_size=%u ladders=%u requested_ladders=%u snakes=%u requested_snakes=%u games=%u finished=%u capped=%u maximum_rounds=%u",
+        line_number,job.number_of_players,job.difficulty,(unsigned long long) job.seed,
+        board.board_size,board.number_of_ladders,board.requested_ladders,board.number_of_snakes,board.requested_snakes,
+        summary.games,summary.finished_games,summary.games - summary.finished_games,job.maximum_rounds
+    );
+
+    if(summary.games != 0) {
+        fprintf(output," mean_rounds=%.3f min_rounds=%u max_rounds=%u ladder_hits_per_game=%.3f snake_hits_per_game=%.3f",
+            (double) summary.total_rounds / summary.games,summary.minimum_rounds,summary.maximum_rounds,
+            (double) summary.total_ladder_hits / summary.games,(double) summary.total_snake_hits / summary.games
+        );
+    }
+
+    fprintf(output," wins=");
+    for(unsigned int player = 0;player < job.number_of_players;player++) {
+        fprintf(output,player == 0 ? "%u" : ",%u",summary.wins[player]);
+    }
+    fputc('\n',output);
+}
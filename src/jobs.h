@@ -0,0 +1,106 @@
+/**
+ * @file CSnakeLadderJobs.h
+ * @brief Header file containing the non-interactive job stream of Snake and Ladder.
+ *
+ * A job stream is a file (or stdin) with one `job` per line, instead of the prompts of `receive_config_from_user`. Every line is a list of `key=value` fields separated by spaces:
+ *
+ *     players=4 difficulty=7 seed=42 games=1000 output=games save=boards/42.board
+ *
+ * `players` and `difficulty` are required and checked with `ensure_players_within_1_10` and `ensure_difficulty_within_1_10`. `seed` defaults to 1, `games` to 1, `rounds` (the round a game is abandoned at, 0 for never) to `JOB_DEFAULT_MAXIMUM_ROUNDS`, `output` (`summary`, `games` or `none`) to `summary` and `board` (`auto`, `dense` or `sparse`, see `board_representation`) to `auto`; `save` is optional. With `board=sparse` the difficulty may go up to 1000 (see `ensure_difficulty_within_1_1000`). Such boards can hold far more snakes than ladders and have games that would take billions of rounds, which is what the round cap is for; the summary counts the games it abandoned, and the ladders and snakes the board was short of. Empty lines and lines starting with `#` are skipped, so one process can work through a whole queue of configurations, even one that is still being written to a pipe.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_JOBS_H
+#define CSNAKE_LADDER_JOBS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "types.h"
+#include "config.h"
+#include "board.h"
+#include "arena.h"
+#include "simulation.h"
+#include "storage.h"
+
+/**
+ * @def JOB_DEFAULT_MAXIMUM_ROUNDS
+ * @brief The round at which the games of a job without a `rounds` field are abandoned. No game on a board of difficulty 1 to 10 comes close to it.
+ */
+#define JOB_DEFAULT_MAXIMUM_ROUNDS 100000
+
+/**
+ * @brief Function to open a job stream.
+ *
+ * @param path The path of the file, or `-` for stdin.
+ * @param error Pointer that receives a message describing why the stream could not be opened, or `NULL` on success.
+ * @return The `job_reader`. (Caller needs to release it with `close_job_reader`)
+ */
+job_reader open_job_reader(const char *const path, validate_message* error);
+
+/**
+ * @brief Closes a job stream (unless it is stdin) and frees its line buffer.
+ */
+void close_job_reader(job_reader reader);
+
+/**
+ * @brief Function to read the next job from a stream.
+ *
+ * Lines of any length are read whole; empty lines and comments are skipped.
+ *
+ * @param reader Pointer to the `job_reader`.
+ * @param job Pointer to the `job` that is filled in.
+ * @param error Pointer that receives a message describing why the line was rejected (`job` is then left unspecified), or `NULL` if it holds a job.
+ * @return `false` once the stream has ended, `true` if a line was read.
+ */
+bool read_job(job_reader* reader, job* job, validate_message* error);
+
+/**
+ * @brief Function to parse one line of a job stream.
+ *
+ * @param line The line, which is modified: the fields are split in place and `job->save_path` points into it.
+ * @param job Pointer to the `job` that is filled in.
+ * @return A validation message, or `NULL` if the line holds a valid job.
+ */
+validate_message parse_job(char* line, job* job);
+
+/**
+ * @brief Function to run a job: generate its board, play its games and write the results.
+ *
+ * Game `i` is seeded with stream `i + 1` of the seed, like in `simulate_board`, and abandoned after the job's `maximum_rounds`. The results are written as `key=value` lines starting with `line=<line_number>`, so that they can be matched to the job stream however the output is buffered.
+ *
+ * @param job The `job` to run.
+ * @param line_number The line of the job stream the job was read from.
+ * @param boards Pointer to the `arena` the board is generated into. It is reset once the job is done, so the same arena serves the whole stream.
+ * @param output The stream the results are written to.
+ * @return A message describing why the board could not be saved, or `NULL` on success.
+ */
+validate_message run_job(const job job, const unsigned long line_number, arena* boards, FILE* output);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief Function to read one whole line into the buffer of a `job_reader`, growing it as needed.
+ *
+ * @param reader Pointer to the `job_reader`.
+ * @return `false` once the stream has ended, `true` if a line was read. The trailing newline is removed.
+ */
+bool _read_line(job_reader* reader);
+
+/**
+ * @brief Function to parse the value of a numeric field.
+ *
+ * @param value The text of the value.
+ * @param maximum The largest value accepted.
+ * @param number Pointer that receives the number.
+ * @return `true` if `value` is a decimal number no larger than `maximum`.
+ */
+bool _parse_number(const char* value, const unsigned long long maximum, unsigned long long* number);
+
+/**
+ * @brief Writes the summary line of a job.
+ */
+void _write_job_summary(FILE* output, const unsigned long line_number, const job job, const board board, const simulation_summary summary);
+
+#endif // CSNAKE_LADDER_JOBS_H
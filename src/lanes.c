@@ -0,0 +1,253 @@
+#include "lanes.h"
+
+#if defined(__AVX2__)
+
+void simulate_games_in_lanes(const board board, const unsigned int first_game, const unsigned int number_of_games, const simulation_options options, game_result* results) {
+    game_lanes lanes = { 0 };
+
+    const unsigned int end = first_game + number_of_games;
+    unsigned int next_game = first_game;
+    unsigned int active_lanes = 0;
+
+    for(unsigned int lane = 0;lane < GAME_LANES && next_game < end;lane++,active_lanes++) {
+        _start_lane(&lanes,lane,board,next_game++);
+    }
+
+    while(active_lanes != 0) {
+        const unsigned int over = _advance_lanes_avx2(&lanes,board,options);
+
+        for(unsigned int lane = 0;lane < GAME_LANES;lane++) {
+            if((over & (1u << lane)) == 0) continue;
+
+            results[lanes.game[lane] - first_game] = _lane_result(&lanes,lane);
+
+            // Refill the lane with the next game, or leave it idle once there are none left
+            if(next_game < end) _start_lane(&lanes,lane,board,next_game++);
+            else {
+                lanes.active[lane] = 0;
+                active_lanes -= 1;
+            }
+        }
+    }
+}
+
+void _start_lane(game_lanes* lanes, const unsigned int lane, const board board, const unsigned int game) {
+    const rng dice = rng_for_stream(board.config.seed,game + 1);
+
+    for(int k = 0;k < 4;k++) lanes->rng[k][lane] = dice.state[k];
+
+    for(unsigned int player = 0;player < MAXIMUM_NUMBER_OF_PLAYERS;player++) lanes->positions[player][lane] = 1;
+
+    lanes->current_player[lane] = 0;
+    lanes->consecutive_sixes[lane] = 0;
+    lanes->round[lane] = 0;
+    lanes->turns[lane] = 0;
+    lanes->rolls[lane] = 0;
+    lanes->ladder_hits[lane] = 0;
+    lanes->snake_hits[lane] = 0;
+    lanes->invalidated_moves[lane] = 0;
+    lanes->finished[lane] = 0;
+    lanes->active[lane] = UINT32_MAX;
+    lanes->game[lane] = game;
+}
+
+game_result _lane_result(const game_lanes* lanes, const unsigned int lane) {
+    const bool finished = lanes->finished[lane] != 0;
+
+    const game_result result = {
+        .finished = finished,
+        .winner = finished ? lanes->current_player[lane] : 0,
+        .rounds = finished ? lanes->round[lane] + 1 : lanes->round[lane],
+        .turns = lanes->turns[lane],
+        .rolls = lanes->rolls[lane],
+        .ladder_hits = lanes->ladder_hits[lane],
+        .snake_hits = lanes->snake_hits[lane],
+        .invalidated_moves = lanes->invalidated_moves[lane],
+    };
+
+    return result;
+}
+
+static inline __m256i _rotate_left_lanes(const __m256i x, const int k) {
+    return _mm256_or_si256(_mm256_slli_epi64(x,k),_mm256_srli_epi64(x,64 - k));
+}
+
+// xoshiro256** for four generators at once, the multiplications by 5 and 9 are shifts and adds
+static inline __m256i _rng_next_lanes(__m256i s[4]) {
+    const __m256i times_5 = _mm256_add_epi64(_mm256_slli_epi64(s[1],2),s[1]);
+    const __m256i rotated = _rotate_left_lanes(times_5,7);
+    const __m256i result = _mm256_add_epi64(_mm256_slli_epi64(rotated,3),rotated);
+    const __m256i t = _mm256_slli_epi64(s[1],17);
+
+    s[2] = _mm256_xor_si256(s[2],s[0]);
+    s[3] = _mm256_xor_si256(s[3],s[1]);
+    s[1] = _mm256_xor_si256(s[1],s[2]);
+    s[0] = _mm256_xor_si256(s[0],s[3]);
+
+    s[2] = _mm256_xor_si256(s[2],t);
+    s[3] = _rotate_left_lanes(s[3],45);
+
+    return result;
+}
+
+unsigned int _advance_lanes_avx2(game_lanes* lanes, const board board, const simulation_options options) {
+    const int* jumps = (const int*) board.jumps.destination;
+    int* positions = (int*) lanes->positions;
+
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i six = _mm256_set1_epi32(6);
+    const __m256i three = _mm256_set1_epi32(3);
+    const __m256i final_cell = _mm256_set1_epi32((int) board.jumps.number_of_cells);
+    const __m256i last_player = _mm256_set1_epi32((int) board.number_of_players - 1);
+    const __m256i lane_index = _mm256_setr_epi32(0,1,2,3,4,5,6,7);
+    const __m256i pack_low_halves = _mm256_setr_epi32(0,2,4,6,1,3,5,7);
+
+    // A game is over once its round exceeds the last one that may be played
+    const __m256i last_round = _mm256_set1_epi32(options.maximum_rounds == 0 || options.maximum_rounds > INT_MAX ? INT_MAX : (int) options.maximum_rounds - 1);
+
+    // The same rejection as `rng_below(rng, 6)`, its threshold is tiny so the low halves of the products are compared as signed 64-bit numbers
+    const __m256i range = _mm256_set1_epi64x(6);
+    const __m256i low_half = _mm256_set1_epi64x(UINT32_MAX);
+    const __m256i threshold = _mm256_set1_epi64x(-(uint32_t) 6 % 6);
+
+    // Generators of lanes 0 to 3 and 4 to 7, 64-bit words do not fit eight to a register
+    __m256i first_rng[4];
+    __m256i second_rng[4];
+
+    for(int k = 0;k < 4;k++) {
+        first_rng[k] = _mm256_load_si256((const __m256i*) lanes->rng[k]);
+        second_rng[k] = _mm256_load_si256((const __m256i*)(lanes->rng[k] + 4));
+    }
+
+    __m256i current_player = _mm256_load_si256((const __m256i*) lanes->current_player);
+    __m256i consecutive_sixes = _mm256_load_si256((const __m256i*) lanes->consecutive_sixes);
+    __m256i round = _mm256_load_si256((const __m256i*) lanes->round);
+    __m256i turns = _mm256_load_si256((const __m256i*) lanes->turns);
+    __m256i rolls = _mm256_load_si256((const __m256i*) lanes->rolls);
+    __m256i ladder_hits = _mm256_load_si256((const __m256i*) lanes->ladder_hits);
+    __m256i snake_hits = _mm256_load_si256((const __m256i*) lanes->snake_hits);
+    __m256i invalidated_moves = _mm256_load_si256((const __m256i*) lanes->invalidated_moves);
+    const __m256i active = _mm256_load_si256((const __m256i*) lanes->active);
+
+    // Idle lanes may never have been started, and the all-zero generator of such a lane is rejected on every draw
+    const __m256i first_active = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(active));
+    const __m256i second_active = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(active,1));
+
+    __m256i finished;
+    __m256i over;
+
+    // Masks are all bits set, so subtracting one adds 1 in exactly the lanes it selects
+    do {
+        const __m256i first_product = _mm256_mul_epu32(_mm256_srli_epi64(_rng_next_lanes(first_rng),32),range);
+        const __m256i second_product = _mm256_mul_epu32(_mm256_srli_epi64(_rng_next_lanes(second_rng),32),range);
+
+        // The upper halves of the products are the rolls, moved next to each other in lane order
+        __m256i roll = _mm256_add_epi32(one,_mm256_permute2x128_si256(
+            _mm256_permutevar8x32_epi32(_mm256_srli_epi64(first_product,32),pack_low_halves),
+            _mm256_permutevar8x32_epi32(_mm256_srli_epi64(second_product,32),pack_low_halves),
+            0x20
+        ));
+
+        const __m256i rejected = _mm256_or_si256(
+            _mm256_and_si256(first_active,_mm256_cmpgt_epi64(threshold,_mm256_and_si256(first_product,low_half))),
+            _mm256_and_si256(second_active,_mm256_cmpgt_epi64(threshold,_mm256_and_si256(second_product,low_half)))
+        );
+
+        if(!_mm256_testz_si256(rejected,rejected)) {
+            _Alignas(32) uint64_t products[GAME_LANES];
+            _Alignas(32) uint32_t redrawn[GAME_LANES];
+
+            for(int k = 0;k < 4;k++) {
+                _mm256_store_si256((__m256i*) lanes->rng[k],first_rng[k]);
+                _mm256_store_si256((__m256i*)(lanes->rng[k] + 4),second_rng[k]);
+            }
+
+            _mm256_store_si256((__m256i*) products,first_product);
+            _mm256_store_si256((__m256i*)(products + 4),second_product);
+            _mm256_store_si256((__m256i*) redrawn,roll);
+
+            _redraw_rejected_rolls(lanes,products,redrawn);
+
+            for(int k = 0;k < 4;k++) {
+                first_rng[k] = _mm256_load_si256((const __m256i*) lanes->rng[k]);
+                second_rng[k] = _mm256_load_si256((const __m256i*)(lanes->rng[k] + 4));
+            }
+
+            roll = _mm256_load_si256((const __m256i*) redrawn);
+        }
+
+        const __m256i rolled_six = _mm256_cmpeq_epi32(roll,six);
+
+        rolls = _mm256_sub_epi32(rolls,active);
+        consecutive_sixes = _mm256_sub_epi32(consecutive_sixes,_mm256_and_si256(active,rolled_six));
+
+        const __m256i three_sixes = _mm256_and_si256(active,_mm256_cmpeq_epi32(consecutive_sixes,three));
+
+        const __m256i position = _mm256_i32gather_epi32(positions,_mm256_add_epi32(_mm256_slli_epi32(current_player,3),lane_index),4);
+        const __m256i target = _mm256_add_epi32(position,roll);
+
+        // Only lanes that move read the jump table, the others could point past its end
+        const __m256i moves = _mm256_andnot_si256(_mm256_or_si256(three_sixes,_mm256_cmpgt_epi32(target,final_cell)),active);
+        const __m256i destination = _mm256_mask_i32gather_epi32(target,jumps,target,moves,4);
+
+        ladder_hits = _mm256_sub_epi32(ladder_hits,_mm256_and_si256(moves,_mm256_cmpgt_epi32(destination,target)));
+        snake_hits = _mm256_sub_epi32(snake_hits,_mm256_and_si256(moves,_mm256_cmpgt_epi32(target,destination)));
+        invalidated_moves = _mm256_sub_epi32(invalidated_moves,_mm256_andnot_si256(moves,active));
+
+        for(unsigned int player = 0;player < board.number_of_players;player++) {
+            const __m256i turn_of_player = _mm256_cmpeq_epi32(current_player,_mm256_set1_epi32((int) player));
+            _mm256_maskstore_epi32(positions + player * GAME_LANES,_mm256_and_si256(moves,turn_of_player),destination);
+        }
+
+        finished = _mm256_and_si256(moves,_mm256_cmpeq_epi32(destination,final_cell));
+
+        // The turn ends after three sixes or any other roll than a six, unless the game was won
+        const __m256i turn_over = _mm256_andnot_si256(finished,_mm256_or_si256(three_sixes,_mm256_andnot_si256(rolled_six,active)));
+        const __m256i next_round = _mm256_and_si256(turn_over,_mm256_cmpeq_epi32(current_player,last_player));
+
+        turns = _mm256_sub_epi32(turns,_mm256_or_si256(finished,turn_over));
+        consecutive_sixes = _mm256_andnot_si256(turn_over,consecutive_sixes);
+        round = _mm256_sub_epi32(round,next_round);
+        current_player = _mm256_andnot_si256(next_round,_mm256_sub_epi32(current_player,turn_over));
+
+        over = _mm256_or_si256(finished,_mm256_and_si256(active,_mm256_cmpgt_epi32(round,last_round)));
+    } while(_mm256_testz_si256(over,over));
+
+    for(int k = 0;k < 4;k++) {
+        _mm256_store_si256((__m256i*) lanes->rng[k],first_rng[k]);
+        _mm256_store_si256((__m256i*)(lanes->rng[k] + 4),second_rng[k]);
+    }
+
+    _mm256_store_si256((__m256i*) lanes->current_player,current_player);
+    _mm256_store_si256((__m256i*) lanes->consecutive_sixes,consecutive_sixes);
+    _mm256_store_si256((__m256i*) lanes->round,round);
+    _mm256_store_si256((__m256i*) lanes->turns,turns);
+    _mm256_store_si256((__m256i*) lanes->rolls,rolls);
+    _mm256_store_si256((__m256i*) lanes->ladder_hits,ladder_hits);
+    _mm256_store_si256((__m256i*) lanes->snake_hits,snake_hits);
+    _mm256_store_si256((__m256i*) lanes->invalidated_moves,invalidated_moves);
+    _mm256_store_si256((__m256i*) lanes->finished,finished);
+
+    return (unsigned int) _mm256_movemask_ps(_mm256_castsi256_ps(over));
+}
+
+void _redraw_rejected_rolls(game_lanes* lanes, const uint64_t products[GAME_LANES], uint32_t rolls[GAME_LANES]) {
+    const uint32_t range = 6;
+    const uint32_t threshold = -range % range;
+
+    for(unsigned int lane = 0;lane < GAME_LANES;lane++) {
+        uint64_t product = products[lane];
+        if(lanes->active[lane] == 0 || (uint32_t) product >= threshold) continue;
+
+        rng dice;
+        for(int k = 0;k < 4;k++) dice.state[k] = lanes->rng[k][lane];
+
+        while((uint32_t) product < threshold) product = (uint64_t)(uint32_t)(rng_next(&dice) >> 32) * range;
+
+        for(int k = 0;k < 4;k++) lanes->rng[k][lane] = dice.state[k];
+
+        rolls[lane] = 1 + (uint32_t)(product >> 32);
+    }
+}
+
+#endif // __AVX2__
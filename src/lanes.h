@@ -0,0 +1,70 @@
+/**
+ * @file CSnakeLadderLanes.h
+ * @brief Header file containing the lane-parallel game kernel of the Snake and Ladder simulation.
+ *
+ * Games on the same board are independent, so instead of playing them one after the other, this header file defines a kernel that keeps `GAME_LANES` games side by side in a `game_lanes` block and advances all of them with every step: eight xoshiro256** generators are stepped together, the current positions and the jump table are read with gathers and every rule of `game_apply_roll` is applied as a mask. A lane whose game is over is refilled with the next game right away, so the lanes stay busy until the batch runs dry.
+ *
+ * The kernel plays exactly the same games as `simulate_game` with the same seeds, roll for roll. It is only compiled when AVX2 is available (for example with `-mavx2`) and needs the flat jump table of a dense board, `simulate_games` falls back to `simulate_game` otherwise.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_LANES_H
+#define CSNAKE_LADDER_LANES_H
+
+#include <stdint.h>
+#include <limits.h>
+
+#if defined(__AVX2__)
+    # include <immintrin.h>
+#endif
+
+#include "types.h"
+#include "rng.h"
+
+#if defined(__AVX2__)
+
+/**
+ * @brief Function to play a range of games on a board.
+ *
+ * Game `i` is seeded with stream `i + 1` of the seed in `board.config`, like in `simulate_board`, so `results` matches playing the games one by one with `simulate_game`.
+ *
+ * @param board The `board` structure representing the game board, which has to have a flat jump table.
+ * @param first_game The index of the first game of the range.
+ * @param number_of_games The number of games to play.
+ * @param options The `simulation_options` limiting every game.
+ * @param results Array of `number_of_games` results, game `first_game + i` is written to `results[i]`.
+ */
+void simulate_games_in_lanes(const board board, const unsigned int first_game, const unsigned int number_of_games, const simulation_options options, game_result* results);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief Function to start a game in a lane, with every player on the first cell.
+ */
+void _start_lane(game_lanes* lanes, const unsigned int lane, const board board, const unsigned int game);
+
+/**
+ * @brief Function to read the result of the game in a lane.
+ */
+game_result _lane_result(const game_lanes* lanes, const unsigned int lane);
+
+/**
+ * @brief Function to advance all lanes at once, until at least one of their games is over.
+ *
+ * @return A bit mask of the lanes whose game is over.
+ */
+unsigned int _advance_lanes_avx2(game_lanes* lanes, const board board, const simulation_options options);
+
+/**
+ * @brief Function to draw the rolls that `rng_below` would have rejected again, one lane at a time.
+ *
+ * This happens to about one roll in a billion, so it does not need to be fast.
+ *
+ * @param lanes Pointer to the `game_lanes`, whose generators are already stored.
+ * @param products The products of the first draw of every lane.
+ * @param rolls The rolls of every lane, those of the rejected lanes are replaced. Idle lanes are left alone.
+ */
+void _redraw_rejected_rolls(game_lanes* lanes, const uint64_t products[GAME_LANES], uint32_t rolls[GAME_LANES]);
+
+#endif // __AVX2__
+
+#endif // CSNAKE_LADDER_LANES_H
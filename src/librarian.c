@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "types.h"
+#include "config.h"
+#include "board.h"
+#include "library.h"
+#include "timer.h"
+
+// Fills a board library with pregenerated boards for every difficulty x players combination the config accepts.
+//
+// Usage: librarian <directory> [seeds] [first seed]
+//
+// Every combination is generated with the seeds `first seed`..`first seed + seeds - 1` (1..10 by default) and
+// added to the library in `directory`, which is created if needed. Running it again with other seeds grows the
+// library, running it with the same seeds replaces those boards.
+
+#define LIBRARIAN_DEFAULT_SEEDS 10
+
+int main(int argc, char** argv) {
+    if(argc < 2) {
+        fprintf(stderr,"Usage: %s <directory> [seeds] [first seed]\n",argv[0]);
+        return 1;
+    }
+
+    const char *const directory = argv[1];
+    const unsigned int seeds = argc > 2 ? (unsigned int) strtoul(argv[2],NULL,10) : LIBRARIAN_DEFAULT_SEEDS;
+    const uint64_t first_seed = argc > 3 ? strtoull(argv[3],NULL,10) : 1;
+
+    board* boards = malloc(seeds * sizeof(board));
+
+    if(boards == NULL) {
+        perror("malloc has failed");
+        return 1;
+    }
+
+    const uint64_t started = monotonic_nanoseconds();
+    unsigned int added = 0;
+
+    for(unsigned int difficulty = 0;difficulty <= 11;difficulty++) {
+        if(ensure_difficulty_within_1_10(difficulty) != NULL) continue;
+
+        for(unsigned int players = 0;players <= 11;players++) {
+            if(ensure_players_within_1_10(players) != NULL) continue;
+
+            for(unsigned int i = 0;i < seeds;i++) {
+                const config config = {
+                    .number_of_players = players,
+                    .difficulty = difficulty,
+                    .seed = first_seed + i,
+                };
+
+                // `board` has constant members, so it is built in place
+                const board board = generate_board_from_config(config);
+                memcpy(&boards[i],&board,sizeof(board));
+            }
+
+            // One batch per combination, so the index is rewritten once for all its seeds
+            const validate_message error = add_to_board_library(directory,boards,seeds);
+
+            for(unsigned int i = 0;i < seeds;i++) free_board(boards[i]);
+
+            if(error != NULL) {
+                fprintf(stderr,"%s",error);
+                free(boards);
+                return 1;
+            }
+
+            added += seeds;
+            printf("difficulty %2u, %2u players: %u boards\n",difficulty,players,seeds);
+        }
+    }
+
+    free(boards);
+
+    validate_message error;
+    const board_library library = open_board_library(directory,&error);
+
+    if(error != NULL) {
+        fprintf(stderr,"%s",error);
+        return 1;
+    }
+
+    printf("Added %u boards in %.1fs, the library holds %u\n",added,(monotonic_nanoseconds() - started) / 1e9,library.number_of_entries);
+    close_board_library(library);
+
+    return 0;
+}
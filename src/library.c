@@ -0,0 +1,368 @@
+#include "library.h"
+
+#ifdef _WIN32
+    # include <direct.h>
+    # define _make_directory(path) _mkdir(path)
+#else
+    # include <sys/stat.h>
+    # define _make_directory(path) mkdir(path,0755)
+#endif
+
+_Static_assert(sizeof(library_entry) % 8 == 0,"library entries are stored back to back");
+_Static_assert(sizeof(library_file_header) % 8 == 0,"library entries start at a multiple of 8");
+
+static const char _magic[8] = { 'C', 'S', 'L', 'I', 'N', 'D', 'E', 'X' };
+
+#define _BYTE_ORDER_MARK 0x01020304u
+
+// The size of an index file: the header, the entries and one permutation per metric, padded to 8 bytes
+static inline uint64_t _index_file_size(const uint64_t number_of_entries) {
+    const uint64_t permutations = (uint64_t) number_of_board_metrics * number_of_entries * sizeof(uint32_t);
+
+    return sizeof(library_file_header) + number_of_entries * sizeof(library_entry) + (permutations + 7) / 8 * 8;
+}
+
+library_entry measure_board(const board board) {
+    library_entry entry = {
+        .number_of_players = board.config.number_of_players,
+        .difficulty = board.config.difficulty,
+        .seed = board.config.seed,
+        .board_size = board.board_size,
+        .parameters = generation_parameters_of(board.config),
+    };
+
+    double total_climb = 0;
+    double total_fall = 0;
+
+    for(unsigned int i = 0;i < board.number_of_ladders;i++) {
+        total_climb += (double) label_for_point(board,board.ladders[i].end) - label_for_point(board,board.ladders[i].start);
+    }
+
+    for(unsigned int i = 0;i < board.number_of_snakes;i++) {
+        total_fall += (double) label_for_point(board,board.snakes[i].head) - label_for_point(board,board.snakes[i].tail);
+    }
+
+    entry.metrics[metric_ladders] = board.number_of_ladders;
+    entry.metrics[metric_snakes] = board.number_of_snakes;
+    entry.metrics[metric_total_climb] = total_climb;
+    entry.metrics[metric_total_fall] = total_fall;
+    entry.metrics[metric_expected_turns] = solve_expected_turns(board);
+
+    return entry;
+}
+
+validate_message add_to_board_library(const char *const directory, const board* boards, const unsigned int number_of_boards) {
+    // The directory may exist already, any real problem shows up when the files are written
+    _make_directory(directory);
+
+    // Start from the entries already in the library, if there is one
+    validate_message error = NULL;
+    board_library library = open_board_library(directory,&error);
+
+    const unsigned int existing = error == NULL ? library.number_of_entries : 0;
+    library_entry* entries = malloc(((size_t) existing + number_of_boards) * sizeof(library_entry));
+
+    if(entries == NULL) {
+        perror("malloc has failed");
+        exit(1);
+    }
+
+    if(existing != 0) memcpy(entries,library.entries,existing * sizeof(library_entry));
+    if(error == NULL) close_board_library(library);
+
+    unsigned int number_of_entries = existing;
+    error = NULL;
+
+    for(unsigned int i = 0;i < number_of_boards && error == NULL;i++) {
+        const library_entry entry = measure_board(boards[i]);
+
+        char name[64];
+        _board_file_name(name,&entry);
+
+        char* path = _library_path(directory,name);
+        error = save_board(boards[i],path);
+        free(path);
+
+        if(error != NULL) break;
+
+        // Keep the entries sorted by key, replacing the entry of a board that is saved again
+        const unsigned int slot = _lower_bound_entry(entries,number_of_entries,&entry,LIBRARY_KEY_FIELDS,false);
+
+        if(slot == number_of_entries || _compare_entry_keys(&entries[slot],&entry,LIBRARY_KEY_FIELDS) != 0) {
+            memmove(&entries[slot + 1],&entries[slot],(number_of_entries - slot) * sizeof(library_entry));
+            number_of_entries += 1;
+        }
+
+        entries[slot] = entry;
+    }
+
+    // The boards that were saved are indexed even if a later one failed
+    const validate_message index_error = _write_library_index(directory,entries,number_of_entries);
+
+    free(entries);
+
+    return error != NULL ? error : index_error;
+}
+
+board_library open_board_library(const char *const directory, validate_message* error) {
+    board_library library = { 0 };
+
+    char* path = _library_path(directory,LIBRARY_INDEX_NAME);
+    const board_mapping index = _map_file(path);
+    free(path);
+
+    if(index.address == NULL) {
+        *error = "The library index could not be mapped!\n";
+        return library;
+    }
+
+    const library_file_header* header = index.address;
+    *error = NULL;
+
+    if(index.length < sizeof(library_file_header) || memcmp(header->magic,_magic,sizeof(_magic)) != 0) *error = "The file is not a library index!\n";
+    else if(header->byte_order != _BYTE_ORDER_MARK) *error = "The library index was saved with a different byte order!\n";
+    else if(header->version != LIBRARY_FILE_VERSION) *error = "The library index was saved by a different version!\n";
+    else if(header->number_of_entries > UINT_MAX || header->file_size != index.length || _index_file_size(header->number_of_entries) != index.length) *error = "The library index is truncated!\n";
+    else if(board_file_checksum((const unsigned char*) index.address + sizeof(library_file_header),index.length - sizeof(library_file_header)) != header->checksum) *error = "The library index is corrupt, its checksum does not match!\n";
+
+    if(*error != NULL) {
+        unmap_board_file(index);
+        return library;
+    }
+
+    const size_t directory_length = strlen(directory);
+    library.directory = malloc(directory_length + 1);
+
+    if(library.directory == NULL) {
+        perror("malloc has failed");
+        exit(1);
+    }
+
+    memcpy(library.directory,directory,directory_length + 1);
+
+    library.index = index;
+    library.number_of_entries = header->number_of_entries;
+    library.entries = (const library_entry*)((const unsigned char*) index.address + sizeof(library_file_header));
+
+    const uint32_t* permutations = (const uint32_t*)(library.entries + library.number_of_entries);
+
+    for(int metric = 0;metric < number_of_board_metrics;metric++) {
+        library.by_metric[metric] = permutations + (size_t) metric * library.number_of_entries;
+    }
+
+    return library;
+}
+
+void close_board_library(board_library library) {
+    unmap_board_file(library.index);
+    free(library.directory);
+}
+
+const library_entry* find_library_entry(const board_library library, const config config) {
+    const library_entry key = {
+        .number_of_players = config.number_of_players,
+        .difficulty = config.difficulty,
+        .seed = config.seed,
+        .parameters = generation_parameters_of(config),
+    };
+
+    const unsigned int slot = _lower_bound_entry(library.entries,library.number_of_entries,&key,LIBRARY_KEY_FIELDS,false);
+
+    if(slot == library.number_of_entries || _compare_entry_keys(&library.entries[slot],&key,LIBRARY_KEY_FIELDS) != 0) return NULL;
+
+    return &library.entries[slot];
+}
+
+unsigned int find_library_seed_entries(const board_library library, const config config, const library_entry** first) {
+    const library_entry key = {
+        .number_of_players = config.number_of_players,
+        .difficulty = config.difficulty,
+        .seed = config.seed,
+    };
+
+    // The boards of one seed only differ in their parameters, the last field of the key
+    const unsigned int begin = _lower_bound_entry(library.entries,library.number_of_entries,&key,3,false);
+    const unsigned int end = _lower_bound_entry(library.entries,library.number_of_entries,&key,3,true);
+
+    *first = library.entries + begin;
+
+    return end - begin;
+}
+
+unsigned int find_library_entries(const board_library library, const unsigned int number_of_players, const unsigned int difficulty, const library_entry** first) {
+    const library_entry key = {
+        .number_of_players = number_of_players,
+        .difficulty = difficulty,
+    };
+
+    // The entries of the configuration are consecutive, whatever their seed and parameters
+    const unsigned int begin = _lower_bound_entry(library.entries,library.number_of_entries,&key,2,false);
+    const unsigned int end = _lower_bound_entry(library.entries,library.number_of_entries,&key,2,true);
+
+    *first = library.entries + begin;
+
+    return end - begin;
+}
+
+const library_entry* closest_library_entry(const board_library library, const board_metric metric, const double target) {
+    if(library.number_of_entries == 0) return NULL;
+
+    const uint32_t* order = library.by_metric[metric];
+
+    // The first entry whose metric is not below the target
+    unsigned int low = 0;
+    unsigned int high = library.number_of_entries;
+
+    while(low < high) {
+        const unsigned int middle = low + (high - low) / 2;
+
+        if(library.entries[order[middle]].metrics[metric] < target) low = middle + 1;
+        else high = middle;
+    }
+
+    if(low == library.number_of_entries) return &library.entries[order[low - 1]];
+    if(low == 0) return &library.entries[order[0]];
+
+    const double above = library.entries[order[low]].metrics[metric] - target;
+    const double below = target - library.entries[order[low - 1]].metrics[metric];
+
+    return &library.entries[order[below <= above ? low - 1 : low]];
+}
+
+board load_library_board(const board_library library, const library_entry* entry, const bool verify_checksum, validate_message* error) {
+    char name[64];
+    _board_file_name(name,entry);
+
+    char* path = _library_path(library.directory,name);
+    const board board = load_board(path,verify_checksum,error);
+    free(path);
+
+    return board;
+}
+
+char* _library_path(const char *const directory, const char *const name) {
+    const size_t directory_length = strlen(directory);
+    const size_t name_length = strlen(name);
+
+    char* path = malloc(directory_length + 1 + name_length + 1);
+
+    if(path == NULL) {
+        perror("malloc has failed");
+        exit(1);
+    }
+
+    memcpy(path,directory,directory_length);
+    path[directory_length] = '/';
+    memcpy(path + directory_length + 1,name,name_length + 1);
+
+    return path;
+}
+
+void _board_file_name(char* name, const library_entry* entry) {
+    // Boards of the same seed generated with other parameters need files of their own
+    const uint64_t parameters = board_file_checksum(&entry->parameters,sizeof(generation_parameters));
+
+    snprintf(name,64,"%u-%u-%llu-%016llx.board",entry->number_of_players,entry->difficulty,(unsigned long long) entry->seed,(unsigned long long) parameters);
+}
+
+// Compares two parameters in the order of their fields
+static int _compare_parameters(const generation_parameters* left, const generation_parameters* right) {
+    const double left_fields[] = { left->board_size_base, left->board_size_growth, left->ladder_divisor, left->snake_divisor, left->players_modifier };
+    const double right_fields[] = { right->board_size_base, right->board_size_growth, right->ladder_divisor, right->snake_divisor, right->players_modifier };
+
+    for(size_t i = 0;i < sizeof(left_fields) / sizeof(double);i++) {
+        if(left_fields[i] != right_fields[i]) return left_fields[i] < right_fields[i] ? -1 : 1;
+    }
+
+    return 0;
+}
+
+int _compare_entry_keys(const library_entry* left, const library_entry* right, const unsigned int fields) {
+    if(left->number_of_players != right->number_of_players) return left->number_of_players < right->number_of_players ? -1 : 1;
+    if(fields > 1 && left->difficulty != right->difficulty) return left->difficulty < right->difficulty ? -1 : 1;
+    if(fields > 2 && left->seed != right->seed) return left->seed < right->seed ? -1 : 1;
+    if(fields > 3) return _compare_parameters(&left->parameters,&right->parameters);
+
+    return 0;
+}
+
+unsigned int _lower_bound_entry(const library_entry* entries, const unsigned int number_of_entries, const library_entry* key, const unsigned int fields, const bool past_equal) {
+    unsigned int low = 0;
+    unsigned int high = number_of_entries;
+
+    while(low < high) {
+        const unsigned int middle = low + (high - low) / 2;
+        const int order = _compare_entry_keys(&entries[middle],key,fields);
+
+        if(order < 0 || (past_equal && order == 0)) low = middle + 1;
+        else high = middle;
+    }
+
+    return low;
+}
+
+// A metric value with the entry it belongs to, sorted to build the permutation of a metric
+typedef struct _ranked_entry {
+    double value;
+    uint32_t entry;
+} _ranked_entry;
+
+static int _compare_ranked_entries(const void* a, const void* b) {
+    const _ranked_entry* left = a;
+    const _ranked_entry* right = b;
+
+    if(left->value != right->value) return left->value < right->value ? -1 : 1;
+
+    return (left->entry > right->entry) - (left->entry < right->entry);
+}
+
+validate_message _write_library_index(const char *const directory, const library_entry* entries, const unsigned int number_of_entries) {
+    const uint64_t file_size = _index_file_size(number_of_entries);
+
+    unsigned char* image = calloc(file_size,1);
+    _ranked_entry* ranked = malloc(((size_t) number_of_entries + 1) * sizeof(_ranked_entry));
+
+    if(image == NULL || ranked == NULL) {
+        perror("malloc has failed");
+        exit(1);
+    }
+
+    library_file_header header = {
+        .version = LIBRARY_FILE_VERSION,
+        .byte_order = _BYTE_ORDER_MARK,
+        .number_of_entries = number_of_entries,
+        .file_size = file_size,
+    };
+
+    memcpy(header.magic,_magic,sizeof(_magic));
+
+    unsigned char* out = image + sizeof(library_file_header);
+    memcpy(out,entries,(size_t) number_of_entries * sizeof(library_entry));
+    out += (size_t) number_of_entries * sizeof(library_entry);
+
+    for(int metric = 0;metric < number_of_board_metrics;metric++) {
+        for(unsigned int i = 0;i < number_of_entries;i++) {
+            ranked[i].value = entries[i].metrics[metric];
+            ranked[i].entry = i;
+        }
+
+        qsort(ranked,number_of_entries,sizeof(_ranked_entry),&_compare_ranked_entries);
+
+        for(unsigned int i = 0;i < number_of_entries;i++) {
+            memcpy(out,&ranked[i].entry,sizeof(uint32_t));
+            out += sizeof(uint32_t);
+        }
+    }
+
+    header.checksum = board_file_checksum(image + sizeof(library_file_header),file_size - sizeof(library_file_header));
+    memcpy(image,&header,sizeof(library_file_header));
+
+    char* path = _library_path(directory,LIBRARY_INDEX_NAME);
+    const validate_message error = _write_file_atomically(path,image,file_size);
+
+    free(path);
+    free(ranked);
+    free(image);
+
+    return error;
+}
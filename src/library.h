@@ -0,0 +1,174 @@
+/**
+ * @file CSnakeLadderLibrary.h
+ * @brief Header file containing the on-disk library of pregenerated Snake and Ladder boards.
+ *
+ * A board library is a directory of board files (see `save_board`) with one index file over them. The index is mapped like a board file and holds a `library_entry` per board, sorted by players, difficulty, seed and `generation_parameters`, plus one permutation of the entries per `board_metric`, sorted by that metric. Finding a board for a configuration, or the board closest to a wanted ladder count, total climb or expected game length, is therefore a binary search, and loading it is a `load_board`, so no board has to be generated when a game starts.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_LIBRARY_H
+#define CSNAKE_LADDER_LIBRARY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "board.h"
+#include "storage.h"
+#include "solver.h"
+
+/**
+ * @def LIBRARY_FILE_VERSION
+ * @brief The version of the index file format written by `add_to_board_library`.
+ */
+#define LIBRARY_FILE_VERSION 2
+
+/**
+ * @def LIBRARY_KEY_FIELDS
+ * @brief The number of fields of the key of a `library_entry`: players, difficulty, seed and parameters.
+ */
+#define LIBRARY_KEY_FIELDS 4
+
+/**
+ * @def LIBRARY_INDEX_NAME
+ * @brief The name of the index file inside the directory of a library.
+ */
+#define LIBRARY_INDEX_NAME "index"
+
+/**
+ * @brief Function to measure the `board_metric`s of a board.
+ *
+ * The expected number of turns comes from `solve_expected_turns`, the other metrics from the ladders and snakes.
+ *
+ * @param board The `board` structure representing the game board.
+ * @return The `library_entry` of the board.
+ */
+library_entry measure_board(const board board);
+
+/**
+ * @brief Function to add boards to a library, creating it if needed.
+ *
+ * Every board is saved to its own file, named after its configuration and parameters, and the index is rewritten once for the whole batch. A board whose configuration, seed and parameters are already in the library replaces the old one, a board generated from the same seed with other parameters is kept next to it.
+ *
+ * @param directory The directory of the library.
+ * @param boards Pointer to the boards to add.
+ * @param number_of_boards The number of boards.
+ * @return A message describing why the boards could not be added, or `NULL` on success.
+ */
+validate_message add_to_board_library(const char *const directory, const board* boards, const unsigned int number_of_boards);
+
+/**
+ * @brief Function to open a library by mapping its index.
+ *
+ * @param directory The directory of the library.
+ * @param error Pointer that receives a message describing why the library could not be opened, or `NULL` on success.
+ * @return The `board_library`. (Caller needs to release it with `close_board_library`)
+ */
+board_library open_board_library(const char *const directory, validate_message* error);
+
+/**
+ * @brief Unmaps the index of a library.
+ */
+void close_board_library(board_library library);
+
+/**
+ * @brief Function to find the board of a configuration, including its seed and `generation_parameters`.
+ *
+ * @param library The `board_library`.
+ * @param config The configuration.
+ * @return Pointer to the `library_entry`, or `NULL` if the library does not hold it.
+ */
+const library_entry* find_library_entry(const board_library library, const config config);
+
+/**
+ * @brief Function to find every board of a number of players, a difficulty and a seed, whatever its parameters.
+ *
+ * @param library The `board_library`.
+ * @param config The configuration, its `parameters` are ignored.
+ * @param first Pointer that receives the first of the entries, which are consecutive.
+ * @return The number of entries.
+ */
+unsigned int find_library_seed_entries(const board_library library, const config config, const library_entry** first);
+
+/**
+ * @brief Function to find every board of a number of players and a difficulty, whatever its seed and parameters.
+ *
+ * @param library The `board_library`.
+ * @param number_of_players The number of players.
+ * @param difficulty The difficulty.
+ * @param first Pointer that receives the first of the entries, which are consecutive.
+ * @return The number of entries.
+ */
+unsigned int find_library_entries(const board_library library, const unsigned int number_of_players, const unsigned int difficulty, const library_entry** first);
+
+/**
+ * @brief Function to find the board whose metric is closest to a target.
+ *
+ * @param library The `board_library`.
+ * @param metric The `board_metric` to compare.
+ * @param target The wanted value of the metric.
+ * @return Pointer to the `library_entry`, or `NULL` if the library is empty.
+ */
+const library_entry* closest_library_entry(const board_library library, const board_metric metric, const double target);
+
+/**
+ * @brief Function to load the board of a library entry. (See `load_board`)
+ *
+ * @param library The `board_library`.
+ * @param entry Pointer to the entry.
+ * @param verify_checksum Whether to verify the checksum of the board file.
+ * @param error Pointer that receives a message describing why the board could not be loaded, or `NULL` on success.
+ * @return The loaded `board`. (Caller needs to release it with `free_board`)
+ */
+board load_library_board(const board_library library, const library_entry* entry, const bool verify_checksum, validate_message* error);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief Function to build the path of a file in the directory of a library.
+ *
+ * @param directory The directory of the library.
+ * @param name The name of the file.
+ * @return The path. (Caller needs to release it with `free`)
+ */
+char* _library_path(const char *const directory, const char *const name);
+
+/**
+ * @brief Function to build the name of the board file of an entry, `<players>-<difficulty>-<seed>-<parameters>.board`, where `<parameters>` is the checksum of its `generation_parameters` in hexadecimal.
+ *
+ * @param name Pointer to at least 64 characters receiving the name.
+ * @param entry Pointer to the entry.
+ */
+void _board_file_name(char* name, const library_entry* entry);
+
+/**
+ * @brief Function to compare the first fields of the keys (players, difficulty, seed, parameters) of two entries.
+ *
+ * @param fields The number of fields to compare, `LIBRARY_KEY_FIELDS` for the whole key.
+ * @return A negative number, 0 or a positive number as `left` sorts before, with or after `right`.
+ */
+int _compare_entry_keys(const library_entry* left, const library_entry* right, const unsigned int fields);
+
+/**
+ * @brief Function to find the first entry whose key is not smaller than a key, comparing the first `fields` fields.
+ *
+ * @param entries Pointer to the entries, sorted by key.
+ * @param number_of_entries The number of entries.
+ * @param key Pointer to an entry holding the key.
+ * @param fields The number of fields to compare.
+ * @param past_equal Whether to skip the entries whose key is equal as well, to find the end of their range.
+ * @return The index of the entry, `number_of_entries` if every key is smaller.
+ */
+unsigned int _lower_bound_entry(const library_entry* entries, const unsigned int number_of_entries, const library_entry* key, const unsigned int fields, const bool past_equal);
+
+/**
+ * @brief Function to write the index file of a library.
+ *
+ * @param directory The directory of the library.
+ * @param entries Pointer to the entries, sorted by key.
+ * @param number_of_entries The number of entries.
+ * @return A message describing why the index could not be written, or `NULL` on success.
+ */
+validate_message _write_library_index(const char *const directory, const library_entry* entries, const unsigned int number_of_entries);
+
+#endif // CSNAKE_LADDER_LIBRARY_H
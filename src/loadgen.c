@@ -0,0 +1,335 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "types.h"
+#include "config.h"
+#include "board.h"
+#include "simulation.h"
+#include "timer.h"
+
+#if defined(__linux__)
+    # include <errno.h>
+    # include <unistd.h>
+    # include <netdb.h>
+    # include <sys/epoll.h>
+    # include <sys/socket.h>
+    # include <sys/un.h>
+    # include <netinet/in.h>
+    # include <netinet/tcp.h>
+#endif
+
+// Puts a game server (serve.c) under load from many concurrent clients and measures its turn latency.
+//
+// Usage: loadgen <address> [clients] [seconds] [players] [difficulty]
+//
+// Every client connects to `address` (as for serve.c), starts a game, rolls until it is won and starts the next
+// one, always waiting for the reply before it sends the next request. The time from a roll request to its reply
+// is the turn latency. Every won game is checked against `simulate_game` with the same board and dice, so the
+// server is known to play by the rules. All clients run in one thread; the exit status is 2 if any game did
+// not match.
+
+#define LOADGEN_DEFAULT_CLIENTS 1000
+#define LOADGEN_DEFAULT_SECONDS 10
+#define LOADGEN_DEFAULT_PLAYERS 4
+#define LOADGEN_DEFAULT_DIFFICULTY 2
+#define LOADGEN_LATENCY_BUCKETS 100000
+#define LOADGEN_REPLY_SIZE 256
+
+#if defined(__linux__)
+
+typedef struct loadgen_client {
+    int socket;
+    bool connected;
+    uint64_t seed;
+    uint64_t sent_at;
+    unsigned int rolls;
+    unsigned int reply_length;
+    char reply[LOADGEN_REPLY_SIZE];
+} loadgen_client;
+
+typedef struct loadgen_totals {
+    unsigned long long rolls;
+    unsigned long long games;
+    unsigned long long mismatched;
+    unsigned long long failed;
+    unsigned long long latency[LOADGEN_LATENCY_BUCKETS];
+} loadgen_totals;
+
+static unsigned int _players = LOADGEN_DEFAULT_PLAYERS;
+static unsigned int _difficulty = LOADGEN_DEFAULT_DIFFICULTY;
+
+static int _connect_to(const char *const address) {
+    int client = -1;
+
+    if(strncmp(address,"unix:",5) == 0) {
+        struct sockaddr_un remote = { .sun_family = AF_UNIX };
+        if(strlen(address + 5) >= sizeof(remote.sun_path)) return -1;
+        strcpy(remote.sun_path,address + 5);
+
+        client = socket(AF_UNIX,SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,0);
+
+        if(client >= 0 && connect(client,(const struct sockaddr*) &remote,sizeof(remote)) != 0 && errno != EINPROGRESS) {
+            close(client);
+            return -1;
+        }
+
+        return client;
+    }
+
+    char host[256] = "localhost";
+    const char* port = strrchr(address,':');
+
+    if(port == NULL) port = address;
+    else {
+        if((size_t)(port - address) >= sizeof(host)) return -1;
+        memcpy(host,address,port - address);
+        host[port - address] = '\0';
+        port += 1;
+    }
+
+    const struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM };
+    struct addrinfo* found = NULL;
+
+    if(getaddrinfo(host,port,&hints,&found) != 0 || found == NULL) return -1;
+
+    client = socket(found->ai_family,SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,0);
+
+    const int no_delay = 1;
+    if(client >= 0) setsockopt(client,IPPROTO_TCP,TCP_NODELAY,&no_delay,sizeof(no_delay));
+
+    if(client >= 0 && connect(client,found->ai_addr,found->ai_addrlen) != 0 && errno != EINPROGRESS) {
+        close(client);
+        client = -1;
+    }
+
+    freeaddrinfo(found);
+
+    return client;
+}
+
+static bool _send_request(loadgen_client* client, const char *const request) {
+    const size_t length = strlen(request);
+
+    client->sent_at = monotonic_nanoseconds();
+
+    // A request is far smaller than the socket buffer, so it is sent whole or not at all
+    return send(client->socket,request,length,MSG_NOSIGNAL) == (ssize_t) length;
+}
+
+static bool _start_game(loadgen_client* client) {
+    char request[64];
+
+    client->seed += 1;
+    client->rolls = 0;
+
+    snprintf(request,sizeof(request),"new %u %u %llu\n",_players,_difficulty,(unsigned long long) client->seed);
+
+    return _send_request(client,request);
+}
+
+static void _check_game(const loadgen_client* client, const unsigned int winner, loadgen_totals* totals) {
+    const config config = {
+        .number_of_players = _players,
+        .difficulty = _difficulty,
+        .seed = client->seed,
+    };
+
+    board board = generate_board_from_config(config);
+
+    // The server plays game 0 of the board
+    const simulation_options options = { 0 };
+    const game_result expected = simulate_game(board,rng_stream_seed(client->seed,1),options);
+
+    free_board(board);
+
+    totals->games += 1;
+
+    if(!expected.finished || expected.winner + 1 != winner || expected.rolls != client->rolls) totals->mismatched += 1;
+}
+
+// Handles one reply line, returns whether the client goes on
+static bool _handle_reply(loadgen_client* client, const char* reply, const bool sending, loadgen_totals* totals) {
+    if(strncmp(reply,"board ",6) == 0) return !sending || _send_request(client,"roll\n");
+
+    unsigned int player, roll, position, next;
+    char event;
+
+    if(sscanf(reply,"m %u %u %u %c %u",&player,&roll,&position,&event,&next) != 5) {
+        fprintf(stderr,"Unexpected reply: %s\n",reply);
+        return false;
+    }
+
+    const uint64_t latency = (monotonic_nanoseconds() - client->sent_at) / 1000;
+    totals->latency[latency < LOADGEN_LATENCY_BUCKETS ? latency : LOADGEN_LATENCY_BUCKETS - 1] += 1;
+    totals->rolls += 1;
+    client->rolls += 1;
+
+    if(event == 'w') {
+        _check_game(client,player,totals);
+        return !sending || _start_game(client);
+    }
+
+    return !sending || _send_request(client,"roll\n");
+}
+
+static unsigned long long _latency_percentile(const loadgen_totals* totals, const double fraction) {
+    const double wanted = fraction * totals->rolls;
+    unsigned long long seen = 0;
+
+    for(unsigned int bucket = 0;bucket < LOADGEN_LATENCY_BUCKETS;bucket++) {
+        seen += totals->latency[bucket];
+        if(seen != 0 && seen >= wanted) return bucket;
+    }
+
+    return LOADGEN_LATENCY_BUCKETS - 1;
+}
+
+int main(int argc, char** argv) {
+    if(argc < 2 || argc > 6) {
+        fprintf(stderr,"Usage: %s <address> [clients] [seconds] [players] [difficulty]\n",argv[0]);
+        return 1;
+    }
+
+    const char *const address = argv[1];
+    const unsigned int number_of_clients = argc > 2 ? (unsigned int) strtoul(argv[2],NULL,10) : LOADGEN_DEFAULT_CLIENTS;
+    const double seconds = argc > 3 ? strtod(argv[3],NULL) : LOADGEN_DEFAULT_SECONDS;
+    if(argc > 4) _players = (unsigned int) strtoul(argv[4],NULL,10);
+    if(argc > 5) _difficulty = (unsigned int) strtoul(argv[5],NULL,10);
+
+    validate_message message = ensure_players_within_1_10(_players);
+    if(message == NULL) message = ensure_difficulty_within_1_10(_difficulty);
+
+    if(message != NULL || number_of_clients < 1) {
+        fprintf(stderr,"%s",message != NULL ? message : "At least one client is needed!\n");
+        return 1;
+    }
+
+    loadgen_client* clients = calloc(number_of_clients,sizeof(loadgen_client));
+    loadgen_totals* totals = calloc(1,sizeof(loadgen_totals));
+    struct epoll_event* events = malloc(number_of_clients * sizeof(struct epoll_event));
+    const int epoll = epoll_create1(EPOLL_CLOEXEC);
+
+    if(clients == NULL || totals == NULL || events == NULL || epoll < 0) {
+        perror("Setting up the clients has failed");
+        return 1;
+    }
+
+    unsigned int open = 0;
+
+    for(unsigned int i = 0;i < number_of_clients;i++) {
+        loadgen_client* client = clients + i;
+
+        // Every client plays its own seeds
+        client->seed = (uint64_t) i << 32;
+        client->socket = _connect_to(address);
+
+        struct epoll_event watched = { .events = EPOLLIN | EPOLLOUT, .data.u32 = i };
+
+        if(client->socket < 0 || epoll_ctl(epoll,EPOLL_CTL_ADD,client->socket,&watched) != 0) {
+            totals->failed += 1;
+            if(client->socket >= 0) close(client->socket);
+            client->socket = -1;
+            continue;
+        }
+
+        open += 1;
+    }
+
+    const uint64_t started = monotonic_nanoseconds();
+    const uint64_t deadline = started + (uint64_t)(seconds * 1e9);
+
+    // Once the time is up no new requests are sent, and the clients are closed as their last replies come in
+    while(open > 0) {
+        const uint64_t now = monotonic_nanoseconds();
+        const bool sending = now < deadline;
+        const int timeout = sending ? (int)((deadline - now) / 1000000 + 1) : 1000;
+
+        const int ready = epoll_wait(epoll,events,(int) number_of_clients,timeout);
+
+        if(ready < 0 && errno != EINTR) {
+            perror("epoll_wait has failed");
+            return 1;
+        }
+
+        // Nothing came back for a second after the end, the rest of the replies are lost
+        if(ready == 0 && !sending) break;
+
+        for(int e = 0;e < ready;e++) {
+            loadgen_client* client = clients + events[e].data.u32;
+            if(client->socket < 0) continue;
+
+            bool going = (events[e].events & (EPOLLERR | EPOLLHUP)) == 0;
+
+            if(going && !client->connected && (events[e].events & EPOLLOUT) != 0) {
+                // Connected, from now on only replies are waited for
+                struct epoll_event watched = { .events = EPOLLIN, .data.u32 = events[e].data.u32 };
+                epoll_ctl(epoll,EPOLL_CTL_MOD,client->socket,&watched);
+
+                client->connected = true;
+                going = sending && _start_game(client);
+            }
+            else if(going && (events[e].events & EPOLLIN) != 0) {
+                const ssize_t length = read(client->socket,client->reply + client->reply_length,LOADGEN_REPLY_SIZE - 1 - client->reply_length);
+
+                going = length > 0;
+                if(going) client->reply_length += (unsigned int) length;
+                client->reply[client->reply_length] = '\0';
+
+                char* newline;
+
+                // One request is outstanding at a time, so at most one reply is in the buffer
+                while(going && (newline = strchr(client->reply,'\n')) != NULL) {
+                    *newline = '\0';
+
+                    going = _handle_reply(client,client->reply,sending,totals);
+
+                    client->reply_length -= (unsigned int)(newline + 1 - client->reply);
+                    memmove(client->reply,newline + 1,client->reply_length + 1);
+
+                    // A client that was not told to go on is done
+                    if(!sending) going = false;
+                }
+            }
+
+            if(!going) {
+                if(sending) totals->failed += 1;
+
+                close(client->socket);
+                client->socket = -1;
+                open -= 1;
+            }
+        }
+    }
+
+    const double elapsed = (monotonic_nanoseconds() - started) / 1e9;
+
+    printf("%u clients, %llu failed: %llu rolls (%.0f per second), %llu games checked, %llu mismatched\n",
+        number_of_clients,totals->failed,totals->rolls,totals->rolls / elapsed,totals->games,totals->mismatched
+    );
+
+    printf("turn latency: p50 %lluus, p99 %lluus, p99.9 %lluus\n",
+        _latency_percentile(totals,0.5),_latency_percentile(totals,0.99),_latency_percentile(totals,0.999)
+    );
+
+    for(unsigned int i = 0;i < number_of_clients;i++) {
+        if(clients[i].socket >= 0) close(clients[i].socket);
+    }
+
+    const bool matched = totals->mismatched == 0;
+
+    close(epoll);
+    free(events);
+    free(totals);
+    free(clients);
+
+    return matched ? 0 : 2;
+}
+
+#else
+
+int main(void) {
+    fprintf(stderr,"The load generator needs Linux!\n");
+    return 1;
+}
+
+#endif
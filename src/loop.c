@@ -0,0 +1,149 @@
+#include "loop.h"
+
+#ifdef _WIN32
+    # include <windows.h>
+    # include <conio.h>
+#else
+    # include <poll.h>
+    # include <unistd.h>
+#endif
+
+// The most input read in one go
+#define _INPUT_CHUNK 64
+
+event_loop create_event_loop() {
+    event_loop loop = {
+        .input = -1,
+        .on_input = NULL,
+        .input_context = NULL,
+        .running = false,
+    };
+
+    for(unsigned int timer = 0;timer < EVENT_LOOP_MAXIMUM_TIMERS;timer++) {
+        loop.timers[timer].active = false;
+    }
+
+    return loop;
+}
+
+unsigned int add_timer(event_loop* loop, const uint64_t delay, timer_callback callback, void* context) {
+    for(unsigned int timer = 0;timer < EVENT_LOOP_MAXIMUM_TIMERS;timer++) {
+        if(loop->timers[timer].active) continue;
+
+        const loop_timer pending = {
+            .deadline = monotonic_nanoseconds() + delay,
+            .callback = callback,
+            .context = context,
+            .active = true,
+        };
+
+        loop->timers[timer] = pending;
+
+        return timer;
+    }
+
+    fprintf(stderr,"Too many timers, at most %d can be pending\n",EVENT_LOOP_MAXIMUM_TIMERS);
+    exit(1);
+}
+
+void cancel_timer(event_loop* loop, const unsigned int timer) {
+    if(timer < EVENT_LOOP_MAXIMUM_TIMERS) loop->timers[timer].active = false;
+}
+
+void watch_input(event_loop* loop, const int input, input_callback callback, void* context) {
+    loop->input = input;
+    loop->on_input = callback;
+    loop->input_context = context;
+}
+
+void run_event_loop(event_loop* loop) {
+    loop->running = true;
+
+    while(loop->running) {
+        TRACE_BEGIN(timers);
+        const uint64_t next_deadline = _run_due_timers(loop,monotonic_nanoseconds());
+        TRACE_END(span_run_timers,timers);
+
+        if(!loop->running) break;
+
+        // Nothing can happen any more
+        if(next_deadline == UINT64_MAX && loop->input < 0) break;
+
+        TRACE_BEGIN(wait);
+        _wait_for_input(loop,monotonic_nanoseconds(),next_deadline);
+        TRACE_END(span_wait_for_input,wait);
+    }
+
+    loop->running = false;
+}
+
+void stop_event_loop(event_loop* loop) {
+    loop->running = false;
+}
+
+uint64_t _run_due_timers(event_loop* loop, const uint64_t now) {
+    while(loop->running) {
+        unsigned int earliest = NO_TIMER;
+
+        for(unsigned int timer = 0;timer < EVENT_LOOP_MAXIMUM_TIMERS;timer++) {
+            if(!loop->timers[timer].active) continue;
+
+            if(earliest == NO_TIMER || loop->timers[timer].deadline < loop->timers[earliest].deadline) earliest = timer;
+        }
+
+        if(earliest == NO_TIMER) return UINT64_MAX;
+
+        // Timers added by a callback are due after `now`, so they wait for the next iteration and input is polled in between
+        if(loop->timers[earliest].deadline > now) return loop->timers[earliest].deadline;
+
+        loop->timers[earliest].active = false;
+        TRACE_COUNT(counter_timers_fired);
+        loop->timers[earliest].callback(loop->timers[earliest].context);
+    }
+
+    return UINT64_MAX;
+}
+
+void _wait_for_input(event_loop* loop, const uint64_t now, const uint64_t deadline) {
+    // Round up, so that a timer is never woken up just before it is due
+    const uint64_t wait = deadline == UINT64_MAX ? UINT64_MAX : deadline > now ? (deadline - now + 999999) / 1000000 : 0;
+
+    char input[_INPUT_CHUNK];
+    long length = -1;
+
+#ifdef _WIN32
+    // Console input cannot be polled, so check the keyboard and sleep in short steps instead
+    const uint64_t started = monotonic_nanoseconds();
+
+    do {
+        if(loop->input >= 0 && _kbhit()) {
+            length = 0;
+            while(length < _INPUT_CHUNK && _kbhit()) input[length++] = (char) _getch();
+            break;
+        }
+
+        if(wait == 0) break;
+
+        Sleep(wait < 10 ? (DWORD) wait : 10);
+    } while(wait == UINT64_MAX || monotonic_nanoseconds() - started < wait * 1000000);
+#else
+    struct pollfd watched = {
+        .fd = loop->input,
+        .events = POLLIN,
+    };
+
+    // A negative descriptor is ignored by poll, which then only sleeps
+    const int timeout = wait == UINT64_MAX ? -1 : wait > INT_MAX ? INT_MAX : (int) wait;
+
+    if(poll(&watched,1,timeout) > 0 && (watched.revents & (POLLIN | POLLHUP)) != 0) {
+        length = read(loop->input,input,_INPUT_CHUNK);
+    }
+#endif
+
+    if(length < 0) return;
+
+    // The end of the input, stop watching it
+    if(length == 0) loop->input = -1;
+
+    loop->on_input(loop->input_context,input,length);
+}
@@ -0,0 +1,94 @@
+/**
+ * @file CSnakeLadderLoop.h
+ * @brief Header file containing the event loop of the interactive game.
+ *
+ * This header file defines functions for an `event_loop` that calls timers from the monotonic clock and reads input as soon as it arrives, without ever blocking on either. Between events it waits for input with a timeout set by the next timer, so an idle game costs nothing, and a timer with no delay runs on the very next iteration.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_LOOP_H
+#define CSNAKE_LADDER_LOOP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "types.h"
+#include "timer.h"
+#include "trace.h"
+
+/**
+ * @def NO_TIMER
+ * @brief The timer id that never refers to a pending timer.
+ */
+#define NO_TIMER UINT_MAX
+
+/**
+ * @brief Function to create an event loop without timers or input.
+ *
+ * @return The `event_loop`.
+ */
+event_loop create_event_loop();
+
+/**
+ * @brief Function to schedule a call after a delay.
+ *
+ * @param loop Pointer to the event loop.
+ * @param delay The delay in nanoseconds, 0 to call it on the next iteration.
+ * @param callback The function to call.
+ * @param context The context to call `callback` with.
+ * @return The id of the timer, to pass to `cancel_timer`.
+ */
+unsigned int add_timer(event_loop* loop, const uint64_t delay, timer_callback callback, void* context);
+
+/**
+ * @brief Cancels a pending timer. Cancelling `NO_TIMER` or a timer that has already been called does nothing.
+ *
+ * @param loop Pointer to the event loop.
+ * @param timer The id returned by `add_timer`.
+ */
+void cancel_timer(event_loop* loop, const unsigned int timer);
+
+/**
+ * @brief Starts passing the input of a file descriptor to a callback.
+ *
+ * @param loop Pointer to the event loop.
+ * @param input The file descriptor to read, usually 0 (standard input).
+ * @param callback The function to call with every piece of input.
+ * @param context The context to call `callback` with.
+ */
+void watch_input(event_loop* loop, const int input, input_callback callback, void* context);
+
+/**
+ * @brief Runs the loop until `stop_event_loop` is called, or until no timer is pending and no input is watched.
+ *
+ * @param loop Pointer to the event loop.
+ */
+void run_event_loop(event_loop* loop);
+
+/**
+ * @brief Makes `run_event_loop` return once the current callback is done.
+ *
+ * @param loop Pointer to the event loop.
+ */
+void stop_event_loop(event_loop* loop);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief Calls every timer whose deadline has passed, earliest first.
+ *
+ * @param loop Pointer to the event loop.
+ * @param now The current monotonic time in nanoseconds.
+ * @return The deadline of the earliest timer still pending, or `UINT64_MAX` if there is none.
+ */
+uint64_t _run_due_timers(event_loop* loop, const uint64_t now);
+
+/**
+ * @brief Waits for input until a deadline and passes whatever arrived to the input callback.
+ *
+ * @param loop Pointer to the event loop.
+ * @param now The current monotonic time in nanoseconds.
+ * @param deadline The monotonic time to wait until at most, or `UINT64_MAX` to wait for input only.
+ */
+void _wait_for_input(event_loop* loop, const uint64_t now, const uint64_t deadline);
+
+#endif // CSNAKE_LADDER_LOOP_H
@@ -1,146 +1,207 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-#ifdef __unix__
-    # include <unistd.h>
-#elif defined _WIN32
-    # include <windows.h>
-#define sleep(x) Sleep(1000 * (x))
-#endif
-
 #include "types.h"
 #include "config.h"
 #include "board.h"
+#include "game.h"
+#include "rng.h"
+#include "render.h"
+#include "loop.h"
+#include "library.h"
+#include "replay.h"
+
+// Usage: main [animation milliseconds] [seed] [library]
+//
+// The dice animation shows a frame every `animation milliseconds` (1000 by default). With 0 the very same
+// game runs at full speed, as the animation never touches the dice. Pressing Enter rolls at once, q quits.
+//
+// With a `library` (see librarian.c) the board is picked from the pregenerated boards of the configuration
+// instead of being generated, and the game takes over its seed, so the printed seed still reproduces it.
+//
+// Built with -DCSNAKE_TRACE, the instrumentation of the generator and the game loop is printed to stderr
+// when the game ends, and written as a Chrome trace to the file named by $CSNAKE_TRACE_EVENTS.
+//
+// With $CSNAKE_REPLAY_LOG set, the board and every roll of the game are appended to that replay log
+// (see replay.h), which replayer.c plays back.
+
+#define DEFAULT_ANIMATION_MILLISECONDS 1000
+
+// The number of frames of the dice animation, the dice are rolled once the last one has been shown
+#define DICE_ANIMATION_FRAMES 4
+
+void start_rolling(interactive_game* play);
+
+void show_rolling_frame(const unsigned int current_player,const unsigned int frame) {
+    printf ( "\rPlayer %u is rolling%.*s   \b\b\b",current_player + 1, frame, "...");
+    fflush (stdout); //force printing as no newline in output
+}
+
+void finish_roll(interactive_game* play) {
+    const unsigned int current_player = play->game.current_player;
+    const unsigned int roll = _random_between(&play->dice,1,6);
+
+    printf("\r Player %u has rolled a %u \n",current_player + 1,roll);
+
+    record_replay_roll(&play->log,roll);
+
+    const turn_outcome outcome = game_apply_roll(&play->game,roll);
 
-unsigned int player_is_rolling(const unsigned int current_player) {
-    for (unsigned int each = 0; each < 4; ++each) {
-        printf ( "\rPlayer %u is rolling%.*s   \b\b\b",current_player + 1, each, "...");
-        fflush (stdout); //force printing as no newline in output
-        sleep(1);
+    if(outcome == turn_over || outcome == three_sixes) record_replay_turn(&play->log);
+
+    switch (outcome) {
+        case three_sixes:
+            printf("Three consecutive sixes! Move invalidated.\n");
+            break;
+        case game_won:
+            printf("Player %u has won the game!\n",current_player + 1);
+            break;
+        default:
+            if(play->game.last_move == move_past_finish) printf("This move would take you past the finish line. Hence your move is invalidated\n");
+            break;
     }
 
-    const unsigned int roll = _random_between(1,6);
-    
-    printf("\r Player %u has rolled a %u \n",current_player,roll);
+    if(play->game.finished) {
+        render_board(&play->renderer,play->game.board);
+        stop_event_loop(&play->loop);
+        return;
+    }
 
-    return roll;
+    start_rolling(play);
 }
 
-void move_player(board board,const unsigned roll ,const unsigned int current_player) {
-    player* element = board.players + current_player;
+void animate_dice(void* context) {
+    interactive_game* play = context;
 
-    const unsigned int x0 = element->position_x;
-    const unsigned int x1 = x0 + roll;
+    play->frame += 1;
+    play->animation_timer = NO_TIMER;
 
-    const unsigned int board_size_minus_1 =  board.board_size - 1;
+    if(play->frame == DICE_ANIMATION_FRAMES) {
+        finish_roll(play);
+        return;
+    }
 
-    // Ensure that the new positions are in bounds of the board
-    if(x1 > board_size_minus_1) {
-        // If the player is at the end of the board (reached the final position), 
-        // and the sum of their current position and the roll value exceeds the total number of spaces on the board, 
-        // then invalidate the roll.
-        if(element->position_y == board_size_minus_1) {
-            printf("This move would take you past the finish line. Hence your move is invalidated");
-            return;
-        } else {
-            element->position_x = board_size_minus_1;
-            element->position_y += 1;
-        }
+    show_rolling_frame(play->game.current_player,play->frame);
+    play->animation_timer = add_timer(&play->loop,play->frame_delay,&animate_dice,play);
+}
 
-    
-    } else element->position_x = x1;
+void start_rolling(interactive_game* play) {
+    // A new turn starts whenever the previous roll was not a six
+    if(play->game.consecutive_sixes == 0) {
+        render_board(&play->renderer,play->game.board);
 
-    switch (board.inner_board[element->position_x][element->position_y]->role){
-        case is_ladder_start :
-            // TODO :Move current player
-            break;
-        case is_snake_head :
-            // TODO : Move current player
-            break;
-        default: break;
+        printf("Round %u\n",play->game.round);
     }
+
+    play->frame = 0;
+    show_rolling_frame(play->game.current_player,play->frame);
+    play->animation_timer = add_timer(&play->loop,play->frame_delay,&animate_dice,play);
 }
 
-unsigned int number_of_digits(const unsigned int number) {
-    if (number < 10) return 1;
-    if (number < 100) return 2;
-    if (number < 1000) return 3;
-    if (number < 10000) return 4;
+void on_input(void* context,const char* input,const size_t length) {
+    interactive_game* play = context;
 
-    // This should not be reached
+    for(size_t i = 0;i < length;i++) {
+        if(input[i] == 'q') {
+            stop_event_loop(&play->loop);
+            return;
+        }
+    }
+
+    // Any other input skips the rest of the animation
+    if(length != 0 && play->animation_timer != NO_TIMER) {
+        cancel_timer(&play->loop,play->animation_timer);
+        play->animation_timer = NO_TIMER;
+        finish_roll(play);
+    }
 }
 
-void print_board(const board board) {
-    const unsigned int board_size_minus_1 = board.board_size - 1;
-    const unsigned int maximum_number_of_digits = number_of_digits(board.inner_board[board_size_minus_1][board_size_minus_1]->label);
-    // so "| $ N $ |"
-    const unsigned int recommended_length_per_cell = maximum_number_of_digits + 8;
+board board_from_library(const char *const directory,config* config) {
+    validate_message error;
+    const board_library library = open_board_library(directory,&error);
 
-    const size_t buffer_size = recommended_length_per_cell * board_size_minus_1;
-    char string_buffer[buffer_size];
+    if(error == NULL) {
+        const library_entry* first;
+        const unsigned int count = find_library_entries(library,config->number_of_players,config->difficulty,&first);
 
-    for(unsigned int i = 0;i < buffer_size;i++) {
-        string_buffer[i] = '-';
-    }
+        if(count != 0) {
+            // The seed picks the board, and the board's seed and parameters are used from then on
+            const library_entry* entry = first + config->seed % count;
+            const board board = load_library_board(library,entry,false,&error);
 
-    for(int row = board.board_size - 1;row >= 0;row--) {
-        for(int col = 0;col < board.board_size;col++) {
-            const unsigned int label = board.inner_board[row][col]->label;
-            const unsigned int padding = (recommended_length_per_cell - number_of_digits(label)) / 2;
-
-            printf(
-                "|%*s%u%*s|",
-                padding," ",
-                label,
-                padding," "
-            );
-        }
+            close_board_library(library);
 
-        if(row != 0) printf("%s",string_buffer);
+            if(error == NULL) {
+                config->seed = board.config.seed;
+                config->parameters = board.config.parameters;
+                return board;
+            }
+        } else {
+            close_board_library(library);
+            error = "The library has no board for this configuration, generating one\n";
+        }
     }
+
+    fprintf(stderr,"%s",error);
+
+    return generate_board_from_config(*config);
 }
 
+int main(int argc,char** argv) {
+    const unsigned long animation_milliseconds = argc > 1 ? strtoul(argv[1],NULL,10) : DEFAULT_ANIMATION_MILLISECONDS;
 
-int main() {
     printf("Snake and Ladder Game\n");
     
     config config = receive_config_from_user();
 
+    if(argc > 2) config.seed = strtoull(argv[2],NULL,10);
+
     // Add bot player if single player
     if(config.number_of_players == 1) config.number_of_players += 1;
 
-    board board = generate_board_from_config(config);
+    trace_begin_session(getenv(TRACE_EVENTS_VARIABLE));
 
-    unsigned int round = 0;
-    unsigned int current_player = 0;
+    const board board = argc > 3 ? board_from_library(argv[3],&config) : generate_board_from_config(config);
 
-    while(true) {
-        printf("Round %u\n",round);
-       
-        print_board(board);
+    const char *const log_path = getenv(REPLAY_LOG_VARIABLE);
+    validate_message error = NULL;
 
-        // Keep on rolling if get 6s, but invalidate move for 3 consecutive sixes
-        unsigned int roll , consecutive_sixes = 0;
-        do {
-            roll = player_is_rolling(current_player);
+    const replay_writer log = log_path != NULL && *log_path != '\0' ? open_replay_log(log_path,&error) : (replay_writer) { 0 };
+    if(error != NULL) fprintf(stderr,"%s",error);
 
-            if(roll == 6) consecutive_sixes += 1;
+    interactive_game play = {
+        .game = new_game(board,board.players),
+        .renderer = create_renderer(board,1),
+        // The dice use their own stream of the seed
+        .dice = rng_for_stream(config.seed,1),
+        .loop = create_event_loop(),
+        .frame_delay = (uint64_t) animation_milliseconds * 1000000,
+        .animation_timer = NO_TIMER,
+        .log = log,
+    };
 
-            if(consecutive_sixes == 3){
-                printf("Three consecutive sixes! Move invalidated.\n");
-                break;
-            }
-            else move_player(board,roll,current_player);
-        }while(roll == 6);
-
-        // Update Round and Player
-        if(current_player == config.number_of_players - 1) {
-            round += 1;
-            current_player = 0;
-        } else current_player += 1;
-    }
+    // Only a board that was mapped from a file came from the library, one that was not found is generated
+    begin_replay_game(&play.log,board,board.mapping.address != NULL);
+
+    // The first frame clears the screen, everything printed from here on scrolls below the board
+    render_board(&play.renderer,board);
+
+    // Printing the seed lets a game be reproduced exactly
+    printf("Seed %llu\n",(unsigned long long) config.seed);
+
+    watch_input(&play.loop,0,&on_input,&play);
+    start_rolling(&play);
+    run_event_loop(&play.loop);
+
+    // Won or quit, the game is over either way
+    end_replay_game(&play.log);
+    close_replay_log(play.log);
+
+    free_renderer(play.renderer);
+
+    trace_end_session(stderr);
 
     free_board(board);
     
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "types.h"
+#include "campaign.h"
+
+// Merges the shard files written by the workers of a simulation campaign, see worker.c.
+//
+// Usage: merger <merged file> <shard file>...
+//
+// The shard files may be given in any order, but have to belong to the same campaign and together cover every
+// game of it exactly once. The merged result is written to `merged file` (`-` to only print it); it is the very
+// file a single `worker 0 1` would have written for the whole campaign. A summary of the campaign is printed to
+// stdout.
+
+int main(int argc, char** argv) {
+    if(argc < 3) {
+        fprintf(stderr,"Usage: %s <merged file> <shard file>...\n",argv[0]);
+        return 1;
+    }
+
+    const char *const merged_path = argv[1];
+    const unsigned int number_of_results = (unsigned int)(argc - 2);
+
+    // One more for the merged result
+    shard_result* results = malloc((number_of_results + 1) * sizeof(shard_result));
+
+    if(results == NULL) {
+        perror("malloc has failed");
+        return 1;
+    }
+
+    for(unsigned int i = 0;i < number_of_results;i++) {
+        const validate_message error = load_shard_result(argv[i + 2],&results[i]);
+
+        if(error != NULL) {
+            fprintf(stderr,"%s: %s",argv[i + 2],error);
+            free(results);
+            return 1;
+        }
+    }
+
+    shard_result* merged = results + number_of_results;
+    validate_message error = merge_shard_results(results,number_of_results,merged);
+
+    if(error == NULL && strcmp(merged_path,"-") != 0) error = save_shard_result(merged,merged_path);
+
+    if(error != NULL) {
+        fprintf(stderr,"%s",error);
+        free(results);
+        return 1;
+    }
+
+    const campaign campaign = merged->campaign;
+
+    printf("players=%u difficulty=%u first_seed=%llu seeds=%llu games_per_seed=%u shards=%u games=%llu finished=%llu",
+        campaign.number_of_players,campaign.difficulty,(unsigned long long) campaign.first_seed,(unsigned long long) campaign.number_of_seeds,
+        campaign.games_per_seed,number_of_results,(unsigned long long) merged->games,(unsigned long long) merged->finished_games
+    );
+
+    if(merged->games != 0) {
+        printf(" mean_rounds=%.3f min_rounds=%u median_rounds=%u p90_rounds=%u p99_rounds=%u max_rounds=%u ladder_hits_per_game=%.3f snake_hits_per_game=%.3f",
+            (double) merged->total_rounds / merged->games,merged->minimum_rounds,
+            shard_result_percentile(merged,0.5),shard_result_percentile(merged,0.9),shard_result_percentile(merged,0.99),merged->maximum_rounds,
+            (double) merged->total_ladder_hits / merged->games,(double) merged->total_snake_hits / merged->games
+        );
+    }
+
+    printf(" wins=");
+    for(unsigned int player = 0;player < campaign.number_of_players;player++) {
+        printf(player == 0 ? "%llu" : ",%llu",(unsigned long long) merged->wins[player]);
+    }
+    putchar('\n');
+
+    free(results);
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "occupancy.h"
+
+occupancy_grid create_occupancy_grid(const unsigned int board_size) {
+    uint64_t* words = malloc(occupancy_grid_words(board_size) * sizeof(uint64_t));
+
+    if(words == NULL) {
+        perror("malloc has failed");
+        exit(1);
+    }
+
+    return create_occupancy_grid_in(board_size,words);
+}
+
+occupancy_grid create_occupancy_grid_in(const unsigned int board_size, uint64_t* words) {
+    memset(words,0,occupancy_grid_words(board_size) * sizeof(uint64_t));
+
+    const occupancy_grid grid = {
+        .board_size = board_size,
+        .words_per_row = occupancy_words_per_row(board_size),
+        .words = words,
+    };
+
+    return grid;
+}
+
+void free_occupancy_grid(occupancy_grid grid) {
+    free(grid.words);
+}
+
+void occupancy_free_neighbourhoods(const occupancy_grid grid, const unsigned int y, uint64_t* free_cells) {
+    const unsigned int words_per_row = grid.words_per_row;
+
+    const uint64_t* below = grid.words + (size_t) y * words_per_row;
+    const uint64_t* row = below + words_per_row;
+    const uint64_t* above = row + words_per_row;
+
+    // First the vertical neighbours, which line up word for word
+    unsigned int w = 0;
+
+#if defined(__SSE2__)
+    for(;w + 2 <= words_per_row;w += 2) {
+        const __m128i vertical = _mm_or_si128(
+            _mm_loadu_si128((const __m128i*)(below + w)),
+            _mm_loadu_si128((const __m128i*)(above + w))
+        );
+
+        _mm_storeu_si128((__m128i*)(free_cells + w),vertical);
+    }
+#endif
+
+    for(;w < words_per_row;w++) {
+        free_cells[w] = below[w] | above[w];
+    }
+
+    // Then the cell itself and its left and right neighbours, carrying bits across word boundaries
+    const unsigned int first_column_bit = 1;
+    const unsigned int last_column_bit = grid.board_size;
+
+    for(w = 0;w < words_per_row;w++) {
+        const uint64_t previous = w > 0 ? row[w - 1] : 0;
+        const uint64_t next = w + 1 < words_per_row ? row[w + 1] : 0;
+
+        const uint64_t from_left = (row[w] << 1) | (previous >> 63);
+        const uint64_t from_right = (row[w] >> 1) | (next << 63);
+
+        // Only the bits of real columns can be free
+        const unsigned int word_first_bit = w * 64;
+        const unsigned int word_last_bit = word_first_bit + 63;
+        uint64_t valid = 0;
+
+        if(word_first_bit <= last_column_bit && word_last_bit >= first_column_bit) {
+            const unsigned int low = (first_column_bit > word_first_bit ? first_column_bit : word_first_bit) - word_first_bit;
+            const unsigned int high = (last_column_bit < word_last_bit ? last_column_bit : word_last_bit) - word_first_bit;
+            const unsigned int count = high - low + 1;
+
+            valid = (count == 64 ? ~UINT64_C(0) : (UINT64_C(1) << count) - 1) << low;
+        }
+
+        free_cells[w] = ~(free_cells[w] | row[w] | from_left | from_right) & valid;
+    }
+}
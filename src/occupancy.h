@@ -0,0 +1,145 @@
+/**
+ * @file CSnakeLadderOccupancy.h
+ * @brief Header file containing the packed occupancy grids of Snake and Ladder boards.
+ *
+ * This header file defines functions for one-bit-per-cell grids (see `occupancy_grid`). Checking a neighbourhood or a stretch of a row becomes a shift and a mask on a 64-bit word instead of loading one `board_cell` per cell.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_OCCUPANCY_H
+#define CSNAKE_LADDER_OCCUPANCY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+    # include <emmintrin.h>
+#endif
+
+#include "types.h"
+
+/**
+ * @brief Function to create an empty grid for a board.
+ *
+ * @param board_size The size of the board (number of squares on each side).
+ * @return The `occupancy_grid`. (Caller needs to release it with `free_occupancy_grid`)
+ */
+occupancy_grid create_occupancy_grid(const unsigned int board_size);
+
+/**
+ * @brief Function to create an empty grid in memory provided by the caller, e.g. carved from an `arena`.
+ *
+ * @param board_size The size of the board (number of squares on each side).
+ * @param words Pointer to `occupancy_grid_words(board_size)` words, which are cleared.
+ * @return The `occupancy_grid`, which must not be passed to `free_occupancy_grid`.
+ */
+occupancy_grid create_occupancy_grid_in(const unsigned int board_size, uint64_t* words);
+
+/**
+ * @brief Returns the number of words in a row of a grid for a board of `board_size`.
+ */
+static inline unsigned int occupancy_words_per_row(const unsigned int board_size) {
+  // One padding column on each side, plus the spare word that lets `occupancy_window` read past the last column
+  return (board_size + 2 + 63) / 64 + 1;
+}
+
+/**
+ * @brief Returns the number of words a grid for a board of `board_size` occupies.
+ */
+static inline size_t occupancy_grid_words(const unsigned int board_size) {
+  // One padding row above and below
+  return (size_t)(board_size + 2) * occupancy_words_per_row(board_size);
+}
+
+/**
+ * @brief Frees the memory allocated for an `occupancy_grid`.
+ */
+void free_occupancy_grid(occupancy_grid grid);
+
+/**
+ * @brief Function to compute which cells of a row are free together with their four neighbours.
+ *
+ * The row and the rows around it are combined a word at a time (two words at a time with SSE2).
+ *
+ * @param grid The grid.
+ * @param y The row (0 to `board_size - 1`).
+ * @param free_cells Pointer to `grid.words_per_row` words, filled like a padded row: bit `x + 1` is set when cell (x, y) and its neighbours are clear. Padding bits are never set.
+ */
+void occupancy_free_neighbourhoods(const occupancy_grid grid, const unsigned int y, uint64_t* free_cells);
+
+/**
+ * @brief Returns the word holding the padded bit of column `x` of row `y`.
+ */
+static inline uint64_t* _occupancy_word(const occupancy_grid grid, const unsigned int x, const unsigned int y) {
+  return grid.words + (size_t)(y + 1) * grid.words_per_row + (x + 1) / 64;
+}
+
+/**
+ * @brief Marks cell (x, y) in a grid.
+ */
+static inline void occupancy_set(const occupancy_grid grid, const unsigned int x, const unsigned int y) {
+  *_occupancy_word(grid, x, y) |= UINT64_C(1) << ((x + 1) % 64);
+}
+
+/**
+ * @brief Clears cell (x, y) in a grid.
+ */
+static inline void occupancy_clear(const occupancy_grid grid, const unsigned int x, const unsigned int y) {
+  *_occupancy_word(grid, x, y) &= ~(UINT64_C(1) << ((x + 1) % 64));
+}
+
+/**
+ * @brief Checks whether cell (x, y) is marked in a grid.
+ */
+static inline bool occupancy_test(const occupancy_grid grid, const unsigned int x, const unsigned int y) {
+  return (*_occupancy_word(grid, x, y) >> ((x + 1) % 64)) & 1;
+}
+
+/**
+ * @brief Returns the 64 bits of a padded row starting at a padded bit.
+ *
+ * @param grid The grid.
+ * @param bit The padded bit to start at, i.e. column `bit - 1`.
+ * @param row The padded row, i.e. board row `row - 1`. Rows 0 and `board_size + 1` are the padding.
+ * @return The bits, with the one at `bit` in the least significant position.
+ */
+static inline uint64_t occupancy_window(const occupancy_grid grid, const unsigned int bit, const unsigned int row) {
+  const uint64_t* words = grid.words + (size_t) row * grid.words_per_row + bit / 64;
+  const unsigned int offset = bit % 64;
+
+  // The spare word at the end of every row makes reading the next word safe
+  return offset == 0 ? words[0] : (words[0] >> offset) | (words[1] << (64 - offset));
+}
+
+/**
+ * @brief Checks whether cell (x, y) and its four neighbours are all clear.
+ *
+ * Cells outside the board are padding and count as clear, so no bounds are checked.
+ */
+static inline bool occupancy_neighbourhood_is_clear(const occupancy_grid grid, const unsigned int x, const unsigned int y) {
+  // Columns x - 1, x and x + 1 start at padded bit x
+  const uint64_t row = occupancy_window(grid, x, y + 1) & 7;
+  const uint64_t below = occupancy_window(grid, x + 1, y) & 1;
+  const uint64_t above = occupancy_window(grid, x + 1, y + 2) & 1;
+
+  return (row | below | above) == 0;
+}
+
+/**
+ * @brief Returns a mask of the marked cells among `count` consecutive columns of a row.
+ *
+ * @param grid The grid.
+ * @param x The first column.
+ * @param y The row.
+ * @param count The number of columns (1-64).
+ * @return The bits of columns `x` to `x + count - 1`, with column `x` in the least significant position.
+ */
+static inline uint64_t occupancy_run(const occupancy_grid grid, const unsigned int x, const unsigned int y, const unsigned int count) {
+  const uint64_t mask = count == 64 ? ~UINT64_C(0) : (UINT64_C(1) << count) - 1;
+
+  return occupancy_window(grid, x + 1, y + 1) & mask;
+}
+
+#endif // CSNAKE_LADDER_OCCUPANCY_H
@@ -0,0 +1,316 @@
+#include "render.h"
+
+#ifdef _WIN32
+    # include <io.h>
+    # include <windows.h>
+    # define write _write
+#else
+    # include <sys/ioctl.h>
+    # include <unistd.h>
+#endif
+
+// The longest escape code the renderer writes, "\x1b[<line>;<column>H" with two 10 digit numbers
+#define _LONGEST_ESCAPE 24
+
+// The marker drawn next to the label of a cell, indexed by its `role`
+static const char _role_markers[NUMBER_OF_ROLES + 1] = {
+    [is_ladder] = 'l',
+    [is_ladder_start] = 'L',
+    [is_snake] = 's',
+    [is_snake_head] = 'S',
+    [none] = ' ',
+};
+
+static unsigned int _number_of_digits(unsigned int number) {
+    unsigned int digits = 1;
+
+    while(number >= 10) {
+        number /= 10;
+        digits += 1;
+    }
+
+    return digits;
+}
+
+// "|" followed by the label, the role marker and the player token
+static inline unsigned int _cell_width(const renderer* renderer) {
+    return renderer->label_width + 3;
+}
+
+// The board is drawn with the last row on top and a separator line between rows
+static inline unsigned int _board_lines(const renderer* renderer) {
+    return 2 * renderer->board_size - 1;
+}
+
+// Cursor lines are absolute, so patches only land on the right cell while no board line wraps or scrolls away
+static bool _board_fits_terminal(const renderer* renderer) {
+    const unsigned int columns = renderer->board_size * _cell_width(renderer) + 1;
+    const unsigned int lines = _board_lines(renderer) + 1;
+
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+
+    if(!GetConsoleScreenBufferInfo((HANDLE) _get_osfhandle(renderer->output),&info)) return true;
+
+    return (unsigned int)(info.srWindow.Right - info.srWindow.Left + 1) >= columns && (unsigned int)(info.srWindow.Bottom - info.srWindow.Top + 1) >= lines;
+#else
+    struct winsize size;
+
+    // Outputs without a size, like files and pipes, never wrap
+    if(ioctl(renderer->output,TIOCGWINSZ,&size) != 0 || size.ws_row == 0 || size.ws_col == 0) return true;
+
+    return size.ws_col >= columns && size.ws_row >= lines;
+#endif
+}
+
+renderer create_renderer(const board board, const int output) {
+#ifdef _WIN32
+    // Windows consoles only understand escape codes once asked to
+    const HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+
+    if(GetConsoleMode(console,&mode)) SetConsoleMode(console,mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+#endif
+
+    renderer renderer = {
+        .output = output,
+        .board_size = board.board_size,
+        .label_width = _number_of_digits(board.board_size * board.board_size),
+        .number_of_players = board.number_of_players,
+        .drawn = false,
+        .fits = false,
+    };
+
+    // Enough for a whole board, so that drawing never has to grow the buffer
+    const size_t line_length = (size_t) board.board_size * _cell_width(&renderer) + 2;
+    renderer.frame_capacity = line_length * _board_lines(&renderer) + 4 * _LONGEST_ESCAPE;
+    renderer.frame = malloc(renderer.frame_capacity);
+
+    if(renderer.frame == NULL) {
+        perror("malloc has failed");
+        exit(1);
+    }
+
+    return renderer;
+}
+
+void free_renderer(renderer renderer) {
+    if(renderer.drawn && renderer.fits) {
+        // Give the whole screen back to scrolling, and continue below the board
+        memcpy(renderer.frame,"\x1b[r",3);
+        renderer.frame_length = 3;
+        _frame_move_cursor(&renderer,_board_lines(&renderer) + 1,1);
+
+        _frame_flush(&renderer);
+    }
+
+    free(renderer.frame);
+}
+
+void render_board(renderer* renderer, const board board) {
+    TRACE_BEGIN(render);
+
+    // Whatever the game printed so far has to reach the terminal before the frame
+    fflush(stdout);
+
+    // Checked every frame, so that resizing the terminal switches between patching and redrawing
+    const bool fits = _board_fits_terminal(renderer);
+
+    if(!renderer->drawn || fits != renderer->fits) {
+        if(renderer->drawn && renderer->fits) {
+            // Give the whole screen back to scrolling, without leaving the messages
+            _frame_reserve(renderer,7);
+            memcpy(renderer->frame + renderer->frame_length,"\x1b" "7" "\x1b[r" "\x1b" "8",7);
+            renderer->frame_length += 7;
+        }
+
+        renderer->fits = fits;
+        _frame_full_board(renderer,board);
+    } else if(!fits) {
+        bool changed = false;
+
+        for(unsigned int player = 0;player < renderer->number_of_players;player++) {
+            if(renderer->positions[player] != board.players[player].position) changed = true;
+        }
+
+        // Nothing moved, nothing to write
+        if(!changed) {
+            TRACE_END(span_render_board,render);
+            return;
+        }
+
+        _frame_full_board(renderer,board);
+    } else {
+        bool changed = false;
+
+        for(unsigned int player = 0;player < renderer->number_of_players;player++) {
+            const unsigned int previous = renderer->positions[player];
+            const unsigned int current = board.players[player].position;
+
+            if(previous == current) continue;
+
+            renderer->positions[player] = current;
+
+            if(!changed) {
+                // Save the cursor, which belongs to the messages below the board
+                _frame_reserve(renderer,2);
+                memcpy(renderer->frame + renderer->frame_length,"\x1b" "7",2);
+                renderer->frame_length += 2;
+                changed = true;
+            }
+
+            _frame_patch_cell(renderer,previous,_token_for(renderer->positions,renderer->number_of_players,previous));
+            _frame_patch_cell(renderer,current,_token_for(renderer->positions,renderer->number_of_players,current));
+        }
+
+        // Nothing moved, nothing to write
+        if(!changed) {
+            TRACE_END(span_render_board,render);
+            return;
+        }
+
+        _frame_reserve(renderer,2);
+        memcpy(renderer->frame + renderer->frame_length,"\x1b" "8",2);
+        renderer->frame_length += 2;
+    }
+
+    _frame_flush(renderer);
+
+    TRACE_END(span_render_board,render);
+}
+
+void _frame_reserve(renderer* renderer, const size_t length) {
+    if(renderer->frame_length + length <= renderer->frame_capacity) return;
+
+    while(renderer->frame_length + length > renderer->frame_capacity) renderer->frame_capacity *= 2;
+
+    renderer->frame = realloc(renderer->frame,renderer->frame_capacity);
+
+    if(renderer->frame == NULL) {
+        perror("realloc has failed");
+        exit(1);
+    }
+}
+
+void _frame_append_number(renderer* renderer, unsigned int number, const unsigned int width) {
+    char digits[10];
+    unsigned int count = 0;
+
+    do {
+        digits[count++] = '0' + number % 10;
+        number /= 10;
+    } while(number != 0);
+
+    char* out = renderer->frame + renderer->frame_length;
+
+    for(unsigned int padding = count;padding < width;padding++) *out++ = ' ';
+    while(count != 0) *out++ = digits[--count];
+
+    renderer->frame_length = out - renderer->frame;
+}
+
+void _frame_move_cursor(renderer* renderer, const unsigned int line, const unsigned int column) {
+    char* out = renderer->frame + renderer->frame_length;
+    *out++ = '\x1b';
+    *out++ = '[';
+    renderer->frame_length = out - renderer->frame;
+
+    _frame_append_number(renderer,line,0);
+    renderer->frame[renderer->frame_length++] = ';';
+    _frame_append_number(renderer,column,0);
+    renderer->frame[renderer->frame_length++] = 'H';
+}
+
+char _token_for(const unsigned int* positions, const unsigned int number_of_players, const unsigned int label) {
+    char token = ' ';
+
+    for(unsigned int player = 0;player < number_of_players;player++) {
+        if(positions[player] != label) continue;
+
+        if(token != ' ') return '*';
+
+        token = '0' + (player + 1) % 10;
+    }
+
+    return token;
+}
+
+void _frame_patch_cell(renderer* renderer, const unsigned int label, const char token) {
+    const unsigned int x = (label - 1) % renderer->board_size;
+    const unsigned int y = (label - 1) / renderer->board_size;
+
+    const unsigned int line = 1 + 2 * (renderer->board_size - 1 - y);
+    const unsigned int column = x * _cell_width(renderer) + renderer->label_width + 3;
+
+    _frame_reserve(renderer,_LONGEST_ESCAPE + 1);
+    _frame_move_cursor(renderer,line,column);
+    renderer->frame[renderer->frame_length++] = token;
+}
+
+void _frame_full_board(renderer* renderer, const board board) {
+    const unsigned int line_length = board.board_size * _cell_width(renderer) + 1;
+
+    for(unsigned int player = 0;player < renderer->number_of_players;player++) {
+        renderer->positions[player] = board.players[player].position;
+    }
+
+    _frame_reserve(renderer,(size_t)(line_length + 1) * _board_lines(renderer) + 4 * _LONGEST_ESCAPE);
+
+    if(renderer->fits) {
+        // Clear the screen and start at the top left
+        memcpy(renderer->frame + renderer->frame_length,"\x1b[r\x1b[H\x1b[2J",10);
+        renderer->frame_length += 10;
+    }
+
+    for(int row = board.board_size - 1;row >= 0;row--) {
+        for(unsigned int col = 0;col < board.board_size;col++) {
+            // Labels follow from the coordinates, so dense and sparse boards are drawn alike
+            const unsigned int label = board_index_of(board,col,row) + 1;
+
+            renderer->frame[renderer->frame_length++] = '|';
+            _frame_append_number(renderer,label,renderer->label_width);
+            renderer->frame[renderer->frame_length++] = _role_markers[board_role_at(board,col,row)];
+            renderer->frame[renderer->frame_length++] = _token_for(renderer->positions,renderer->number_of_players,label);
+        }
+
+        renderer->frame[renderer->frame_length++] = '|';
+        renderer->frame[renderer->frame_length++] = '\n';
+
+        if(row != 0) {
+            memset(renderer->frame + renderer->frame_length,'-',line_length);
+            renderer->frame_length += line_length;
+            renderer->frame[renderer->frame_length++] = '\n';
+        }
+    }
+
+    renderer->drawn = true;
+
+    // A board taller or wider than the terminal just scrolls by with the messages
+    if(!renderer->fits) return;
+
+    // Only the lines below the board scroll from now on, the board stays where it is
+    const unsigned int first_message_line = _board_lines(renderer) + 1;
+
+    renderer->frame[renderer->frame_length++] = '\x1b';
+    renderer->frame[renderer->frame_length++] = '[';
+    _frame_append_number(renderer,first_message_line,0);
+    renderer->frame[renderer->frame_length++] = 'r';
+    _frame_move_cursor(renderer,first_message_line,1);
+}
+
+void _frame_flush(renderer* renderer) {
+    size_t written = 0;
+
+    // A terminal takes the frame in one go, a pipe may take it in pieces
+    while(written < renderer->frame_length) {
+        const long result = write(renderer->output,renderer->frame + written,renderer->frame_length - written);
+
+        if(result <= 0) break;
+
+        written += result;
+    }
+
+    renderer->frames += 1;
+    renderer->bytes_written += written;
+    renderer->frame_length = 0;
+}
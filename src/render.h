@@ -0,0 +1,97 @@
+/**
+ * @file CSnakeLadderRender.h
+ * @brief Header file containing the terminal renderer of Snake and Ladder boards.
+ *
+ * This header file defines functions that draw a board with its players. A frame is formatted into one reusable heap buffer and handed to the terminal with a single `write`. The first frame draws the whole board at the top of the screen and keeps the lines below it scrolling for messages. Every later frame only moves the cursor to the cells whose player tokens changed and rewrites those. A board that does not fit on the terminal (`TIOCGWINSZ`) would wrap or scroll away from those cursor lines, so it is instead redrawn whole, without escape codes, every time a player moves.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_RENDER_H
+#define CSNAKE_LADDER_RENDER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "board.h"
+#include "trace.h"
+
+/**
+ * @brief Function to create a renderer for a board.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param output The file descriptor to write frames to, usually 1 (standard output).
+ * @return The `renderer`. (Caller needs to release it with `free_renderer`)
+ */
+renderer create_renderer(const board board, const int output);
+
+/**
+ * @brief Frees the frame buffer of a renderer and gives the whole screen back to scrolling.
+ */
+void free_renderer(renderer renderer);
+
+/**
+ * @brief Draws the players of a board.
+ *
+ * The first call draws the whole board, every later call only redraws the cells a player left or arrived on, or the whole board again while it does not fit on the terminal. Anything buffered in `stdout` is flushed first, so frames and messages stay in order.
+ *
+ * @param renderer Pointer to the renderer.
+ * @param board The `board` structure representing the game board, whose `players` are drawn.
+ */
+void render_board(renderer* renderer, const board board);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief Function to make room for `length` more characters in the frame buffer.
+ *
+ * @param renderer Pointer to the renderer.
+ * @param length The number of characters about to be appended.
+ */
+void _frame_reserve(renderer* renderer, const size_t length);
+
+/**
+ * @brief Appends a number, right-aligned to `width` characters, to the frame. (Room has to be reserved)
+ */
+void _frame_append_number(renderer* renderer, unsigned int number, const unsigned int width);
+
+/**
+ * @brief Appends the escape code moving the cursor to a screen line and column (both starting at 1) to the frame. (Room has to be reserved)
+ */
+void _frame_move_cursor(renderer* renderer, const unsigned int line, const unsigned int column);
+
+/**
+ * @brief Function to find the token drawn on a cell: blank, the number of the player on it (0 for the tenth), or `*` when several players share it.
+ *
+ * @param positions Pointer to the positions of the players.
+ * @param number_of_players The number of players.
+ * @param label The label of the cell.
+ * @return The token.
+ */
+char _token_for(const unsigned int* positions, const unsigned int number_of_players, const unsigned int label);
+
+/**
+ * @brief Appends the escape codes redrawing the token of a single cell to the frame.
+ *
+ * @param renderer Pointer to the renderer.
+ * @param label The label of the cell.
+ * @param token The token to draw.
+ */
+void _frame_patch_cell(renderer* renderer, const unsigned int label, const char token);
+
+/**
+ * @brief Formats the whole board into the frame, pinned to the top of the screen when it `fits`, else plainly into the scrolling output.
+ *
+ * @param renderer Pointer to the renderer.
+ * @param board The `board` structure representing the game board.
+ */
+void _frame_full_board(renderer* renderer, const board board);
+
+/**
+ * @brief Writes the frame to the output, with as few calls as the output accepts (one for a terminal), and empties it.
+ *
+ * @param renderer Pointer to the renderer.
+ */
+void _frame_flush(renderer* renderer);
+
+#endif // CSNAKE_LADDER_RENDER_H
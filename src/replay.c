@@ -0,0 +1,397 @@
+#include "replay.h"
+
+#ifdef _WIN32
+    # include <io.h>
+#else
+    # include <sys/mman.h>
+    # include <unistd.h>
+#endif
+
+_Static_assert(sizeof(replay_file_header) % 8 == 0,"replay games start at a multiple of 8");
+_Static_assert(sizeof(replay_game_header) % 8 == 0,"replay codes start at a multiple of 8");
+
+static const char _magic[8] = { 'C', 'S', 'L', 'R', 'E', 'P', 'L', 'Y' };
+
+#define _BYTE_ORDER_MARK 0x01020304u
+
+replay_writer open_replay_log(const char *const path, validate_message* error) {
+    replay_writer writer = { 0 };
+
+    *error = NULL;
+
+    // Reading is allowed anywhere, but every write goes to the end
+    FILE* file = fopen(path,"ab+");
+
+    if(file == NULL) {
+        *error = "The replay log could not be opened!\n";
+        return writer;
+    }
+
+    fseek(file,0,SEEK_END);
+    const long size = ftell(file);
+
+    if(size == 0) {
+        replay_file_header header = {
+            .version = REPLAY_FILE_VERSION,
+            .byte_order = _BYTE_ORDER_MARK,
+        };
+        memcpy(header.magic,_magic,sizeof(_magic));
+
+        if(fwrite(&header,sizeof(header),1,file) != 1 || fflush(file) != 0) *error = "The replay log could not be written!\n";
+    } else {
+        replay_file_header header;
+        rewind(file);
+
+        if(size < (long) sizeof(header) || fread(&header,sizeof(header),1,file) != 1) *error = "The replay log is too short to be one!\n";
+        else *error = _check_replay_file_header(&header);
+
+        // A word torn by a crash is dropped, which leaves the game it belongs to incomplete
+        const long torn = (size - (long) sizeof(header)) % 8;
+
+        if(*error == NULL && torn != 0) {
+            fflush(file);
+
+#ifdef _WIN32
+            const bool truncated = _chsize(_fileno(file),size - torn) == 0;
+#else
+            const bool truncated = ftruncate(fileno(file),size - torn) == 0;
+#endif
+
+            if(!truncated) *error = "The replay log could not be written!\n";
+        }
+    }
+
+    if(*error != NULL) {
+        fclose(file);
+        return writer;
+    }
+
+    writer.file = file;
+
+    return writer;
+}
+
+void close_replay_log(replay_writer writer) {
+    if(writer.file != NULL) fclose(writer.file);
+}
+
+void begin_replay_game(replay_writer* writer, const board board, const bool from_library) {
+    if(writer->file == NULL) return;
+
+    const replay_game_header header = {
+        .marker = REPLAY_GAME_MARKER,
+        .seed = board.config.seed,
+        .number_of_players = board.number_of_players,
+        .difficulty = board.config.difficulty,
+        .board_size = board.board_size,
+        .from_library = from_library,
+        .fingerprint = board_fingerprint(board),
+    };
+
+    fwrite(&header,sizeof(header),1,writer->file);
+    fflush(writer->file);
+
+    writer->word = 0;
+    writer->codes = 0;
+}
+
+void record_replay_roll(replay_writer* writer, const unsigned int roll) {
+    _append_replay_code(writer,(replay_code) roll);
+}
+
+void record_replay_turn(replay_writer* writer) {
+    _append_replay_code(writer,replay_turn);
+}
+
+void end_replay_game(replay_writer* writer) {
+    if(writer->file == NULL) return;
+
+    _append_replay_code(writer,replay_end);
+
+    // The rest of the word is padding, which reads as more ends
+    if(writer->codes != 0) {
+        fwrite(&writer->word,sizeof(uint64_t),1,writer->file);
+        fflush(writer->file);
+
+        writer->word = 0;
+        writer->codes = 0;
+    }
+}
+
+uint64_t board_fingerprint(const board board) {
+    // FNV-1a over the jumps in label order, every other cell jumps to itself
+    uint64_t hash = UINT64_C(0xcbf29ce484222325) ^ board.jumps.number_of_cells;
+
+    if(board.jumps.destination == NULL) {
+        for(unsigned int i = 0;i < board.jumps.number_of_jumps;i++) {
+            hash = (hash ^ board.jumps.from[i]) * UINT64_C(0x100000001b3);
+            hash = (hash ^ board.jumps.to[i]) * UINT64_C(0x100000001b3);
+        }
+    } else {
+        for(unsigned int label = 1;label <= board.jumps.number_of_cells;label++) {
+            if(board.jumps.destination[label] == label) continue;
+
+            hash = (hash ^ label) * UINT64_C(0x100000001b3);
+            hash = (hash ^ board.jumps.destination[label]) * UINT64_C(0x100000001b3);
+        }
+    }
+
+    return hash;
+}
+
+validate_message replay_log(const char *const path, const board_library* library, FILE* games, replay_summary* summary) {
+    const replay_summary empty = { 0 };
+    *summary = empty;
+
+    const board_mapping mapping = _map_file(path);
+    if(mapping.address == NULL) return "The replay log could not be mapped!\n";
+
+    validate_message error = mapping.length < sizeof(replay_file_header)
+        ? "The replay log is too short to be one!\n"
+        : _check_replay_file_header(mapping.address);
+
+    if(error != NULL) {
+        unmap_board_file(mapping);
+        return error;
+    }
+
+#ifndef _WIN32
+    // The log is read once from front to back
+    posix_madvise((void*) mapping.address,mapping.length,POSIX_MADV_SEQUENTIAL);
+#endif
+
+    const unsigned char* base = mapping.address;
+    const uint64_t* word = (const uint64_t*)(base + sizeof(replay_file_header));
+    const uint64_t* end = word + (mapping.length - sizeof(replay_file_header)) / sizeof(uint64_t);
+
+    const size_t header_words = sizeof(replay_game_header) / sizeof(uint64_t);
+
+    replay_cached_board* cache = calloc(REPLAY_BOARD_CACHE_SIZE,sizeof(replay_cached_board));
+
+    if(cache == NULL) {
+        perror("calloc has failed");
+        exit(1);
+    }
+
+    const clock_t started = clock();
+
+    while(word < end) {
+        if(*word != REPLAY_GAME_MARKER) {
+            error = "The replay log is corrupt, a game does not start where the previous one ended!\n";
+            break;
+        }
+
+        summary->games += 1;
+
+        // The writer stopped in the middle of the header
+        if((size_t)(end - word) < header_words) {
+            summary->incomplete += 1;
+            break;
+        }
+
+        replay_game_header header;
+        memcpy(&header,word,sizeof(header));
+        word += header_words;
+
+        const board* board = _resolve_replay_board(cache,&header,library,summary);
+
+        if(board == NULL) {
+            summary->missing_boards += 1;
+
+            if(!_skip_replay_game(&word,end)) summary->incomplete += 1;
+            continue;
+        }
+
+        game_result result;
+        bool diverged;
+
+        if(!_replay_game(*board,&word,end,&result,&summary->rolls,&diverged)) {
+            summary->incomplete += 1;
+            continue;
+        }
+
+        if(diverged) summary->diverged += 1;
+
+        _add_to_summary(&summary->results,result);
+
+        if(games != NULL) {
+            fprintf(games,"game=%llu players=%u difficulty=%u seed=%llu finished=%d winner=%u rounds=%u turns=%u rolls=%u ladder_hits=%u snake_hits=%u diverged=%d\n",
+                summary->games,header.number_of_players,header.difficulty,(unsigned long long) header.seed,
+                result.finished,result.finished ? result.winner + 1 : 0,
+                result.rounds,result.turns,result.rolls,result.ladder_hits,result.snake_hits,diverged
+            );
+        }
+    }
+
+    summary->results.elapsed_seconds = (double)(clock() - started) / CLOCKS_PER_SEC;
+
+    for(unsigned int slot = 0;slot < REPLAY_BOARD_CACHE_SIZE;slot++) {
+        if(cache[slot].used && cache[slot].error == NULL) free_board(cache[slot].board);
+    }
+
+    free(cache);
+    unmap_board_file(mapping);
+
+    return error;
+}
+
+void _append_replay_code(replay_writer* writer, const replay_code code) {
+    if(writer->file == NULL) return;
+
+    writer->word |= (uint64_t) code << (3 * writer->codes);
+    writer->codes += 1;
+
+    // A full word goes out at once, so a crash loses at most the codes of one word
+    if(writer->codes == REPLAY_CODES_PER_WORD) {
+        fwrite(&writer->word,sizeof(uint64_t),1,writer->file);
+        fflush(writer->file);
+
+        writer->word = 0;
+        writer->codes = 0;
+    }
+}
+
+validate_message _check_replay_file_header(const replay_file_header* header) {
+    if(memcmp(header->magic,_magic,sizeof(_magic)) != 0) return "The file is not a replay log!\n";
+    if(header->byte_order != _BYTE_ORDER_MARK) return "The replay log was written on a machine with another byte order!\n";
+    if(header->version != REPLAY_FILE_VERSION) return "The replay log was written by another version!\n";
+
+    return NULL;
+}
+
+const board* _resolve_replay_board(replay_cached_board* cache, const replay_game_header* reference, const board_library* library, replay_summary* summary) {
+    const uint64_t key = reference->seed * UINT64_C(0x9E3779B97F4A7C15) ^ reference->fingerprint ^ (reference->number_of_players * 31 + reference->difficulty);
+    replay_cached_board* slot = cache + (key >> 32) % REPLAY_BOARD_CACHE_SIZE;
+
+    if(slot->used && memcmp(&slot->reference,reference,sizeof(replay_game_header)) == 0) {
+        return slot->error == NULL ? &slot->board : NULL;
+    }
+
+    if(slot->used && slot->error == NULL) free_board(slot->board);
+
+    slot->used = true;
+    slot->reference = *reference;
+
+    // A corrupt header must not make the replayer generate a giant board
+    slot->error = ensure_players_within_1_10(reference->number_of_players);
+    if(slot->error == NULL) slot->error = ensure_difficulty_within_1_10(reference->difficulty);
+    if(slot->error != NULL) return NULL;
+
+    const config config = {
+        .number_of_players = reference->number_of_players,
+        .difficulty = reference->difficulty,
+        .seed = reference->seed,
+    };
+
+    // The header has no parameters, so every library board of the seed is tried until one matches the fingerprint
+    const library_entry* first = NULL;
+    const unsigned int candidates = !reference->from_library ? 1 : library != NULL ? find_library_seed_entries(*library,config,&first) : 0;
+
+    if(candidates == 0) {
+        slot->error = "The board of the game is not in the library!\n";
+        return NULL;
+    }
+
+    for(unsigned int i = 0;i < candidates;i++) {
+        const board board = first != NULL ? load_library_board(*library,&first[i],false,&slot->error) : generate_board_from_config(config);
+        if(slot->error != NULL) return NULL;
+
+        summary->boards_resolved += 1;
+
+        if(board.board_size == reference->board_size && board_fingerprint(board) == reference->fingerprint) {
+            // `board` has constant members, so it is copied in place
+            memcpy(&slot->board,&board,sizeof(board));
+
+            return &slot->board;
+        }
+
+        free_board(board);
+    }
+
+    slot->error = "The board of the game does not match the one it was played on!\n";
+    return NULL;
+}
+
+bool _replay_game(const board board, const uint64_t** cursor, const uint64_t* end, game_result* result, unsigned long long* rolls, bool* diverged) {
+    // Positions are kept on the stack, like in `simulate_game`
+    player players[MAXIMUM_NUMBER_OF_PLAYERS];
+
+    game game = new_game(board,players);
+
+    // Whether the last roll ended the turn, so that a turn marker has to come next
+    bool turn_ended = false;
+
+    *diverged = false;
+
+    const uint64_t* word = *cursor;
+
+    // Words of codes never have their top bit set, a word that does starts the next game
+    while(word < end && (*word >> 63) == 0) {
+        uint64_t codes = *word++;
+
+        for(unsigned int i = 0;i < REPLAY_CODES_PER_WORD;i++,codes >>= 3) {
+            const unsigned int code = codes & 7;
+
+            if(code == replay_end) {
+                // A game is quit between turns at the earliest, and a won game ends right after its last roll
+                if(turn_ended) *diverged = true;
+
+                *cursor = word;
+
+                const game_result replayed = {
+                    .finished = game.finished,
+                    .winner = game.winner,
+                    .rounds = game.finished ? game.round + 1 : game.round,
+                    .turns = game.turns,
+                    .rolls = game.rolls,
+                    .ladder_hits = game.ladder_hits,
+                    .snake_hits = game.snake_hits,
+                    .invalidated_moves = game.invalidated_moves,
+                };
+
+                *result = replayed;
+                return true;
+            }
+
+            if(code == replay_turn) {
+                if(!turn_ended) *diverged = true;
+                turn_ended = false;
+                continue;
+            }
+
+            // Rolls after the game was won, or a turn that goes on, were recorded under other rules
+            if(turn_ended || game.finished) {
+                *diverged = true;
+                if(game.finished) continue;
+            }
+
+            const turn_outcome outcome = game_apply_roll(&game,code);
+            *rolls += 1;
+
+            turn_ended = outcome == turn_over || outcome == three_sixes;
+        }
+    }
+
+    *cursor = word;
+
+    return false;
+}
+
+bool _skip_replay_game(const uint64_t** cursor, const uint64_t* end) {
+    const uint64_t* word = *cursor;
+
+    while(word < end && (*word >> 63) == 0) {
+        uint64_t codes = *word++;
+
+        for(unsigned int i = 0;i < REPLAY_CODES_PER_WORD;i++,codes >>= 3) {
+            if((codes & 7) == replay_end) {
+                *cursor = word;
+                return true;
+            }
+        }
+    }
+
+    *cursor = word;
+
+    return false;
+}
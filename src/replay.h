@@ -0,0 +1,146 @@
+/**
+ * @file CSnakeLadderReplay.h
+ * @brief Header file containing the replay log of Snake and Ladder games.
+ *
+ * A replay log is an append-only file of games. Every game starts with a `replay_game_header` that references its board (configuration, seed, whether it came from a library and a fingerprint of its jump table) and is followed by its dice rolls and turn markers as 3-bit `replay_code`s, 21 to a 64-bit word. A game of 200 rolls takes about 120 bytes.
+ *
+ * Codes are written a word at a time and flushed as soon as a word is full, so a log cut short by a crash still holds all but the last few rolls of its last game. Opening such a log again drops a word that was only partly written, and appends after it. The replayer maps the log and walks it from front to back without allocating anything per game or per roll: it applies every roll with `game_apply_roll` and checks the recorded turn markers against the outcomes, so after a change of the rules the games that would have gone differently are counted as diverged.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_REPLAY_H
+#define CSNAKE_LADDER_REPLAY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "config.h"
+#include "board.h"
+#include "game.h"
+#include "storage.h"
+#include "library.h"
+#include "simulation.h"
+
+/**
+ * @def REPLAY_FILE_VERSION
+ * @brief The version of the replay log format written by `open_replay_log`. Logs of other versions are refused.
+ */
+#define REPLAY_FILE_VERSION 1
+
+/**
+ * @def REPLAY_LOG_VARIABLE
+ * @brief The environment variable naming the replay log the interactive game appends to.
+ */
+#define REPLAY_LOG_VARIABLE "CSNAKE_REPLAY_LOG"
+
+/**
+ * @brief Function to open a replay log for appending, creating it if needed.
+ *
+ * @param path The path of the log.
+ * @param error Pointer that receives a message describing why the log could not be opened, or `NULL` on success.
+ * @return The `replay_writer`, whose `file` is `NULL` if the log could not be opened. (Caller needs to release it with `close_replay_log`)
+ */
+replay_writer open_replay_log(const char *const path, validate_message* error);
+
+/**
+ * @brief Closes a replay log. A game that was not ended is left as it is, and replayed as incomplete.
+ */
+void close_replay_log(replay_writer writer);
+
+/**
+ * @brief Function to start recording a game.
+ *
+ * All recording functions do nothing on a writer without a `file`, so a game can be recorded unconditionally.
+ *
+ * @param writer Pointer to the `replay_writer`.
+ * @param board The `board` the game is played on.
+ * @param from_library Whether the board was taken from a board library rather than generated from its configuration.
+ */
+void begin_replay_game(replay_writer* writer, const board board, const bool from_library);
+
+/**
+ * @brief Records a dice roll, between 1 and 6.
+ */
+void record_replay_roll(replay_writer* writer, const unsigned int roll);
+
+/**
+ * @brief Records the end of the turn of the current player, after a roll that ended it.
+ */
+void record_replay_turn(replay_writer* writer);
+
+/**
+ * @brief Records the end of a game, won or quit, and flushes it to the log.
+ */
+void end_replay_game(replay_writer* writer);
+
+/**
+ * @brief Function to compute the fingerprint of a board, a hash of every jump of its jump table.
+ *
+ * Dense and sparse boards with the same jumps have the same fingerprint.
+ *
+ * @param board The `board` structure representing the game board.
+ * @return The fingerprint.
+ */
+uint64_t board_fingerprint(const board board);
+
+/**
+ * @brief Function to replay every game of a log.
+ *
+ * @param path The path of the log.
+ * @param library Pointer to the `board_library` the boards of games played on library boards are taken from, or `NULL`.
+ * @param games The stream a line per game is written to, or `NULL`.
+ * @param summary Pointer to the `replay_summary` that is filled in.
+ * @return A message describing why the log could not be replayed to its end, or `NULL` on success.
+ */
+validate_message replay_log(const char *const path, const board_library* library, FILE* games, replay_summary* summary);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief Function to add a code to the word that is being filled, writing the word out once it is full.
+ */
+void _append_replay_code(replay_writer* writer, const replay_code code);
+
+/**
+ * @brief Function to check the header of a replay log.
+ *
+ * @param header Pointer to the header.
+ * @return A message describing the problem, or `NULL` if the header is valid.
+ */
+validate_message _check_replay_file_header(const replay_file_header* header);
+
+/**
+ * @brief Function to find the board a game was played on, from the cache or by loading or generating it.
+ *
+ * @param cache Pointer to `REPLAY_BOARD_CACHE_SIZE` cached boards.
+ * @param reference Pointer to the header of the game.
+ * @param library Pointer to the `board_library`, or `NULL`.
+ * @param summary Pointer to the `replay_summary`, whose `boards_resolved` is counted.
+ * @return Pointer to the board, or `NULL` if it could not be resolved or does not match its fingerprint.
+ */
+const board* _resolve_replay_board(replay_cached_board* cache, const replay_game_header* reference, const board_library* library, replay_summary* summary);
+
+/**
+ * @brief Function to replay the codes of one game.
+ *
+ * @param board The `board` the game is played on.
+ * @param cursor Pointer to the first word of codes, which is moved past the words of the game.
+ * @param end Pointer past the last word of the log.
+ * @param result Pointer to the `game_result` that is filled in.
+ * @param rolls Pointer to the number of rolls replayed, which is counted.
+ * @param diverged Pointer that receives whether the codes do not match the move logic.
+ * @return `true` if the game ended, `false` if the log ends (or the next game starts) before it does.
+ */
+bool _replay_game(const board board, const uint64_t** cursor, const uint64_t* end, game_result* result, unsigned long long* rolls, bool* diverged);
+
+/**
+ * @brief Function to skip the codes of a game whose board could not be resolved.
+ *
+ * @param cursor Pointer to the first word of codes, which is moved past the words of the game.
+ * @param end Pointer past the last word of the log.
+ * @return `true` if the game ended, `false` if the log ends (or the next game starts) before it does.
+ */
+bool _skip_replay_game(const uint64_t** cursor, const uint64_t* end);
+
+#endif // CSNAKE_LADDER_REPLAY_H
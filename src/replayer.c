@@ -0,0 +1,79 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "types.h"
+#include "library.h"
+#include "replay.h"
+
+// Plays back the games of a replay log through the move logic, without rendering or waiting.
+//
+// Usage: replayer <replay log> [library directory] [games output]
+//
+// Games played on boards from a board library need `library directory` to be replayed, every other board
+// is generated again from the configuration recorded with its game. With `games output` (`-` for stdout)
+// a line is written per game. The summary counts the games whose recorded turns do not match the current
+// rules as diverged, the games cut short by the end of the log as incomplete, and the games whose board
+// could not be found or no longer matches its fingerprint as missing boards. The exit status is 1 if the log
+// could not be read to its end, and 2 if any game diverged.
+
+#define REPLAYER_OUTPUT_BUFFER_SIZE (1 << 16)
+
+int main(int argc, char** argv) {
+    if(argc < 2 || argc > 4) {
+        fprintf(stderr,"Usage: %s <replay log> [library directory] [games output]\n",argv[0]);
+        return 1;
+    }
+
+    const char *const log_path = argv[1];
+    const char *const directory = argc > 2 && *argv[2] != '\0' ? argv[2] : NULL;
+    const char *const games_path = argc > 3 ? argv[3] : NULL;
+
+    validate_message error = NULL;
+    board_library library;
+
+    if(directory != NULL) {
+        library = open_board_library(directory,&error);
+
+        if(error != NULL) {
+            fprintf(stderr,"%s: %s",directory,error);
+            return 1;
+        }
+    }
+
+    FILE* games = games_path == NULL ? NULL : strcmp(games_path,"-") == 0 ? stdout : fopen(games_path,"w");
+
+    if(games_path != NULL && games == NULL) {
+        perror("Opening the games output has failed");
+        return 1;
+    }
+
+    if(games != NULL) setvbuf(games,NULL,_IOFBF,REPLAYER_OUTPUT_BUFFER_SIZE);
+
+    replay_summary summary;
+    error = replay_log(log_path,directory != NULL ? &library : NULL,games,&summary);
+
+    if(games != NULL && games != stdout) fclose(games);
+    else if(games != NULL) fflush(games);
+
+    if(directory != NULL) close_board_library(library);
+
+    if(error != NULL) fprintf(stderr,"%s: %s",log_path,error);
+
+    const simulation_summary results = summary.results;
+    const double seconds = results.elapsed_seconds;
+
+    printf("%llu games, %llu rolls: %u replayed, %llu diverged, %llu incomplete, %llu missing boards, %llu boards resolved\n",
+        summary.games,summary.rolls,results.games,summary.diverged,summary.incomplete,summary.missing_boards,summary.boards_resolved
+    );
+
+    if(results.games != 0) {
+        printf("mean rounds %.2f (min %u, max %u), %u finished, %.0f games per minute\n",
+            (double) results.total_rounds / results.games,results.minimum_rounds,results.maximum_rounds,results.finished_games,
+            seconds > 0 ? results.games / seconds * 60 : 0
+        );
+    }
+
+    if(error != NULL) return 1;
+
+    return summary.diverged == 0 ? 0 : 2;
+}
@@ -0,0 +1,99 @@
+#include "rng.h"
+
+// xoshiro256** and splitmix64 by David Blackman and Sebastiano Vigna https://prng.di.unimi.it/
+
+static inline uint64_t _rotate_left(const uint64_t x, const int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t _splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+rng rng_from_seed(const uint64_t seed) {
+    uint64_t splitmix_state = seed;
+
+    rng rng;
+
+    for(int i = 0;i < 4;i++) {
+        rng.state[i] = _splitmix64(&splitmix_state);
+    }
+
+    return rng;
+}
+
+uint64_t rng_stream_seed(const uint64_t seed, const uint64_t stream) {
+    // Hash the stream index first, so that neighbouring streams of neighbouring seeds never line up
+    uint64_t stream_state = stream;
+    uint64_t seed_state = seed ^ _splitmix64(&stream_state);
+
+    return _splitmix64(&seed_state);
+}
+
+rng rng_for_stream(const uint64_t seed, const uint64_t stream) {
+    return rng_from_seed(rng_stream_seed(seed,stream));
+}
+
+uint64_t rng_next(rng* rng) {
+    uint64_t* s = rng->state;
+
+    const uint64_t result = _rotate_left(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+
+    s[2] ^= t;
+    s[3] = _rotate_left(s[3], 45);
+
+    return result;
+}
+
+void rng_jump(rng* rng) {
+    static const uint64_t jump[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+
+    uint64_t s0 = 0;
+    uint64_t s1 = 0;
+    uint64_t s2 = 0;
+    uint64_t s3 = 0;
+
+    for(int i = 0;i < 4;i++) {
+        for(int b = 0;b < 64;b++) {
+            if (jump[i] & UINT64_C(1) << b) {
+                s0 ^= rng->state[0];
+                s1 ^= rng->state[1];
+                s2 ^= rng->state[2];
+                s3 ^= rng->state[3];
+            }
+
+            rng_next(rng);
+        }
+    }
+
+    rng->state[0] = s0;
+    rng->state[1] = s1;
+    rng->state[2] = s2;
+    rng->state[3] = s3;
+}
+
+uint32_t rng_below(rng* rng, const uint32_t range) {
+    // Lemire's multiply-shift, rejecting the few values that would bias the result https://arxiv.org/abs/1805.10941
+    uint64_t product = (uint64_t)(uint32_t)(rng_next(rng) >> 32) * range;
+    uint32_t low = (uint32_t) product;
+
+    if(low < range) {
+        const uint32_t threshold = -range % range;
+
+        while(low < threshold) {
+            product = (uint64_t)(uint32_t)(rng_next(rng) >> 32) * range;
+            low = (uint32_t) product;
+        }
+    }
+
+    return product >> 32;
+}
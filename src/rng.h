@@ -0,0 +1,71 @@
+/**
+ * @file CSnakeLadderRng.h
+ * @brief Header file containing the random number generator used by Snake and Ladder.
+ *
+ * This header file defines functions for seeding, splitting and drawing from a xoshiro256** generator. Unlike `rand()`, the state is an explicit `rng` value, so threads and games never share it and every run can be reproduced bit-for-bit from its seed.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_RNG_H
+#define CSNAKE_LADDER_RNG_H
+
+#include <stdint.h>
+
+#include "types.h"
+
+/**
+ * @brief Function to create a generator from a 64-bit seed.
+ *
+ * The seed is expanded into the 256 bits of state with splitmix64, so any seed (including 0) is valid.
+ *
+ * @param seed The seed to start from.
+ * @return A seeded `rng`.
+ */
+rng rng_from_seed(const uint64_t seed);
+
+/**
+ * @brief Function to derive the seed of an independent stream from a base seed.
+ *
+ * This is used to give every game of a batch its own seed, which can be computed directly from the index of the game.
+ *
+ * @param seed The base seed.
+ * @param stream The index of the stream.
+ * @return The seed of the stream.
+ */
+uint64_t rng_stream_seed(const uint64_t seed, const uint64_t stream);
+
+/**
+ * @brief Function to create the generator of an independent stream of a base seed.
+ *
+ * @param seed The base seed.
+ * @param stream The index of the stream.
+ * @return A seeded `rng`, equivalent to `rng_from_seed(rng_stream_seed(seed, stream))`.
+ */
+rng rng_for_stream(const uint64_t seed, const uint64_t stream);
+
+/**
+ * @brief Function to advance a generator by 2^128 draws.
+ *
+ * Calling this repeatedly on a copy of a generator yields up to 2^128 non-overlapping sequences, one per thread.
+ *
+ * @param rng Pointer to the generator to advance.
+ */
+void rng_jump(rng* rng);
+
+/**
+ * @brief Function to draw the next 64 random bits from a generator.
+ *
+ * @param rng Pointer to the generator to draw from.
+ * @return 64 uniformly distributed random bits.
+ */
+uint64_t rng_next(rng* rng);
+
+/**
+ * @brief Function to draw a uniformly distributed number in `[0, range)` without modulo bias.
+ *
+ * @param rng Pointer to the generator to draw from.
+ * @param range The number of possible values, which must be at least 1.
+ * @return A random number between 0 and `range - 1`.
+ */
+uint32_t rng_below(rng* rng, const uint32_t range);
+
+#endif // CSNAKE_LADDER_RNG_H
@@ -0,0 +1,324 @@
+#include "scheduler.h"
+
+void start_session(session* session, const board board, const session_controller* controllers, const uint64_t seed) {
+    // `game` holds a board with constant members, so it is built in place
+    const game game = new_game(board,session->players);
+    memcpy(&session->game,&game,sizeof(game));
+
+    for(unsigned int player = 0;player < MAXIMUM_NUMBER_OF_PLAYERS;player++) {
+        session->controllers[player] = player < board.number_of_players ? controllers[player] : controller_bot;
+    }
+
+    session->dice = rng_from_seed(seed);
+
+    atomic_init(&session->requested_rolls,0);
+    atomic_init(&session->parked,false);
+
+    session->next = NULL;
+    session->queued_at = 0;
+    session->quanta = 0;
+    session->total_wait = 0;
+    session->longest_wait = 0;
+}
+
+session_state step_session(session* session) {
+    if(session->game.finished) return session_finished;
+
+    if(session->controllers[session->game.current_player] == controller_human) {
+        unsigned int requested = atomic_load(&session->requested_rolls);
+
+        // Take one of the requested rolls, other threads may be adding to them
+        do {
+            if(requested == 0) return session_waiting;
+        } while(!atomic_compare_exchange_weak(&session->requested_rolls,&requested,requested - 1));
+    }
+
+    // The same dice as `simulate_game`
+    game_apply_roll(&session->game,_random_between(&session->dice,1,6));
+
+    return session->game.finished ? session_finished : session_runnable;
+}
+
+void start_session_scheduler(session_scheduler* scheduler, const unsigned int number_of_workers) {
+    // The run queues are aligned to cache lines, so that the workers do not share any
+    scheduler->workers = aligned_alloc(_Alignof(session_worker),number_of_workers * sizeof(session_worker));
+
+    if(scheduler->workers == NULL) {
+        perror("aligned_alloc has failed");
+        exit(1);
+    }
+
+    memset(scheduler->workers,0,number_of_workers * sizeof(session_worker));
+
+    scheduler->number_of_workers = number_of_workers;
+    scheduler->shared_first = NULL;
+    scheduler->shared_last = NULL;
+
+    atomic_init(&scheduler->shared_pending,false);
+    atomic_init(&scheduler->sleeping,0);
+    atomic_init(&scheduler->unfinished,0);
+    atomic_init(&scheduler->stopping,false);
+
+    pthread_mutex_init(&scheduler->lock,NULL);
+    pthread_cond_init(&scheduler->work,NULL);
+    pthread_cond_init(&scheduler->drained,NULL);
+
+    for(unsigned int index = 0;index < number_of_workers;index++) {
+        session_worker* worker = scheduler->workers + index;
+
+        atomic_init(&worker->queue.head,0);
+        atomic_init(&worker->queue.tail,0);
+
+        worker->scheduler = scheduler;
+        worker->index = index;
+        worker->victims = rng_for_stream(index,1);
+    }
+
+    // Every worker is set up before any of them can look at the others
+    for(unsigned int index = 0;index < number_of_workers;index++) {
+        if(pthread_create(&scheduler->workers[index].thread,NULL,_session_worker,scheduler->workers + index) != 0) {
+            perror("pthread_create has failed");
+            exit(1);
+        }
+    }
+}
+
+void submit_session(session_scheduler* scheduler, session* session) {
+    atomic_fetch_add(&scheduler->unfinished,1);
+
+    session->queued_at = monotonic_nanoseconds();
+
+    _schedule_shared(scheduler,session);
+}
+
+void request_session_roll(session_scheduler* scheduler, session* session) {
+    atomic_fetch_add(&session->requested_rolls,1);
+
+    // Whoever clears `parked` schedules the session, see `_run_session`
+    bool parked = true;
+
+    if(atomic_compare_exchange_strong(&session->parked,&parked,false)) {
+        session->queued_at = monotonic_nanoseconds();
+        _schedule_shared(scheduler,session);
+    }
+}
+
+void wait_for_sessions(session_scheduler* scheduler) {
+    pthread_mutex_lock(&scheduler->lock);
+
+    while(atomic_load(&scheduler->unfinished) != 0) pthread_cond_wait(&scheduler->drained,&scheduler->lock);
+
+    pthread_mutex_unlock(&scheduler->lock);
+}
+
+void stop_session_scheduler(session_scheduler* scheduler) {
+    pthread_mutex_lock(&scheduler->lock);
+
+    atomic_store(&scheduler->stopping,true);
+    pthread_cond_broadcast(&scheduler->work);
+
+    pthread_mutex_unlock(&scheduler->lock);
+
+    for(unsigned int index = 0;index < scheduler->number_of_workers;index++) pthread_join(scheduler->workers[index].thread,NULL);
+
+    pthread_mutex_destroy(&scheduler->lock);
+    pthread_cond_destroy(&scheduler->work);
+    pthread_cond_destroy(&scheduler->drained);
+
+    free(scheduler->workers);
+    scheduler->workers = NULL;
+}
+
+void* _session_worker(void* argument) {
+    session_worker* worker = argument;
+    session_scheduler* scheduler = worker->scheduler;
+
+    while(!atomic_load_explicit(&scheduler->stopping,memory_order_relaxed)) {
+        session* session = _find_session(worker);
+
+        if(session != NULL) _run_session(worker,session);
+        else if(!_sleep_until_work(worker)) break;
+    }
+
+    return NULL;
+}
+
+session* _find_session(session_worker* worker) {
+    session_scheduler* scheduler = worker->scheduler;
+    session* session = NULL;
+
+    if(worker->quanta % SESSION_SHARED_INTERVAL == 0) session = _take_shared(scheduler);
+
+    if(session == NULL) session = _take_session(&worker->queue);
+    if(session == NULL) session = _take_shared(scheduler);
+
+    // Steal the oldest runnable session of another worker, starting at a random one so thieves spread out
+    if(session == NULL && scheduler->number_of_workers > 1) {
+        const unsigned int first = rng_below(&worker->victims,scheduler->number_of_workers);
+
+        for(unsigned int i = 0;i < scheduler->number_of_workers && session == NULL;i++) {
+            const unsigned int victim = (first + i) % scheduler->number_of_workers;
+            if(victim == worker->index) continue;
+
+            session = _take_session(&scheduler->workers[victim].queue);
+            if(session != NULL) worker->steals += 1;
+        }
+    }
+
+    return session;
+}
+
+void _run_session(session_worker* worker, session* session) {
+    const uint64_t started = monotonic_nanoseconds();
+    const uint64_t wait = started - session->queued_at;
+
+    session->total_wait += wait;
+    if(wait > session->longest_wait) session->longest_wait = wait;
+    session->quanta += 1;
+
+    worker->quanta += 1;
+
+    const unsigned int rolls = session->game.rolls;
+    session_state state = session_runnable;
+
+    for(unsigned int step = 0;step < SESSION_QUANTUM && state == session_runnable;step++) state = step_session(session);
+
+    worker->rolls += session->game.rolls - rolls;
+
+    if(state == session_runnable) {
+        session->queued_at = monotonic_nanoseconds();
+        _schedule_locally(worker,session);
+    }
+    else if(state == session_waiting) {
+        atomic_store(&session->parked,true);
+
+        // A roll requested after the step found none, but before the session was parked, did not see it parked
+        bool parked = true;
+
+        if(atomic_load(&session->requested_rolls) != 0 && atomic_compare_exchange_strong(&session->parked,&parked,false)) {
+            session->queued_at = monotonic_nanoseconds();
+            _schedule_locally(worker,session);
+        }
+    }
+    else if(atomic_fetch_sub(&worker->scheduler->unfinished,1) == 1) {
+        session_scheduler* scheduler = worker->scheduler;
+
+        pthread_mutex_lock(&scheduler->lock);
+        pthread_cond_broadcast(&scheduler->drained);
+        pthread_mutex_unlock(&scheduler->lock);
+    }
+}
+
+void _schedule_locally(session_worker* worker, session* session) {
+    if(!_push_session(&worker->queue,session)) {
+        _schedule_shared(worker->scheduler,session);
+        return;
+    }
+
+    // A sleeping worker can steal it
+    _wake_a_worker(worker->scheduler);
+}
+
+void _schedule_shared(session_scheduler* scheduler, session* session) {
+    session->next = NULL;
+
+    pthread_mutex_lock(&scheduler->lock);
+
+    if(scheduler->shared_last != NULL) scheduler->shared_last->next = session;
+    else scheduler->shared_first = session;
+
+    scheduler->shared_last = session;
+    atomic_store(&scheduler->shared_pending,true);
+
+    pthread_cond_signal(&scheduler->work);
+
+    pthread_mutex_unlock(&scheduler->lock);
+}
+
+session* _take_shared(session_scheduler* scheduler) {
+    // Most of the time the shared queue is empty, which is seen without the lock
+    if(!atomic_load_explicit(&scheduler->shared_pending,memory_order_acquire)) return NULL;
+
+    pthread_mutex_lock(&scheduler->lock);
+
+    session* session = scheduler->shared_first;
+
+    if(session != NULL) {
+        scheduler->shared_first = session->next;
+        if(scheduler->shared_first == NULL) scheduler->shared_last = NULL;
+    }
+
+    atomic_store(&scheduler->shared_pending,scheduler->shared_first != NULL);
+
+    pthread_mutex_unlock(&scheduler->lock);
+
+    return session;
+}
+
+bool _push_session(session_queue* queue, session* session) {
+    const uint64_t tail = atomic_load_explicit(&queue->tail,memory_order_relaxed);
+    const uint64_t head = atomic_load_explicit(&queue->head,memory_order_acquire);
+
+    if(tail - head >= SESSION_QUEUE_CAPACITY) return false;
+
+    atomic_store_explicit(&queue->slots[tail % SESSION_QUEUE_CAPACITY],session,memory_order_relaxed);
+    atomic_store_explicit(&queue->tail,tail + 1,memory_order_release);
+
+    return true;
+}
+
+session* _take_session(session_queue* queue) {
+    uint64_t head = atomic_load_explicit(&queue->head,memory_order_acquire);
+
+    while(true) {
+        const uint64_t tail = atomic_load_explicit(&queue->tail,memory_order_acquire);
+        if(head >= tail) return NULL;
+
+        // The slot may be overwritten once another taker has moved the head on, but then the exchange fails
+        session* session = atomic_load_explicit(&queue->slots[head % SESSION_QUEUE_CAPACITY],memory_order_relaxed);
+
+        if(atomic_compare_exchange_weak_explicit(&queue->head,&head,head + 1,memory_order_acq_rel,memory_order_acquire)) return session;
+    }
+}
+
+bool _sleep_until_work(session_worker* worker) {
+    session_scheduler* scheduler = worker->scheduler;
+
+    pthread_mutex_lock(&scheduler->lock);
+
+    // Announced before looking again, so a session pushed from now on wakes this worker or is found below
+    atomic_fetch_add(&scheduler->sleeping,1);
+
+    bool working = false;
+
+    while(!atomic_load(&scheduler->stopping)) {
+        working = scheduler->shared_first != NULL;
+
+        for(unsigned int index = 0;index < scheduler->number_of_workers && !working;index++) {
+            const session_queue* queue = &scheduler->workers[index].queue;
+            working = atomic_load(&queue->tail) > atomic_load(&queue->head);
+        }
+
+        if(working) break;
+
+        worker->sleeps += 1;
+        pthread_cond_wait(&scheduler->work,&scheduler->lock);
+    }
+
+    atomic_fetch_sub(&scheduler->sleeping,1);
+
+    pthread_mutex_unlock(&scheduler->lock);
+
+    return working;
+}
+
+void _wake_a_worker(session_scheduler* scheduler) {
+    // Pairs with the announcement in `_sleep_until_work`: either the sleeper sees the session, or this sees the sleeper
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if(atomic_load(&scheduler->sleeping) == 0) return;
+
+    pthread_mutex_lock(&scheduler->lock);
+    pthread_cond_signal(&scheduler->work);
+    pthread_mutex_unlock(&scheduler->lock);
+}
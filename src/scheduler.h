@@ -0,0 +1,143 @@
+/**
+ * @file CSnakeLadderScheduler.h
+ * @brief Header file containing the session scheduler of Snake and Ladder, which plays many games on a fixed set of threads.
+ *
+ * A `session` is one game written as a state machine: `step_session` plays a single roll and returns, so a game can be continued on any thread at any time. Bots roll as soon as it is their turn, a human's turn parks the session until `request_session_roll` is called, from any thread.
+ *
+ * Every worker of a `session_scheduler` takes sessions from the front of its own run queue, plays up to `SESSION_QUANTUM` rolls and puts the session back at the end, so runnable sessions take turns. Sessions submitted from outside go to a shared queue, which every worker also looks at every `SESSION_SHARED_INTERVAL` quanta. A worker whose queue runs dry takes from the shared queue, then steals from the front of the queues of other workers picked at random, and only sleeps when there is nothing to steal.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_SCHEDULER_H
+#define CSNAKE_LADDER_SCHEDULER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "types.h"
+#include "board.h"
+#include "game.h"
+#include "rng.h"
+#include "timer.h"
+
+/**
+ * @brief Function to start a session on a board.
+ *
+ * @param session Pointer to the `session` to start, which must not be in a scheduler.
+ * @param board The `board` the game is played on, which has to outlive the session.
+ * @param controllers Pointer to who rolls for each of the `board.number_of_players` players.
+ * @param seed The seed of the dice. The rolls of a session that only has bots are the ones `simulate_game` makes with the same seed.
+ */
+void start_session(session* session, const board board, const session_controller* controllers, const uint64_t seed);
+
+/**
+ * @brief Function to play the next roll of a session, if it can go on.
+ *
+ * @param session Pointer to the `session`.
+ * @return The `session_state` after the step.
+ */
+session_state step_session(session* session);
+
+/**
+ * @brief Function to start a scheduler and its worker threads.
+ *
+ * @param scheduler Pointer to the `session_scheduler` to start, which must stay where it is until it has been stopped.
+ * @param number_of_workers The number of worker threads.
+ */
+void start_session_scheduler(session_scheduler* scheduler, const unsigned int number_of_workers);
+
+/**
+ * @brief Function to hand a started session to a scheduler, from any thread.
+ *
+ * @param scheduler Pointer to the `session_scheduler`.
+ * @param session Pointer to the `session`, which must stay where it is until it has finished.
+ */
+void submit_session(session_scheduler* scheduler, session* session);
+
+/**
+ * @brief Function to ask for a roll of the human whose turn it is, from any thread. A session that waits for it is scheduled again.
+ *
+ * @param scheduler Pointer to the `session_scheduler` the session was submitted to.
+ * @param session Pointer to the `session`.
+ */
+void request_session_roll(session_scheduler* scheduler, session* session);
+
+/**
+ * @brief Function to wait until every session submitted to a scheduler has finished.
+ *
+ * @param scheduler Pointer to the `session_scheduler`.
+ */
+void wait_for_sessions(session_scheduler* scheduler);
+
+/**
+ * @brief Function to stop the workers of a scheduler and free them. Sessions that have not finished are left as they are.
+ *
+ * @param scheduler Pointer to the `session_scheduler`.
+ */
+void stop_session_scheduler(session_scheduler* scheduler);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief The thread function of a worker.
+ */
+void* _session_worker(void* worker);
+
+/**
+ * @brief Function to find the next session for a worker, from its own queue, the shared queue or another worker.
+ *
+ * @return The session, or `NULL` if there is none anywhere.
+ */
+session* _find_session(session_worker* worker);
+
+/**
+ * @brief Function to run a session for a quantum and schedule it according to its state.
+ */
+void _run_session(session_worker* worker, session* session);
+
+/**
+ * @brief Function to put a session at the end of the run queue of its worker, or into the shared queue if that is full.
+ */
+void _schedule_locally(session_worker* worker, session* session);
+
+/**
+ * @brief Function to put a session into the shared queue and wake a sleeping worker for it.
+ */
+void _schedule_shared(session_scheduler* scheduler, session* session);
+
+/**
+ * @brief Function to take the first session of the shared queue.
+ *
+ * @return The session, or `NULL` if the queue is empty.
+ */
+session* _take_shared(session_scheduler* scheduler);
+
+/**
+ * @brief Function to push a session to the end of a run queue, only called by its owner.
+ *
+ * @return `false` if the queue is full.
+ */
+bool _push_session(session_queue* queue, session* session);
+
+/**
+ * @brief Function to take the session at the front of a run queue, by its owner or a thief.
+ *
+ * @return The session, or `NULL` if the queue is empty.
+ */
+session* _take_session(session_queue* queue);
+
+/**
+ * @brief Function to put a worker to sleep until there is work or the scheduler stops.
+ *
+ * @return `false` if the scheduler stops.
+ */
+bool _sleep_until_work(session_worker* worker);
+
+/**
+ * @brief Function to wake a sleeping worker, if there is one, because a session has become runnable.
+ */
+void _wake_a_worker(session_scheduler* scheduler);
+
+#endif // CSNAKE_LADDER_SCHEDULER_H
@@ -0,0 +1,217 @@
+#include "segments.h"
+#include "board.h"
+
+segment_index create_segment_index(const unsigned int board_size, arena* arena) {
+    const unsigned int buckets_per_row = (board_size + SEGMENT_BUCKET_SIZE - 1) / SEGMENT_BUCKET_SIZE;
+    const size_t number_of_buckets = (size_t) buckets_per_row * buckets_per_row;
+
+    segment_index index = {
+        .board_size = board_size,
+        .buckets_per_row = buckets_per_row,
+        .bucket_heads = arena != NULL ? arena_allocate(arena,number_of_buckets * sizeof(unsigned int)) : malloc(number_of_buckets * sizeof(unsigned int)),
+    };
+
+    if(number_of_buckets != 0 && index.bucket_heads == NULL) {
+        perror("malloc has failed");
+        exit(1);
+    }
+
+    // Every bit set is UINT_MAX, the end of an empty list
+    memset(index.bucket_heads,0xff,number_of_buckets * sizeof(unsigned int));
+
+    return index;
+}
+
+void free_segment_index(segment_index index) {
+    free(index.bucket_heads);
+    free(index.segments);
+    free(index.runs);
+    free(index.links);
+}
+
+void segment_index_add(segment_index* index, const board_entity entity, const point start, const point aim, const point end, arena* arena) {
+    const unsigned int first_row = start.y < end.y ? start.y : end.y;
+    const unsigned int number_of_rows = (start.y < end.y ? end.y - start.y : start.y - end.y) + 1;
+
+    _reserve_segment_array((void**) &index->segments,&index->segments_capacity,index->number_of_segments + 1,sizeof(segment),arena);
+    _reserve_segment_array((void**) &index->runs,&index->runs_capacity,index->number_of_runs + number_of_rows,sizeof(segment_run),arena);
+
+    const unsigned int number = index->number_of_segments++;
+
+    const segment segment = {
+        .entity = entity,
+        .first_row = first_row,
+        .number_of_rows = number_of_rows,
+        .first_run = index->number_of_runs,
+    };
+
+    index->segments[number] = segment;
+    index->number_of_runs += number_of_rows;
+
+    bresenham_line line = line_between(start,aim);
+    const int step_x = start.x <= aim.x ? 1 : -1;
+
+    // The buckets a monotone line passes through never come back, so comparing with the last one is enough
+    unsigned int last_bucket = UINT_MAX;
+    bool more = true;
+
+    while(more) {
+        const unsigned int y = line.y;
+        const unsigned int run_first_x = line.x;
+        unsigned int run_last_x = line.x;
+
+        // The line was cut short at `end` when it was drawn, and stops on the first cell of the next row otherwise
+        while(true) {
+            if((line.x == (int) end.x && line.y == (int) end.y) || !line_step(&line)) {
+                more = false;
+                break;
+            }
+
+            if(line.y != (int) y) break;
+
+            run_last_x = line.x;
+        }
+
+        const segment_run run = {
+            .first_x = run_first_x < run_last_x ? run_first_x : run_last_x,
+            .last_x = run_first_x < run_last_x ? run_last_x : run_first_x,
+        };
+
+        index->runs[segment.first_run + (y - first_row)] = run;
+
+        const unsigned int bucket_row = y / SEGMENT_BUCKET_SIZE * index->buckets_per_row;
+        const int last_column = run_last_x / SEGMENT_BUCKET_SIZE;
+
+        for(int column = run_first_x / SEGMENT_BUCKET_SIZE;;column += step_x) {
+            const unsigned int bucket = bucket_row + column;
+
+            if(bucket != last_bucket) {
+                _link_segment(index,bucket,number,arena);
+                last_bucket = bucket;
+            }
+
+            if(column == last_column) break;
+        }
+    }
+}
+
+board_entity segment_index_entity_at(const segment_index* index, const unsigned int x, const unsigned int y) {
+    const unsigned int bucket = y / SEGMENT_BUCKET_SIZE * index->buckets_per_row + x / SEGMENT_BUCKET_SIZE;
+
+    for(unsigned int link = index->bucket_heads[bucket];link != UINT_MAX;link = index->links[link].next) {
+        const segment segment = index->segments[index->links[link].segment];
+        const segment_run* run = _segment_run_in_row(index,segment,y);
+
+        if(run != NULL && run->first_x <= x && x <= run->last_x) return segment.entity;
+    }
+
+    const board_entity nothing = { .kind = entity_none };
+
+    return nothing;
+}
+
+bool segment_index_neighbourhood_is_clear(const segment_index* index, const unsigned int x, const unsigned int y) {
+    const unsigned int last = index->board_size - 1;
+
+    if(segment_index_entity_at(index,x,y).kind != entity_none) return false;
+    if(x > 0 && segment_index_entity_at(index,x - 1,y).kind != entity_none) return false;
+    if(x < last && segment_index_entity_at(index,x + 1,y).kind != entity_none) return false;
+    if(y > 0 && segment_index_entity_at(index,x,y - 1).kind != entity_none) return false;
+    if(y < last && segment_index_entity_at(index,x,y + 1).kind != entity_none) return false;
+
+    return true;
+}
+
+unsigned int segment_index_unblocked_cells(const segment_index* index, const point start, const point end, unsigned int* length) {
+    bresenham_line line = line_between(start,end);
+
+    unsigned int cells_before_run = 0;
+    unsigned int unblocked = UINT_MAX;
+
+    // A line visits each row in one horizontal run of cells, which is checked against the segments around it
+    while(true) {
+        const unsigned int y = line.y;
+        const unsigned int run_first_x = line.x;
+        unsigned int run_last_x = line.x;
+        unsigned int run_length = 1;
+
+        bool more = line_step(&line);
+
+        while(more && line.y == (int) y) {
+            run_last_x = line.x;
+            run_length += 1;
+            more = line_step(&line);
+        }
+
+        if(unblocked == UINT_MAX) {
+            const bool forward = run_first_x <= run_last_x;
+            const unsigned int low = forward ? run_first_x : run_last_x;
+            const unsigned int high = forward ? run_last_x : run_first_x;
+
+            // The first covered cell in the direction of travel, as a distance from the start of the run
+            unsigned int first_blocked = UINT_MAX;
+
+            const unsigned int bucket_row = y / SEGMENT_BUCKET_SIZE * index->buckets_per_row;
+
+            for(unsigned int column = low / SEGMENT_BUCKET_SIZE;column <= high / SEGMENT_BUCKET_SIZE;column++) {
+                for(unsigned int link = index->bucket_heads[bucket_row + column];link != UINT_MAX;link = index->links[link].next) {
+                    const segment_run* run = _segment_run_in_row(index,index->segments[index->links[link].segment],y);
+
+                    if(run == NULL || run->last_x < low || run->first_x > high) continue;
+
+                    const unsigned int blocked = forward
+                        ? (run->first_x > low ? run->first_x : low) - low
+                        : high - (run->last_x < high ? run->last_x : high);
+
+                    if(blocked < first_blocked) first_blocked = blocked;
+                }
+            }
+
+            if(first_blocked != UINT_MAX) unblocked = cells_before_run + first_blocked;
+        }
+
+        cells_before_run += run_length;
+
+        if(!more) break;
+    }
+
+    *length = cells_before_run;
+
+    return unblocked == UINT_MAX ? cells_before_run : unblocked;
+}
+
+void _reserve_segment_array(void** memory, unsigned int* capacity, const unsigned int needed, const size_t element_size, arena* arena) {
+    if(needed <= *capacity) return;
+
+    unsigned int grown = *capacity < 64 ? 64 : *capacity;
+    while(grown < needed) grown *= 2;
+
+    void* moved;
+
+    // An arena cannot grow a piece in place, so the elements move to a new one
+    if(arena != NULL) {
+        moved = arena_allocate(arena,grown * element_size);
+        if(moved != NULL && *capacity != 0) memcpy(moved,*memory,*capacity * element_size);
+    }
+    else moved = realloc(*memory,grown * element_size);
+
+    if(moved == NULL) {
+        perror("malloc has failed");
+        exit(1);
+    }
+
+    *memory = moved;
+    *capacity = grown;
+}
+
+void _link_segment(segment_index* index, const unsigned int bucket, const unsigned int segment, arena* arena) {
+    _reserve_segment_array((void**) &index->links,&index->links_capacity,index->number_of_links + 1,sizeof(segment_link),arena);
+
+    const segment_link link = {
+        .segment = segment,
+        .next = index->bucket_heads[bucket],
+    };
+
+    index->links[index->number_of_links] = link;
+    index->bucket_heads[bucket] = index->number_of_links++;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file CSnakeLadderSegments.h
+ * @brief Header file containing the spatial index of the ladders and snakes of a Snake and Ladder board.
+ *
+ * This header file defines functions for `segment_index`, which keeps every ladder and snake as a segment of one horizontal run of cells per row (a Bresenham line visits every row in one run) and files the segments under the square buckets of the board they pass through. It answers which entity covers a cell, whether a cell and its neighbours are free and how far a new line can go before it meets an entity, by looking at a few segments nearby instead of at every cell.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_SEGMENTS_H
+#define CSNAKE_LADDER_SEGMENTS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+
+#include "types.h"
+#include "arena.h"
+
+/**
+ * @brief Function to create an empty index for a board.
+ *
+ * @param board_size The size of the board.
+ * @param arena Pointer to the `arena` the index is carved from, or `NULL` to use the system allocator.
+ * @return The `segment_index`. (Caller needs to release it with `free_segment_index`, unless it lives in an arena)
+ */
+segment_index create_segment_index(const unsigned int board_size, arena* arena);
+
+/**
+ * @brief Frees the memory of an index created without an arena.
+ */
+void free_segment_index(segment_index index);
+
+/**
+ * @brief Function to add a ladder or snake to an index.
+ *
+ * @param index Pointer to the index.
+ * @param entity The entity the segment belongs to.
+ * @param start The first cell, the start of a ladder or the tail of a snake.
+ * @param aim The point the line was drawn towards.
+ * @param end The last cell, at which the line was cut short.
+ * @param arena Pointer to the `arena` the index was created in, or `NULL`.
+ */
+void segment_index_add(segment_index* index, const board_entity entity, const point start, const point aim, const point end, arena* arena);
+
+/**
+ * @brief Function to find the ladder or snake that covers a cell.
+ *
+ * @param index Pointer to the index.
+ * @param x The x-coordinate of the cell.
+ * @param y The y-coordinate of the cell.
+ * @return The entity, whose `kind` is `entity_none` if the cell is free.
+ */
+board_entity segment_index_entity_at(const segment_index* index, const unsigned int x, const unsigned int y);
+
+/**
+ * @brief Checks whether a cell and its four neighbours are free of ladders and snakes. Cells off the board count as free.
+ *
+ * @param index Pointer to the index.
+ * @param x The x-coordinate of the cell.
+ * @param y The y-coordinate of the cell.
+ * @return True if the cell and its neighbours are free, False otherwise.
+ */
+bool segment_index_neighbourhood_is_clear(const segment_index* index, const unsigned int x, const unsigned int y);
+
+/**
+ * @brief Function to count the cells of a line that can be drawn before the first cell covered by a ladder or snake, before any cell is drawn.
+ *
+ * @param index Pointer to the index.
+ * @param start The first cell of the line.
+ * @param end The last cell of the line.
+ * @param length Pointer that receives the total number of cells of the line.
+ * @return The number of cells, counted from `start`, that are free.
+ */
+unsigned int segment_index_unblocked_cells(const segment_index* index, const point start, const point end, unsigned int* length);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief Function to make room for more elements in one of the arrays of an index, doubling it.
+ *
+ * @param memory Pointer to the array, which is replaced by the grown one.
+ * @param capacity Pointer to the number of elements the array has room for, which is updated.
+ * @param needed The number of elements needed.
+ * @param element_size The size of one element.
+ * @param arena Pointer to the `arena` the index was created in, or `NULL`.
+ */
+void _reserve_segment_array(void** memory, unsigned int* capacity, const unsigned int needed, const size_t element_size, arena* arena);
+
+/**
+ * @brief Function to link a segment into the list of a bucket.
+ */
+void _link_segment(segment_index* index, const unsigned int bucket, const unsigned int segment, arena* arena);
+
+/**
+ * @brief Returns the run of a segment in a row, or `NULL` if the segment does not cover the row.
+ */
+static inline const segment_run* _segment_run_in_row(const segment_index* index, const segment segment, const unsigned int y) {
+  if(y < segment.first_row || y - segment.first_row >= segment.number_of_rows) return NULL;
+
+  return index->runs + segment.first_run + (y - segment.first_row);
+}
+
+#endif // CSNAKE_LADDER_SEGMENTS_H
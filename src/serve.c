@@ -0,0 +1,126 @@
+// pthread_sigmask and eventfd need the POSIX and Linux declarations
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "types.h"
+#include "server.h"
+
+#if defined(__linux__)
+    # include <pthread.h>
+    # include <signal.h>
+    # include <unistd.h>
+    # include <sys/eventfd.h>
+#endif
+
+// Hosts Snake and Ladder games for clients over TCP or a Unix socket, see server.h for the protocol.
+//
+// Usage: serve <address> [threads] [connections per thread]
+//
+// `address` is `unix:<path>`, `<port>` or `<host>:<port>`. Every thread runs its own event loop and holds up to
+// `connections per thread` connections. For TCP every thread listens on a socket of its own, which the kernel
+// balances connections over; all threads accept from the one Unix socket. The server runs until it
+// gets SIGINT or SIGTERM, then prints what every thread did. loadgen.c puts it under load.
+
+#define SERVE_DEFAULT_THREADS 4
+#define SERVE_DEFAULT_CONNECTIONS 4096
+
+#if defined(__linux__)
+
+static void* _serve(void* server) {
+    run_game_server(server);
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    if(argc < 2 || argc > 4) {
+        fprintf(stderr,"Usage: %s <address> [threads] [connections per thread]\n",argv[0]);
+        return 1;
+    }
+
+    const char *const address = argv[1];
+    const unsigned int threads = argc > 2 ? (unsigned int) strtoul(argv[2],NULL,10) : SERVE_DEFAULT_THREADS;
+    const unsigned int connections = argc > 3 ? (unsigned int) strtoul(argv[3],NULL,10) : SERVE_DEFAULT_CONNECTIONS;
+
+    if(threads < 1 || connections < 1) {
+        fprintf(stderr,"At least one thread and one connection per thread are needed!\n");
+        return 1;
+    }
+
+    // The signals are taken by `sigwait` below, every thread started from here inherits the mask
+    sigset_t stop;
+    sigemptyset(&stop);
+    sigaddset(&stop,SIGINT);
+    sigaddset(&stop,SIGTERM);
+    pthread_sigmask(SIG_BLOCK,&stop,NULL);
+
+    const int wake = eventfd(0,EFD_CLOEXEC | EFD_NONBLOCK);
+    game_server* servers = malloc(threads * sizeof(game_server));
+    pthread_t* workers = malloc(threads * sizeof(pthread_t));
+    int* listeners = malloc(threads * sizeof(int));
+
+    if(wake < 0 || servers == NULL || workers == NULL || listeners == NULL) {
+        perror("Setting up the server has failed");
+        return 1;
+    }
+
+    validate_message error;
+
+    if(!open_server_listeners(address,threads,listeners,&error)) {
+        fprintf(stderr,"%s: %s",address,error);
+        return 1;
+    }
+
+    for(unsigned int thread = 0;thread < threads;thread++) {
+        servers[thread] = create_game_server(listeners[thread],wake,connections);
+
+        if(pthread_create(&workers[thread],NULL,_serve,&servers[thread]) != 0) {
+            perror("pthread_create has failed");
+            return 1;
+        }
+    }
+
+    fprintf(stderr,"Serving on %s with %u threads\n",address,threads);
+
+    int signal;
+    sigwait(&stop,&signal);
+
+    // The counter is never read back, so it stays readable for every thread
+    const uint64_t one = 1;
+    if(write(wake,&one,sizeof(one)) != sizeof(one)) perror("Waking the threads has failed");
+
+    for(unsigned int thread = 0;thread < threads;thread++) {
+        pthread_join(workers[thread],NULL);
+
+        const game_server server = servers[thread];
+
+        fprintf(stderr,"thread %u: %llu connections accepted, %llu refused, %llu requests, %llu games won\n",
+            thread,server.accepted,server.refused,server.requests,server.games_won
+        );
+
+        free_game_server(server);
+
+        // Threads that share a Unix socket share it with the first one
+        if(thread == 0 || listeners[thread] != listeners[0]) close(listeners[thread]);
+    }
+
+    close(wake);
+
+    if(strncmp(address,"unix:",5) == 0) unlink(address + 5);
+
+    free(servers);
+    free(workers);
+    free(listeners);
+
+    return 0;
+}
+
+#else
+
+int main(void) {
+    fprintf(stderr,"The game server needs Linux!\n");
+    return 1;
+}
+
+#endif
@@ -0,0 +1,492 @@
+// accept4 is a Linux extension
+#define _GNU_SOURCE
+
+#include "server.h"
+
+#if defined(__linux__)
+
+#include <stdarg.h>
+#include <errno.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+// The epoll data of the descriptors that are not connections, which are tagged with their slot
+#define _LISTENER_TAG UINT64_MAX
+#define _WAKE_TAG (UINT64_MAX - 1)
+
+int open_server_listener(const char *const address, const bool share_port, validate_message* error) {
+    *error = NULL;
+
+    int listener = -1;
+
+    if(strncmp(address,"unix:",5) == 0) {
+        const char *const path = address + 5;
+
+        struct sockaddr_un local = { .sun_family = AF_UNIX };
+
+        if(*path == '\0' || strlen(path) >= sizeof(local.sun_path)) {
+            *error = "The path of the Unix socket is empty or too long!\n";
+            return -1;
+        }
+
+        strcpy(local.sun_path,path);
+
+        listener = socket(AF_UNIX,SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,0);
+
+        // A socket file left behind by an earlier server would make the bind fail
+        unlink(path);
+
+        if(listener < 0 || bind(listener,(const struct sockaddr*) &local,sizeof(local)) != 0) *error = "The Unix socket could not be bound!\n";
+    } else {
+        // `<host>:<port>` or only `<port>`, split at the last colon
+        char host[256];
+        const char* port = strrchr(address,':');
+
+        if(port == NULL) {
+            host[0] = '\0';
+            port = address;
+        } else if((size_t)(port - address) < sizeof(host)) {
+            memcpy(host,address,port - address);
+            host[port - address] = '\0';
+            port += 1;
+        } else {
+            *error = "The host name is too long!\n";
+            return -1;
+        }
+
+        const struct addrinfo hints = {
+            .ai_family = AF_UNSPEC,
+            .ai_socktype = SOCK_STREAM,
+            .ai_flags = AI_PASSIVE,
+        };
+
+        struct addrinfo* found = NULL;
+
+        if(getaddrinfo(host[0] != '\0' ? host : NULL,port,&hints,&found) != 0 || found == NULL) {
+            *error = "The address could not be resolved!\n";
+            return -1;
+        }
+
+        listener = socket(found->ai_family,SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,0);
+
+        const int reuse = 1;
+        if(listener >= 0) setsockopt(listener,SOL_SOCKET,SO_REUSEADDR,&reuse,sizeof(reuse));
+        if(listener >= 0 && share_port) setsockopt(listener,SOL_SOCKET,SO_REUSEPORT,&reuse,sizeof(reuse));
+
+        if(listener < 0 || bind(listener,found->ai_addr,found->ai_addrlen) != 0) *error = "The TCP socket could not be bound!\n";
+
+        freeaddrinfo(found);
+    }
+
+    if(*error == NULL && listen(listener,SERVER_LISTEN_BACKLOG) != 0) *error = "The socket could not listen!\n";
+
+    if(*error != NULL) {
+        if(listener >= 0) close(listener);
+        return -1;
+    }
+
+    return listener;
+}
+
+bool open_server_listeners(const char *const address, const unsigned int count, int* listeners, validate_message* error) {
+    if(strncmp(address,"unix:",5) == 0) {
+        const int listener = open_server_listener(address,false,error);
+
+        for(unsigned int thread = 0;thread < count;thread++) listeners[thread] = listener;
+
+        return *error == NULL;
+    }
+
+    // A socket without `SO_REUSEPORT` cannot be bound next to sockets of another server that has it, nor they next to it
+    const int probe = open_server_listener(address,false,error);
+    if(*error != NULL) return false;
+
+    close(probe);
+
+    for(unsigned int thread = 0;thread < count;thread++) {
+        listeners[thread] = open_server_listener(address,true,error);
+
+        if(*error != NULL) {
+            for(unsigned int opened = 0;opened < thread;opened++) close(listeners[opened]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+game_server create_game_server(const int listener, const int wake, const unsigned int maximum_connections) {
+    game_server server = {
+        .epoll = epoll_create1(EPOLL_CLOEXEC),
+        .listener = listener,
+        .wake = wake,
+        .maximum_connections = maximum_connections,
+        .slots_used = 0,
+        .first_free = maximum_connections,
+    };
+
+    if(server.epoll < 0) {
+        perror("epoll_create1 has failed");
+        exit(1);
+    }
+
+    // calloc leaves the pages of the pool uncommitted until a slot is first taken
+    server.connections = calloc(maximum_connections,sizeof(server_connection));
+
+    if(server.connections == NULL) {
+        perror("calloc has failed");
+        exit(1);
+    }
+
+    struct epoll_event waking = { .events = EPOLLIN, .data.u64 = _WAKE_TAG };
+
+    if(!_watch_listener(&server) || epoll_ctl(server.epoll,EPOLL_CTL_ADD,wake,&waking) != 0) {
+        perror("epoll_ctl has failed");
+        exit(1);
+    }
+
+    return server;
+}
+
+void free_game_server(game_server server) {
+    for(unsigned int slot = 0;slot < server.slots_used;slot++) {
+        if(server.connections[slot].socket >= 0) close(server.connections[slot].socket);
+
+        free_arena(server.connections[slot].boards);
+    }
+
+    free(server.connections);
+    close(server.epoll);
+}
+
+void run_game_server(game_server* server) {
+    struct epoll_event events[SERVER_EVENTS_PER_WAIT];
+    bool running = true;
+
+    while(running) {
+        const int ready = epoll_wait(server->epoll,events,SERVER_EVENTS_PER_WAIT,-1);
+
+        if(ready < 0) {
+            if(errno == EINTR) continue;
+
+            perror("epoll_wait has failed");
+            exit(1);
+        }
+
+        for(int i = 0;i < ready;i++) {
+            const uint64_t tag = events[i].data.u64;
+
+            if(tag == _WAKE_TAG) {
+                running = false;
+                continue;
+            }
+
+            if(tag == _LISTENER_TAG) {
+                _accept_connections(server);
+
+                // Watched anew, the listener wakes the other threads that share it before this one again
+                if(epoll_ctl(server->epoll,EPOLL_CTL_DEL,server->listener,NULL) != 0 || !_watch_listener(server)) {
+                    perror("epoll_ctl has failed");
+                    exit(1);
+                }
+
+                continue;
+            }
+
+            server_connection* connection = server->connections + tag;
+            if(connection->socket < 0) continue;
+
+            bool open = (events[i].events & EPOLLERR) == 0;
+
+            if(open && connection->waiting_to_write) {
+                // Requests that came in while the replies were stuck are handled once they are gone
+                open = _send_replies(server,connection);
+                if(open && !connection->waiting_to_write) open = _handle_requests(server,connection);
+            }
+            else if(open) open = _read_requests(server,connection);
+
+            if(!open) _close_connection(server,connection);
+        }
+    }
+}
+
+bool _watch_listener(game_server* server) {
+    // Only one of the threads sharing a listener is woken for a new connection, the first one that watches it
+    struct epoll_event listening = { .events = EPOLLIN | EPOLLEXCLUSIVE, .data.u64 = _LISTENER_TAG };
+
+    return epoll_ctl(server->epoll,EPOLL_CTL_ADD,server->listener,&listening) == 0;
+}
+
+void _accept_connections(game_server* server) {
+    // The rest stays pending, so a shared listener wakes another thread for it instead of this one taking every connection
+    for(unsigned int accepts = 0;accepts < SERVER_ACCEPTS_PER_WAKEUP;accepts++) {
+        // Another thread may have taken the connection already, which leaves nothing to accept
+        const int socket = accept4(server->listener,NULL,NULL,SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(socket < 0) return;
+
+        unsigned int slot;
+
+        if(server->first_free != server->maximum_connections) {
+            slot = server->first_free;
+            server->first_free = server->connections[slot].next_free;
+        } else if(server->slots_used != server->maximum_connections) {
+            slot = server->slots_used++;
+            server->connections[slot].boards = create_arena(SERVER_ARENA_BLOCK_SIZE);
+        } else {
+            close(socket);
+            server->refused += 1;
+            continue;
+        }
+
+        // Replies are small and latency matters, this fails harmlessly on a Unix socket
+        const int no_delay = 1;
+        setsockopt(socket,IPPROTO_TCP,TCP_NODELAY,&no_delay,sizeof(no_delay));
+
+        server_connection* connection = server->connections + slot;
+
+        connection->socket = socket;
+        connection->waiting_to_write = false;
+        connection->input_length = 0;
+        connection->output_start = 0;
+        connection->output_end = 0;
+        connection->playing = false;
+
+        struct epoll_event reading = { .events = EPOLLIN, .data.u64 = slot };
+
+        if(epoll_ctl(server->epoll,EPOLL_CTL_ADD,socket,&reading) != 0) {
+            _close_connection(server,connection);
+            continue;
+        }
+
+        server->accepted += 1;
+    }
+}
+
+bool _read_requests(game_server* server, server_connection* connection) {
+    const ssize_t length = read(connection->socket,connection->input + connection->input_length,SERVER_INPUT_BUFFER_SIZE - connection->input_length);
+
+    // The client is gone
+    if(length == 0) return false;
+    if(length < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+
+    connection->input_length += (unsigned int) length;
+
+    return _handle_requests(server,connection);
+}
+
+bool _handle_requests(game_server* server, server_connection* connection) {
+    unsigned int start = 0;
+
+    while(true) {
+        // Move the unsent replies to the front once the room behind them runs short
+        if(SERVER_OUTPUT_BUFFER_SIZE - connection->output_end < SERVER_MAXIMUM_REPLY && connection->output_start != 0) {
+            memmove(connection->output,connection->output + connection->output_start,connection->output_end - connection->output_start);
+            connection->output_end -= connection->output_start;
+            connection->output_start = 0;
+        }
+
+        // The rest waits until the client has read some replies
+        if(SERVER_OUTPUT_BUFFER_SIZE - connection->output_end < SERVER_MAXIMUM_REPLY) break;
+
+        char* newline = memchr(connection->input + start,'\n',connection->input_length - start);
+        if(newline == NULL) break;
+
+        *newline = '\0';
+        if(newline > connection->input + start && newline[-1] == '\r') newline[-1] = '\0';
+
+        server->requests += 1;
+
+        // The replies to the requests before a `quit` still go out, as far as the socket takes them
+        if(!_handle_request(server,connection,connection->input + start)) {
+            _send_replies(server,connection);
+            return false;
+        }
+
+        start = (unsigned int)(newline - connection->input) + 1;
+    }
+
+    memmove(connection->input,connection->input + start,connection->input_length - start);
+    connection->input_length -= start;
+
+    // A full buffer without a newline is a request longer than any valid one
+    if(connection->input_length == SERVER_INPUT_BUFFER_SIZE) return false;
+
+    return _send_replies(server,connection);
+}
+
+bool _handle_request(game_server* server, server_connection* connection, char* request) {
+    if(strcmp(request,"roll") == 0) {
+        if(!connection->playing) {
+            _reply(connection,"error Start a game with new first!\n");
+            return true;
+        }
+
+        game* game = &connection->game;
+
+        if(game->finished) {
+            _reply(connection,"error The game is over, start a new one with new!\n");
+            return true;
+        }
+
+        const unsigned int player = game->current_player;
+        const unsigned int roll = _random_between(&connection->dice,1,6);
+
+        const turn_outcome outcome = game_apply_roll(game,roll);
+
+        char event = '.';
+
+        if(outcome == game_won) event = 'w';
+        else if(outcome == three_sixes) event = '3';
+        else if(game->last_move == climbed_ladder) event = 'l';
+        else if(game->last_move == bitten_by_snake) event = 's';
+        else if(game->last_move == move_past_finish) event = 'x';
+
+        if(outcome == game_won) server->games_won += 1;
+
+        _reply(connection,"m %u %u %u %c %u\n",player + 1,roll,connection->players[player].position,event,game->current_player + 1);
+    }
+    else if(strncmp(request,"new ",4) == 0) {
+        const validate_message error = _start_connection_game(connection,request + 4);
+
+        if(error != NULL) _reply(connection,"error %s",error);
+        else {
+            const board board = connection->game.board;
+            _reply(connection,"board %u %u %u %u\n",board.board_size,board.jumps.number_of_cells,board.number_of_ladders,board.number_of_snakes);
+        }
+    }
+    else if(strcmp(request,"state") == 0) {
+        if(!connection->playing) {
+            _reply(connection,"error Start a game with new first!\n");
+            return true;
+        }
+
+        const game game = connection->game;
+
+        // The positions are written in one go, the longest state still fits `SERVER_MAXIMUM_REPLY`
+        char positions[MAXIMUM_NUMBER_OF_PLAYERS * 12];
+        unsigned int length = 0;
+
+        for(unsigned int player = 0;player < game.board.number_of_players;player++) {
+            length += (unsigned int) snprintf(positions + length,sizeof(positions) - length,player == 0 ? "%u" : ",%u",connection->players[player].position);
+        }
+
+        _reply(connection,"state %u %u %s\n",game.round,game.current_player + 1,positions);
+    }
+    else if(strcmp(request,"quit") == 0) return false;
+    else if(*request != '\0') _reply(connection,"error Unknown request, the requests are new, roll, state and quit!\n");
+
+    return true;
+}
+
+validate_message _start_connection_game(server_connection* connection, const char* arguments) {
+    char* end;
+
+    const unsigned long players = strtoul(arguments,&end,10);
+    const bool players_read = end != arguments;
+
+    const char* next = end;
+    const unsigned long difficulty = strtoul(next,&end,10);
+    const bool difficulty_read = end != next;
+
+    next = end;
+    errno = 0;
+    const unsigned long long seed = strtoull(next,&end,10);
+
+    if(!players_read || !difficulty_read || end == next || *end != '\0') return "A game is started with new <players> <difficulty> <seed>!\n";
+
+    // `strtoull` saturates too large seeds at `ULLONG_MAX` and wraps negative ones, either would be another game than asked for
+    while(*next == ' ' || *next == '\t') next++;
+    if(errno == ERANGE || *next == '-') return "The seed has to be a number from 0 to 18446744073709551615!\n";
+
+    validate_message message = ensure_players_within_1_10(players > UINT_MAX ? UINT_MAX : (validate_int) players);
+    if(message == NULL) message = ensure_difficulty_within_1_10(difficulty > UINT_MAX ? UINT_MAX : (validate_int) difficulty);
+    if(message != NULL) return message;
+
+    const config config = {
+        .number_of_players = (unsigned int) players,
+        .difficulty = (unsigned int) difficulty,
+        .seed = seed,
+    };
+
+    // The previous board of the connection goes with the reset
+    arena_reset(&connection->boards);
+
+    const board board = generate_board_in_arena(config,&connection->boards);
+
+    // `game` holds a board with constant members, so it is built in place
+    const game game = new_game(board,connection->players);
+    memcpy(&connection->game,&game,sizeof(game));
+
+    // The dice of game 0 of the board in `simulate_games`
+    connection->dice = rng_for_stream(seed,1);
+    connection->playing = true;
+
+    return NULL;
+}
+
+void _reply(server_connection* connection, const char *const format, ...) {
+    va_list arguments;
+    va_start(arguments,format);
+
+    const int length = vsnprintf(connection->output + connection->output_end,SERVER_OUTPUT_BUFFER_SIZE - connection->output_end,format,arguments);
+
+    va_end(arguments);
+
+    if(length > 0) connection->output_end += (unsigned int) length;
+}
+
+bool _send_replies(game_server* server, server_connection* connection) {
+    while(connection->output_start < connection->output_end) {
+        const ssize_t sent = send(connection->socket,connection->output + connection->output_start,connection->output_end - connection->output_start,MSG_NOSIGNAL);
+
+        if(sent < 0) {
+            if(errno == EINTR) continue;
+            if(errno == EAGAIN || errno == EWOULDBLOCK) break;
+
+            return false;
+        }
+
+        connection->output_start += (unsigned int) sent;
+    }
+
+    if(connection->output_start == connection->output_end) {
+        connection->output_start = 0;
+        connection->output_end = 0;
+    }
+
+    // Only the socket taking output again is waited for while replies are stuck, so no more requests are read
+    const bool waiting = connection->output_end != 0;
+
+    if(waiting != connection->waiting_to_write) {
+        struct epoll_event watched = {
+            .events = waiting ? EPOLLOUT : EPOLLIN,
+            .data.u64 = (uint64_t)(connection - server->connections),
+        };
+
+        if(epoll_ctl(server->epoll,EPOLL_CTL_MOD,connection->socket,&watched) != 0) return false;
+
+        connection->waiting_to_write = waiting;
+    }
+
+    return true;
+}
+
+void _close_connection(game_server* server, server_connection* connection) {
+    // Closing the socket removes it from the epoll instance
+    close(connection->socket);
+
+    connection->socket = -1;
+    connection->playing = false;
+
+    const unsigned int slot = (unsigned int)(connection - server->connections);
+
+    connection->next_free = server->first_free;
+    server->first_free = slot;
+}
+
+#endif // defined(__linux__)
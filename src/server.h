@@ -0,0 +1,158 @@
+/**
+ * @file CSnakeLadderServer.h
+ * @brief Header file containing the game server of Snake and Ladder, which hosts many games in one process.
+ *
+ * Every event loop thread of the server is a `game_server` with its own epoll instance and its own pool of `server_connection`s. For TCP every thread has a listening socket of its own on the same port (`SO_REUSEPORT`), and the kernel spreads new connections over them; a Unix socket is shared by all threads, which take a few connections at a time from it. Nothing blocks: sockets are non-blocking, replies are queued in the output buffer of their connection and sent when the socket takes them, and the buffers and board arena of a connection are reused by the next client that takes its slot.
+ *
+ * A client sends one request per line and gets one reply line per request:
+ *
+ *     new <players> <difficulty> <seed>   ->  board <board size> <cells> <ladders> <snakes>
+ *     roll                                ->  m <player> <roll> <position> <event> <next player>
+ *     state                               ->  state <round> <current player> <position of player 1>,...
+ *     quit                                ->  (the connection is closed)
+ *
+ * `new` generates the board of the configuration with `generate_board_from_config` and starts a game on it, whose dice are seeded with stream 1 of the seed, so it is the very game `simulate_game` plays as game 0 of the board. A `roll` reply is the delta of one roll: players are counted from 1, and `event` is `.` for an ordinary move, `l` for a ladder, `s` for a snake, `x` for a move past the finish, `3` for three sixes and `w` when the game is won. Anything that cannot be done is answered with `error <message>`. The server is only available on Linux.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_SERVER_H
+#define CSNAKE_LADDER_SERVER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "config.h"
+#include "board.h"
+#include "game.h"
+#include "arena.h"
+#include "rng.h"
+
+#if defined(__linux__)
+
+/**
+ * @def SERVER_EVENTS_PER_WAIT
+ * @brief The most events one call of `epoll_wait` returns.
+ */
+#define SERVER_EVENTS_PER_WAIT 256
+
+/**
+ * @def SERVER_ACCEPTS_PER_WAKEUP
+ * @brief The most connections a thread accepts before it goes back to `epoll_wait`.
+ */
+#define SERVER_ACCEPTS_PER_WAKEUP 8
+
+/**
+ * @def SERVER_LISTEN_BACKLOG
+ * @brief The backlog of the listening socket.
+ */
+#define SERVER_LISTEN_BACKLOG 4096
+
+/**
+ * @brief Function to open a non-blocking listening socket.
+ *
+ * @param address `unix:<path>` for a Unix socket (an old socket file is replaced), `<port>` for TCP on every interface or `<host>:<port>` for TCP on one.
+ * @param share_port Whether more sockets can be bound to the same TCP port with `SO_REUSEPORT`, which the kernel then spreads new connections over. Ignored for a Unix socket.
+ * @param error Pointer that receives a message describing why the socket could not be opened, or `NULL` on success.
+ * @return The socket, or -1.
+ */
+int open_server_listener(const char *const address, const bool share_port, validate_message* error);
+
+/**
+ * @brief Function to open a listening socket for every event loop thread of the server.
+ *
+ * For TCP every thread gets a socket of its own on the same port. Before they are bound, the port is opened once without `SO_REUSEPORT`, so a port that another server already listens on is reported instead of shared with it. A Unix socket cannot be shared like that, so every thread gets the same one.
+ *
+ * @param address The address, as for `open_server_listener`.
+ * @param count The number of threads.
+ * @param listeners Array of `count` sockets that receives the listeners. (Caller needs to close each distinct one)
+ * @param error Pointer that receives a message describing why the sockets could not be opened, or `NULL` on success.
+ * @return True if every listener was opened, False otherwise, in which case none is left open.
+ */
+bool open_server_listeners(const char *const address, const unsigned int count, int* listeners, validate_message* error);
+
+/**
+ * @brief Function to create an event loop thread of the server.
+ *
+ * @param listener The listening socket, see `open_server_listener`.
+ * @param wake A descriptor that becomes readable when the server has to stop, such as an eventfd. It is never read, so one descriptor stops every thread.
+ * @param maximum_connections The number of connections the thread can hold, later ones are refused.
+ * @return The `game_server`. (Caller needs to release it with `free_game_server`)
+ */
+game_server create_game_server(const int listener, const int wake, const unsigned int maximum_connections);
+
+/**
+ * @brief Frees a game server, closing the connections it still holds. The listener and the wake descriptor are left open.
+ */
+void free_game_server(game_server server);
+
+/**
+ * @brief Runs the event loop of a game server until its wake descriptor becomes readable.
+ *
+ * @param server Pointer to the `game_server`.
+ */
+void run_game_server(game_server* server);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief Function to add the listener to the epoll instance of a server, at the end of the threads it wakes for a new connection.
+ *
+ * @return `false` if `epoll_ctl` has failed.
+ */
+bool _watch_listener(game_server* server);
+
+/**
+ * @brief Function to accept up to `SERVER_ACCEPTS_PER_WAKEUP` pending connections, those without a free slot are refused.
+ */
+void _accept_connections(game_server* server);
+
+/**
+ * @brief Function to read from a connection and handle the requests that arrived.
+ *
+ * @return `false` if the connection has to be closed.
+ */
+bool _read_requests(game_server* server, server_connection* connection);
+
+/**
+ * @brief Function to handle every complete request in the input buffer, for as long as the output buffer has room for the reply.
+ *
+ * @return `false` if the connection has to be closed.
+ */
+bool _handle_requests(game_server* server, server_connection* connection);
+
+/**
+ * @brief Function to handle one request.
+ *
+ * @param request The request, without its newline.
+ * @return `false` if the connection has to be closed.
+ */
+bool _handle_request(game_server* server, server_connection* connection, char* request);
+
+/**
+ * @brief Function to start a game on a connection, from the arguments of a `new` request.
+ *
+ * @return A validation message, or `NULL` if the game was started.
+ */
+validate_message _start_connection_game(server_connection* connection, const char* arguments);
+
+/**
+ * @brief Function to queue a reply in the output buffer of a connection.
+ */
+void _reply(server_connection* connection, const char *const format, ...);
+
+/**
+ * @brief Function to send as much of the output buffer as the socket takes, and to wait for the socket if it did not take all of it.
+ *
+ * @return `false` if the connection has to be closed.
+ */
+bool _send_replies(game_server* server, server_connection* connection);
+
+/**
+ * @brief Function to close a connection and return its slot to the pool.
+ */
+void _close_connection(game_server* server, server_connection* connection);
+
+#endif // defined(__linux__)
+
+#endif // CSNAKE_LADDER_SERVER_H
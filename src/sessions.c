@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "types.h"
+#include "config.h"
+#include "board.h"
+#include "scheduler.h"
+#include "simulation.h"
+#include "timer.h"
+
+// Plays many games at once on a work-stealing pool of threads, see scheduler.h.
+//
+// Usage: sessions [sessions] [workers] [humans per thousand] [players] [difficulty]
+//
+// The sessions are played on `SESSIONS_BOARDS` boards; session `i` is game `i / SESSIONS_BOARDS` of board
+// `i % SESSIONS_BOARDS`, as `simulate_games` numbers them. In `humans per thousand` of the sessions the first
+// player is a human, whose rolls are asked for by a separate thread, a round over all humans every
+// `SESSIONS_HUMAN_PAUSE` microseconds, like input arriving from terminals or a server. Every finished game is
+// checked against `simulate_game`, and the time sessions spent runnable in a queue is reported to show how
+// fairly the workers took turns. The exit status is 2 if any game did not match.
+
+#define SESSIONS_DEFAULT_SESSIONS 10000
+#define SESSIONS_DEFAULT_WORKERS 4
+#define SESSIONS_DEFAULT_HUMANS 10
+#define SESSIONS_DEFAULT_PLAYERS 4
+#define SESSIONS_DEFAULT_DIFFICULTY 2
+#define SESSIONS_BOARDS 16
+#define SESSIONS_HUMAN_PAUSE 100
+
+typedef struct sessions_humans {
+    session_scheduler* scheduler;
+    session** sessions;
+    unsigned int number_of_sessions;
+    _Atomic bool done;
+} sessions_humans;
+
+static void* _play_humans(void* argument) {
+    sessions_humans* humans = argument;
+
+    const struct timespec pause = { .tv_sec = 0, .tv_nsec = SESSIONS_HUMAN_PAUSE * 1000 };
+
+    // A request for a session that is not waiting is kept for its next human turn
+    while(!atomic_load(&humans->done)) {
+        for(unsigned int i = 0;i < humans->number_of_sessions;i++) request_session_roll(humans->scheduler,humans->sessions[i]);
+
+        nanosleep(&pause,NULL);
+    }
+
+    return NULL;
+}
+
+static int _compare_waits(const void* left, const void* right) {
+    const uint64_t left_wait = *(const uint64_t*) left;
+    const uint64_t right_wait = *(const uint64_t*) right;
+
+    return (left_wait > right_wait) - (left_wait < right_wait);
+}
+
+int main(int argc, char** argv) {
+    if(argc > 6) {
+        fprintf(stderr,"Usage: %s [sessions] [workers] [humans per thousand] [players] [difficulty]\n",argv[0]);
+        return 1;
+    }
+
+    const unsigned int number_of_sessions = argc > 1 ? (unsigned int) strtoul(argv[1],NULL,10) : SESSIONS_DEFAULT_SESSIONS;
+    const unsigned int workers = argc > 2 ? (unsigned int) strtoul(argv[2],NULL,10) : SESSIONS_DEFAULT_WORKERS;
+    const unsigned int humans_per_thousand = argc > 3 ? (unsigned int) strtoul(argv[3],NULL,10) : SESSIONS_DEFAULT_HUMANS;
+    const unsigned int players = argc > 4 ? (unsigned int) strtoul(argv[4],NULL,10) : SESSIONS_DEFAULT_PLAYERS;
+    const unsigned int difficulty = argc > 5 ? (unsigned int) strtoul(argv[5],NULL,10) : SESSIONS_DEFAULT_DIFFICULTY;
+
+    validate_message message = ensure_players_within_1_10(players);
+    if(message == NULL) message = ensure_difficulty_within_1_10(difficulty);
+
+    if(message != NULL || number_of_sessions < 1 || workers < 1) {
+        fprintf(stderr,"%s",message != NULL ? message : "At least one session and one worker are needed!\n");
+        return 1;
+    }
+
+    board boards[SESSIONS_BOARDS];
+
+    for(unsigned int i = 0;i < SESSIONS_BOARDS;i++) {
+        const config config = { .number_of_players = players, .difficulty = difficulty, .seed = i + 1 };
+
+        // `board` has constant members, so it is built in place
+        const board board = generate_board_from_config(config);
+        memcpy(&boards[i],&board,sizeof(board));
+    }
+
+    session* sessions = calloc(number_of_sessions,sizeof(session));
+    session** humans = malloc(number_of_sessions * sizeof(session*));
+    uint64_t* waits = malloc(number_of_sessions * sizeof(uint64_t));
+
+    if(sessions == NULL || humans == NULL || waits == NULL) {
+        perror("malloc has failed");
+        return 1;
+    }
+
+    unsigned int number_of_humans = 0;
+
+    for(unsigned int i = 0;i < number_of_sessions;i++) {
+        session_controller controllers[MAXIMUM_NUMBER_OF_PLAYERS] = { controller_bot };
+
+        if(i % 1000 < humans_per_thousand) {
+            controllers[0] = controller_human;
+            humans[number_of_humans++] = sessions + i;
+        }
+
+        const board board = boards[i % SESSIONS_BOARDS];
+        start_session(sessions + i,board,controllers,rng_stream_seed(board.config.seed,i / SESSIONS_BOARDS + 1));
+    }
+
+    session_scheduler scheduler;
+    start_session_scheduler(&scheduler,workers);
+
+    sessions_humans human_players = {
+        .scheduler = &scheduler,
+        .sessions = humans,
+        .number_of_sessions = number_of_humans,
+    };
+    atomic_init(&human_players.done,false);
+
+    pthread_t human_thread;
+
+    if(pthread_create(&human_thread,NULL,_play_humans,&human_players) != 0) {
+        perror("pthread_create has failed");
+        return 1;
+    }
+
+    const uint64_t started = monotonic_nanoseconds();
+
+    for(unsigned int i = 0;i < number_of_sessions;i++) submit_session(&scheduler,sessions + i);
+
+    wait_for_sessions(&scheduler);
+
+    const double seconds = (monotonic_nanoseconds() - started) / 1e9;
+
+    atomic_store(&human_players.done,true);
+    pthread_join(human_thread,NULL);
+
+    unsigned long long rolls = 0;
+
+    for(unsigned int index = 0;index < workers;index++) {
+        const session_worker worker = scheduler.workers[index];
+
+        printf("worker %u: %llu rolls in %llu quanta, %llu steals, %llu sleeps\n",index,worker.rolls,worker.quanta,worker.steals,worker.sleeps);
+        rolls += worker.rolls;
+    }
+
+    stop_session_scheduler(&scheduler);
+
+    // Every session is checked against the same game played on its own
+    const simulation_options options = { 0 };
+    unsigned int mismatched = 0;
+    uint64_t total_wait = 0;
+    unsigned long long quanta = 0;
+
+    for(unsigned int i = 0;i < number_of_sessions;i++) {
+        const session* session = sessions + i;
+        const board board = boards[i % SESSIONS_BOARDS];
+        const game_result expected = simulate_game(board,rng_stream_seed(board.config.seed,i / SESSIONS_BOARDS + 1),options);
+
+        if(!session->game.finished || session->game.winner != expected.winner || session->game.rolls != expected.rolls || session->game.turns != expected.turns) mismatched += 1;
+
+        total_wait += session->total_wait;
+        quanta += session->quanta;
+        waits[i] = session->longest_wait;
+    }
+
+    qsort(waits,number_of_sessions,sizeof(uint64_t),_compare_waits);
+
+    printf("%u sessions (%u with a human) on %u workers: %llu rolls in %.2fs (%.0f rolls per second), %u mismatched\n",
+        number_of_sessions,number_of_humans,workers,rolls,seconds,rolls / seconds,mismatched
+    );
+
+    printf("queue wait: %.1fus per quantum, longest wait of a session: median %.1fus, p99 %.1fus, worst %.1fus\n",
+        quanta != 0 ? total_wait / 1e3 / quanta : 0,
+        waits[number_of_sessions / 2] / 1e3,waits[(number_of_sessions - 1) * 99 / 100] / 1e3,waits[number_of_sessions - 1] / 1e3
+    );
+
+    for(unsigned int i = 0;i < SESSIONS_BOARDS;i++) free_board(boards[i]);
+
+    free(waits);
+    free(humans);
+    free(sessions);
+
+    return mismatched == 0 ? 0 : 2;
+}
@@ -0,0 +1,97 @@
+#include "simulation.h"
+
+game_result simulate_game(const board board, const uint64_t seed, const simulation_options options) {
+    // Positions are kept on the stack, so the board itself is never written to
+    player players[MAXIMUM_NUMBER_OF_PLAYERS];
+
+    TRACE_BEGIN(game);
+
+    rng dice = rng_from_seed(seed);
+
+    game game = new_game(board,players);
+
+    while(!game.finished) {
+        if(options.maximum_rounds != 0 && game.round >= options.maximum_rounds) break;
+
+        game_apply_roll(&game,_random_between(&dice,1,6));
+    }
+
+    const game_result result = {
+        .finished = game.finished,
+        .winner = game.winner,
+        .rounds = game.finished ? game.round + 1 : game.round,
+        .turns = game.turns,
+        .rolls = game.rolls,
+        .ladder_hits = game.ladder_hits,
+        .snake_hits = game.snake_hits,
+        .invalidated_moves = game.invalidated_moves,
+    };
+
+    TRACE_END(span_simulate_game,game);
+    return result;
+}
+
+void simulate_games(const board board, const unsigned int first_game, const unsigned int number_of_games, const simulation_options options, game_result* results) {
+#if defined(__AVX2__)
+    // The lanes gather from the flat jump table, which sparse boards do not have
+    if(board.jumps.destination != NULL) {
+        simulate_games_in_lanes(board,first_game,number_of_games,options,results);
+        return;
+    }
+#endif
+
+    for(unsigned int i = 0;i < number_of_games;i++) {
+        results[i] = simulate_game(board,rng_stream_seed(board.config.seed,first_game + i + 1),options);
+    }
+}
+
+simulation_summary simulate_many(config config, const unsigned int number_of_games) {
+    board board = generate_board_from_config(config);
+
+    const simulation_summary summary = simulate_board(board,number_of_games);
+
+    free_board(board);
+
+    return summary;
+}
+
+simulation_summary simulate_board(const board board, const unsigned int number_of_games) {
+    const simulation_options options = { 0 };
+
+    simulation_summary summary = { 0 };
+
+    const clock_t started = clock();
+
+    game_result results[SIMULATION_BATCH_SIZE];
+
+    for(unsigned int first = 0;first < number_of_games;first += SIMULATION_BATCH_SIZE) {
+        const unsigned int count = number_of_games - first < SIMULATION_BATCH_SIZE ? number_of_games - first : SIMULATION_BATCH_SIZE;
+
+        // Every game gets its own stream of the config seed, the board was generated from the seed itself
+        simulate_games(board,first,count,options,results);
+
+        for(unsigned int i = 0;i < count;i++) _add_to_summary(&summary,results[i]);
+    }
+
+    summary.elapsed_seconds = (double)(clock() - started) / CLOCKS_PER_SEC;
+
+    return summary;
+}
+
+void _add_to_summary(simulation_summary* summary, const game_result result) {
+    if(summary->games == 0 || result.rounds < summary->minimum_rounds) summary->minimum_rounds = result.rounds;
+    if(result.rounds > summary->maximum_rounds) summary->maximum_rounds = result.rounds;
+
+    summary->games += 1;
+
+    if(result.finished) {
+        summary->finished_games += 1;
+        summary->wins[result.winner] += 1;
+    }
+
+    summary->total_rounds += result.rounds;
+    summary->total_turns += result.turns;
+    summary->total_rolls += result.rolls;
+    summary->total_ladder_hits += result.ladder_hits;
+    summary->total_snake_hits += result.snake_hits;
+}
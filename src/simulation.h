@@ -0,0 +1,80 @@
+/**
+ * @file CSnakeLadderSimulation.h
+ * @brief Header file containing the headless simulation of Snake and Ladder games.
+ *
+ * This header file defines functions that play complete games with the same rules as the interactive game, but without any input, output or delays, so that boards can be evaluated by playing them many times.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_SIMULATION_H
+#define CSNAKE_LADDER_SIMULATION_H
+
+#include <time.h>
+
+#include "types.h"
+#include "board.h"
+#include "game.h"
+#include "rng.h"
+#include "lanes.h"
+
+/**
+ * @def SIMULATION_BATCH_SIZE
+ * @brief The number of games `simulate_board` hands to `simulate_games` at once.
+ */
+#define SIMULATION_BATCH_SIZE 1024
+
+/**
+ * @brief Function to play a single game on a board until a player wins.
+ *
+ * The board is only read, the positions of the players are kept by the simulation itself.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param seed The seed used for the dice rolls of this game.
+ * @param options The `simulation_options` limiting the game.
+ * @return A `game_result` describing how the game went.
+ */
+game_result simulate_game(const board board, const uint64_t seed, const simulation_options options);
+
+/**
+ * @brief Function to play a range of games on a board.
+ *
+ * Game `i` is seeded with stream `i + 1` of the seed in `board.config`. With AVX2 the games of a dense board are played eight at a time by `simulate_games_in_lanes`, otherwise one after the other by `simulate_game`; both give the very same results.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param first_game The index of the first game of the range.
+ * @param number_of_games The number of games to play.
+ * @param options The `simulation_options` limiting every game.
+ * @param results Array of `number_of_games` results, game `first_game + i` is written to `results[i]`.
+ */
+void simulate_games(const board board, const unsigned int first_game, const unsigned int number_of_games, const simulation_options options, game_result* results);
+
+/**
+ * @brief Function to generate a board from a configuration and play many games on it.
+ *
+ * Game `i` is seeded with stream `i + 1` of `config.seed`, so the whole batch is reproducible from the configuration.
+ *
+ * @param config The configuration structure containing game setup details (number of players, difficulty, etc.).
+ * @param number_of_games The number of games to play on the generated board.
+ * @return A `simulation_summary` aggregating the results of all games.
+ */
+simulation_summary simulate_many(config config, const unsigned int number_of_games);
+
+/**
+ * @brief Function to play many games on an existing board, such as one mapped with `load_board`.
+ *
+ * Game `i` is seeded with stream `i + 1` of the seed in `board.config`, so for a generated board this plays the very same games as `simulate_many`.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param number_of_games The number of games to play.
+ * @return A `simulation_summary` aggregating the results of all games.
+ */
+simulation_summary simulate_board(const board board, const unsigned int number_of_games);
+
+/**
+ * @brief Function to add the result of a single game to a summary.
+ *
+ * @param summary Pointer to the `simulation_summary` to update.
+ * @param result The `game_result` to add.
+ */
+void _add_to_summary(simulation_summary* summary, const game_result result);
+
+#endif // CSNAKE_LADDER_SIMULATION_H
@@ -0,0 +1,773 @@
+#include "solver.h"
+
+/**
+ * @brief The number of (destination, probability) pairs one turn can produce: five rolls at each of three sixes deep, plus the invalidated third six.
+ */
+#define _TURN_OUTCOMES 16
+
+/**
+ * @brief The number of roll states of a label: no six, one six or two sixes rolled so far in the turn.
+ */
+#define _ROLL_STATES_PER_LABEL 3
+
+/**
+ * @brief The number of columns of the system over the returns that `_factor_absorbing` substitutes at once.
+ */
+#define _SYSTEM_COLUMNS_AT_ONCE 4
+
+/**
+ * @brief The roll state of a label after a number of sixes. The more sixes, the lower the state, so that the third six, which goes back to no six on the same label, moves up the order.
+ */
+#define _ROLL_STATE(label,sixes) (_ROLL_STATES_PER_LABEL * ((label) - 1) + (_ROLL_STATES_PER_LABEL - 1 - (sixes)))
+
+/**
+ * @brief The number of sixes rolled so far in a roll state.
+ */
+#define _ROLL_STATE_SIXES(state) (_ROLL_STATES_PER_LABEL - 1 - (state) % _ROLL_STATES_PER_LABEL)
+
+static void* _allocate(const size_t size) {
+    void* memory = malloc(size);
+
+    if(size != 0 && memory == NULL) {
+        perror("malloc has failed");
+        exit(1);
+    }
+
+    return memory;
+}
+
+static inline unsigned int _label_after_roll(const jump_table jumps, const unsigned int label, const unsigned int roll) {
+    const unsigned int target = label + roll;
+
+    // Rolls past the final cell are invalidated, the player stays put
+    if(target > jumps.number_of_cells) return label;
+
+    return jump_destination(jumps,target);
+}
+
+board_solution solve_board(const board board) {
+    const unsigned int number_of_states = board.jumps.number_of_cells - 1;
+
+    // A board of one cell is won before the first turn, and there is no state to allocate anything for
+    if(number_of_states == 0) {
+        const board_solution solved = {
+            .expected_turns = 0,
+            .variance = 0,
+            .number_of_turns = 1,
+            .finish_probability = calloc(1,sizeof(double)),
+            .remaining_probability = 0,
+            .tail_ratio = 0,
+        };
+
+        if(solved.finish_probability == NULL) {
+            perror("calloc has failed");
+            exit(1);
+        }
+
+        return solved;
+    }
+
+    // The moments are solved roll by roll, where only snakes lead back down the board
+    const unsigned int number_of_roll_states = _ROLL_STATES_PER_LABEL * number_of_states;
+
+    double* turn_end = _allocate(number_of_roll_states * sizeof(double));
+    const transition_matrix rolls = _build_roll_matrix(board,turn_end);
+    const absorbing_factorization factorization = _factor_absorbing(rolls);
+
+    // Expected turns: t = c + R t, where c is the chance that the next roll ends the turn
+    double* expected = _allocate(number_of_roll_states * sizeof(double));
+
+    _solve_absorbing(&factorization,turn_end,expected);
+
+    // Second moment: m = c + 2 R' t + R m, where R' only holds the rolls that end the turn, reusing `turn_end`
+    double* second_moment = _allocate(number_of_roll_states * sizeof(double));
+
+    for(unsigned int i = 0;i < number_of_roll_states;i++) {
+        double ending = 0;
+
+        for(unsigned int k = rolls.row_start[i];k < rolls.row_start[i + 1];k++) {
+            if(_ROLL_STATE_SIXES(rolls.column[k]) == 0) ending += rolls.probability[k] * expected[rolls.column[k]];
+        }
+
+        turn_end[i] += 2 * ending;
+    }
+
+    _solve_absorbing(&factorization,turn_end,second_moment);
+
+    const unsigned int start = _ROLL_STATE(1,0);
+
+    board_solution solution = {
+        .expected_turns = expected[start],
+        .variance = second_moment[start] - expected[start] * expected[start],
+    };
+
+    free(turn_end);
+    free(expected);
+    free(second_moment);
+    _free_absorbing_factorization(factorization);
+    _free_transition_matrix(rolls);
+
+    double* absorption = _allocate(number_of_states * sizeof(double));
+    const transition_matrix transient = _build_turn_matrix(board,absorption);
+
+    // Distribution: push the probability of every state one turn forward until (almost) nothing is left,
+    // only visiting the window of states that still hold any of it
+    const transition_matrix incoming = _transpose_matrix(transient);
+
+    unsigned int* lowest_destination = _allocate(number_of_states * sizeof(unsigned int));
+    unsigned int* highest_destination = _allocate(number_of_states * sizeof(unsigned int));
+
+    for(unsigned int i = 0;i < number_of_states;i++) {
+        lowest_destination[i] = number_of_states;
+        highest_destination[i] = 0;
+
+        for(unsigned int k = transient.row_start[i];k < transient.row_start[i + 1];k++) {
+            if(transient.column[k] < lowest_destination[i]) lowest_destination[i] = transient.column[k];
+            if(transient.column[k] > highest_destination[i]) highest_destination[i] = transient.column[k];
+        }
+    }
+
+    double* current = calloc(number_of_states,sizeof(double));
+    double* next = calloc(number_of_states,sizeof(double));
+
+    if(current == NULL || next == NULL) {
+        perror("calloc has failed");
+        exit(1);
+    }
+
+    unsigned int capacity = 1024;
+    double* finish_probability = _allocate(capacity * sizeof(double));
+    finish_probability[0] = 0;
+
+    unsigned int number_of_turns = 1;
+    unsigned int lowest = 0;
+    unsigned int highest = 0;
+    double remaining = 1;
+
+    // Once the distribution has mixed, the probability left shrinks by the same factor every turn. Summed over
+    // every turn, P(T > k) gives the expected turns and (2k + 1) P(T > k) the second moment, so the ratio that
+    // makes a geometric tail add up to the first is checked against the second
+    const double expected_square = solution.variance + solution.expected_turns * solution.expected_turns;
+
+    double first_sum = 1;
+    double second_sum = 1;
+    double ratio = 0;
+    unsigned int steady_turns = 0;
+
+    current[0] = 1;
+
+    while(remaining > SOLVER_TOLERANCE && number_of_turns < SOLVER_MAXIMUM_TURNS && steady_turns < SOLVER_TAIL_TURNS) {
+        double finished = 0;
+        unsigned int next_lowest = number_of_states;
+        unsigned int next_highest = 0;
+
+        for(unsigned int i = lowest;i <= highest;i++) {
+            if(current[i] == 0) continue;
+
+            finished += current[i] * absorption[i];
+
+            if(lowest_destination[i] < next_lowest) next_lowest = lowest_destination[i];
+            if(highest_destination[i] > next_highest) next_highest = highest_destination[i];
+        }
+
+        if(number_of_turns == capacity) {
+            capacity *= 2;
+            finish_probability = realloc(finish_probability,capacity * sizeof(double));
+
+            if(finish_probability == NULL) {
+                perror("realloc has failed");
+                exit(1);
+            }
+        }
+
+        finish_probability[number_of_turns] = finished;
+        number_of_turns += 1;
+
+        if(next_lowest > next_highest) {
+            // Everything that was left has finished
+            remaining = 0;
+            ratio = 0;
+            break;
+        }
+
+        remaining = 0;
+
+        for(unsigned int j = next_lowest;j <= next_highest;j++) {
+            next[j] = _row_dot(incoming,j,current);
+            remaining += next[j];
+        }
+
+        // `remaining` is P(T > number_of_turns - 1), and the tail holds the turns after it
+        first_sum += remaining;
+        second_sum += (2.0 * number_of_turns - 1) * remaining;
+
+        const double first_tail = solution.expected_turns - first_sum;
+        const double second_tail = expected_square - second_sum;
+
+        ratio = first_tail > 0 ? first_tail / (remaining + first_tail) : 0;
+
+        const double predicted = (2.0 * number_of_turns - 1) * first_tail + 2 * remaining * ratio / ((1 - ratio) * (1 - ratio));
+
+        if(fabs(predicted - second_tail) <= SOLVER_TAIL_TOLERANCE * second_tail) steady_turns += 1;
+        else steady_turns = 0;
+
+        // The old window becomes the output of the next turn, so it has to be cleared
+        memset(current + lowest,0,(highest - lowest + 1) * sizeof(double));
+
+        double* swap = current;
+        current = next;
+        next = swap;
+
+        lowest = next_lowest;
+        highest = next_highest;
+
+        // Shrink the window past states whose probability has become negligible
+        while(lowest < highest && current[lowest] < SOLVER_TOLERANCE * SOLVER_TOLERANCE) current[lowest++] = 0;
+        while(highest > lowest && current[highest] < SOLVER_TOLERANCE * SOLVER_TOLERANCE) current[highest--] = 0;
+    }
+
+    solution.number_of_turns = number_of_turns;
+    solution.finish_probability = finish_probability;
+    solution.remaining_probability = remaining;
+    solution.tail_ratio = remaining > 0 ? ratio : 0;
+
+    free(current);
+    free(next);
+    free(lowest_destination);
+    free(highest_destination);
+    free(absorption);
+    _free_transition_matrix(incoming);
+    _free_transition_matrix(transient);
+
+    return solution;
+}
+
+double solve_expected_turns(const board board) {
+    const unsigned int number_of_states = board.jumps.number_of_cells - 1;
+
+    // A board of one cell is won before the first turn
+    if(number_of_states == 0) return 0;
+
+    const unsigned int number_of_roll_states = _ROLL_STATES_PER_LABEL * number_of_states;
+
+    double* turn_end = _allocate(number_of_roll_states * sizeof(double));
+    const transition_matrix rolls = _build_roll_matrix(board,turn_end);
+    const absorbing_factorization factorization = _factor_absorbing(rolls);
+
+    double* expected = _allocate(number_of_roll_states * sizeof(double));
+
+    _solve_absorbing(&factorization,turn_end,expected);
+
+    const double expected_turns = expected[_ROLL_STATE(1,0)];
+
+    free(turn_end);
+    free(expected);
+    _free_absorbing_factorization(factorization);
+    _free_transition_matrix(rolls);
+
+    return expected_turns;
+}
+
+void free_board_solution(board_solution solution) {
+    free(solution.finish_probability);
+}
+
+double expected_rounds_for_players(const board_solution solution, const unsigned int number_of_players) {
+    double expected = 0;
+    double still_playing = 1;
+
+    // E[R] is the sum over k of P(R > k) = P(T > k) ^ players
+    for(unsigned int k = 0;k < solution.number_of_turns;k++) {
+        still_playing -= solution.finish_probability[k];
+
+        if(still_playing < 0) still_playing = 0;
+
+        expected += pow(still_playing,number_of_players);
+    }
+
+    // Past the last turn P(T > k) keeps shrinking by `tail_ratio`, a geometric series
+    const double tail_ratio = pow(solution.tail_ratio,number_of_players);
+
+    if(tail_ratio < 1) expected += pow(solution.remaining_probability,number_of_players) * tail_ratio / (1 - tail_ratio);
+
+    return expected;
+}
+
+transition_matrix _build_turn_matrix(const board board, double* absorption) {
+    const jump_table jumps = board.jumps;
+    const unsigned int number_of_states = jumps.number_of_cells - 1;
+
+    transition_matrix matrix = {
+        .number_of_rows = number_of_states,
+        .row_start = _allocate((number_of_states + 1) * sizeof(unsigned int)),
+        .column = _allocate((size_t) number_of_states * _TURN_OUTCOMES * sizeof(unsigned int)),
+        .probability = _allocate((size_t) number_of_states * _TURN_OUTCOMES * sizeof(double)),
+    };
+
+    unsigned int number_of_entries = 0;
+
+    for(unsigned int state = 0;state < number_of_states;state++) {
+        unsigned int destination[_TURN_OUTCOMES];
+        double probability[_TURN_OUTCOMES];
+        unsigned int number_of_outcomes = 0;
+
+        // Walk the six-chain: `chance` is the probability of having rolled only sixes so far
+        unsigned int label = state + 1;
+        double chance = 1.0;
+
+        for(unsigned int sixes = 0;sixes < 3;sixes++) {
+            for(unsigned int roll = 1;roll <= 5;roll++) {
+                destination[number_of_outcomes] = _label_after_roll(jumps,label,roll);
+                probability[number_of_outcomes] = chance / 6;
+                number_of_outcomes += 1;
+            }
+
+            chance /= 6;
+
+            if(sixes == 2) {
+                // Three consecutive sixes, the third move is invalidated
+                destination[number_of_outcomes] = label;
+                probability[number_of_outcomes] = chance;
+                number_of_outcomes += 1;
+                break;
+            }
+
+            label = _label_after_roll(jumps,label,6);
+
+            // Reaching the final cell on a six ends the game there and then
+            if(label == jumps.number_of_cells) {
+                destination[number_of_outcomes] = label;
+                probability[number_of_outcomes] = chance;
+                number_of_outcomes += 1;
+                break;
+            }
+        }
+
+        matrix.row_start[state] = number_of_entries;
+        absorption[state] = 0;
+
+        for(unsigned int i = 0;i < number_of_outcomes;i++) {
+            if(destination[i] == jumps.number_of_cells) {
+                absorption[state] += probability[i];
+                continue;
+            }
+
+            const unsigned int column = destination[i] - 1;
+
+            // Merge outcomes that lead to the same state, a row only holds a handful of entries
+            unsigned int k = matrix.row_start[state];
+            while(k < number_of_entries && matrix.column[k] != column) k++;
+
+            if(k == number_of_entries) {
+                matrix.column[k] = column;
+                matrix.probability[k] = 0;
+                number_of_entries += 1;
+            }
+
+            matrix.probability[k] += probability[i];
+        }
+    }
+
+    matrix.row_start[number_of_states] = number_of_entries;
+
+    return matrix;
+}
+
+transition_matrix _build_roll_matrix(const board board, double* turn_end) {
+    const jump_table jumps = board.jumps;
+    const unsigned int number_of_states = _ROLL_STATES_PER_LABEL * (jumps.number_of_cells - 1);
+
+    transition_matrix matrix = {
+        .number_of_rows = number_of_states,
+        .row_start = _allocate((number_of_states + 1) * sizeof(unsigned int)),
+        .column = _allocate((size_t) number_of_states * 6 * sizeof(unsigned int)),
+        .probability = _allocate((size_t) number_of_states * 6 * sizeof(double)),
+    };
+
+    unsigned int number_of_entries = 0;
+
+    for(unsigned int label = 1;label < jumps.number_of_cells;label++) {
+        for(unsigned int sixes = _ROLL_STATES_PER_LABEL;sixes-- > 0;) {
+            const unsigned int state = _ROLL_STATE(label,sixes);
+
+            // Every roll but a six that is followed by another roll ends the turn
+            turn_end[state] = 1;
+            matrix.row_start[state] = number_of_entries;
+
+            for(unsigned int roll = 1;roll <= 6;roll++) {
+                unsigned int destination;
+
+                if(roll < 6) destination = _ROLL_STATE(_label_after_roll(jumps,label,roll),0);
+                else if(sixes == 2) destination = _ROLL_STATE(label,0);
+                else destination = _ROLL_STATE(_label_after_roll(jumps,label,6),sixes + 1);
+
+                // Reaching the final cell ends the game there and then
+                if(destination >= number_of_states) continue;
+
+                if(roll == 6 && sixes < 2) turn_end[state] -= 1.0 / 6;
+
+                unsigned int k = matrix.row_start[state];
+                while(k < number_of_entries && matrix.column[k] != destination) k++;
+
+                if(k == number_of_entries) {
+                    matrix.column[k] = destination;
+                    matrix.probability[k] = 0;
+                    number_of_entries += 1;
+                }
+
+                matrix.probability[k] += 1.0 / 6;
+            }
+        }
+    }
+
+    matrix.row_start[number_of_states] = number_of_entries;
+
+    return matrix;
+}
+
+transition_matrix _transpose_matrix(const transition_matrix matrix) {
+    const unsigned int number_of_rows = matrix.number_of_rows;
+    const unsigned int number_of_entries = matrix.row_start[number_of_rows];
+
+    transition_matrix transposed = {
+        .number_of_rows = number_of_rows,
+        .row_start = calloc(number_of_rows + 1,sizeof(unsigned int)),
+        .column = _allocate(number_of_entries * sizeof(unsigned int)),
+        .probability = _allocate(number_of_entries * sizeof(double)),
+    };
+
+    if(transposed.row_start == NULL) {
+        perror("calloc has failed");
+        exit(1);
+    }
+
+    // Counting sort of the entries by column
+    for(unsigned int k = 0;k < number_of_entries;k++) {
+        transposed.row_start[matrix.column[k] + 1] += 1;
+    }
+
+    for(unsigned int i = 0;i < number_of_rows;i++) {
+        transposed.row_start[i + 1] += transposed.row_start[i];
+    }
+
+    unsigned int* fill = _allocate(number_of_rows * sizeof(unsigned int));
+    memcpy(fill,transposed.row_start,number_of_rows * sizeof(unsigned int));
+
+    for(unsigned int row = 0;row < number_of_rows;row++) {
+        for(unsigned int k = matrix.row_start[row];k < matrix.row_start[row + 1];k++) {
+            const unsigned int slot = fill[matrix.column[k]]++;
+
+            transposed.column[slot] = row;
+            transposed.probability[slot] = matrix.probability[k];
+        }
+    }
+
+    free(fill);
+
+    return transposed;
+}
+
+void _free_transition_matrix(transition_matrix matrix) {
+    free(matrix.row_start);
+    free(matrix.column);
+    free(matrix.probability);
+}
+
+double _row_dot(const transition_matrix matrix, const unsigned int row, const double* vector) {
+    const unsigned int* restrict column = matrix.column;
+    const double* restrict probability = matrix.probability;
+
+    unsigned int k = matrix.row_start[row];
+    const unsigned int end = matrix.row_start[row + 1];
+
+    double sum = 0;
+
+#if defined(__AVX2__)
+    __m256d accumulator = _mm256_setzero_pd();
+
+    for(;k + 4 <= end;k += 4) {
+        const __m128i indices = _mm_loadu_si128((const __m128i*)(column + k));
+        const __m256d gathered = _mm256_i32gather_pd(vector,indices,sizeof(double));
+
+        accumulator = _mm256_add_pd(accumulator,_mm256_mul_pd(gathered,_mm256_loadu_pd(probability + k)));
+    }
+
+    double lanes[4];
+    _mm256_storeu_pd(lanes,accumulator);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+    for(;k < end;k++) {
+        sum += probability[k] * vector[column[k]];
+    }
+
+    return sum;
+}
+
+absorbing_factorization _factor_absorbing(const transition_matrix matrix) {
+    const unsigned int number_of_rows = matrix.number_of_rows;
+    const unsigned int number_of_entries = matrix.row_start[number_of_rows];
+
+    absorbing_factorization factorization = {
+        .forward = {
+            .number_of_rows = number_of_rows,
+            .row_start = _allocate((number_of_rows + 1) * sizeof(unsigned int)),
+            .column = _allocate(number_of_entries * sizeof(unsigned int)),
+            .probability = _allocate(number_of_entries * sizeof(double)),
+        },
+        .leave = _allocate(number_of_rows * sizeof(double)),
+        .highest_source = 0,
+    };
+
+    // The return each state is, or `UINT_MAX`, and the number of moves back down onto it
+    unsigned int* return_of = _allocate(number_of_rows * sizeof(unsigned int));
+    unsigned int number_of_backward = 0;
+
+    for(unsigned int i = 0;i < number_of_rows;i++) {
+        return_of[i] = UINT_MAX;
+    }
+
+    unsigned int forward_entries = 0;
+
+    for(unsigned int i = 0;i < number_of_rows;i++) {
+        factorization.forward.row_start[i] = forward_entries;
+        factorization.leave[i] = 1;
+
+        for(unsigned int k = matrix.row_start[i];k < matrix.row_start[i + 1];k++) {
+            const unsigned int column = matrix.column[k];
+
+            if(column == i) factorization.leave[i] = 1 / (1 - matrix.probability[k]);
+            else if(column > i) {
+                factorization.forward.column[forward_entries] = column;
+                factorization.forward.probability[forward_entries] = matrix.probability[k];
+                forward_entries += 1;
+            } else {
+                return_of[column] = 0;
+                number_of_backward += 1;
+                factorization.highest_source = i;
+            }
+        }
+    }
+
+    factorization.forward.row_start[number_of_rows] = forward_entries;
+
+    // Number the returns in ascending order
+    unsigned int number_of_returns = 0;
+
+    for(unsigned int i = 0;i < number_of_rows;i++) {
+        if(return_of[i] != UINT_MAX) return_of[i] = number_of_returns++;
+    }
+
+    factorization.number_of_returns = number_of_returns;
+    factorization.return_state = _allocate(number_of_returns * sizeof(unsigned int));
+
+    for(unsigned int i = 0;i < number_of_rows;i++) {
+        if(return_of[i] != UINT_MAX) factorization.return_state[return_of[i]] = i;
+    }
+
+    // Group the moves back down by their return, with a counting sort
+    transition_matrix backward = {
+        .number_of_rows = number_of_returns,
+        .row_start = calloc(number_of_returns + 1,sizeof(unsigned int)),
+        .column = _allocate(number_of_backward * sizeof(unsigned int)),
+        .probability = _allocate(number_of_backward * sizeof(double)),
+    };
+
+    if(backward.row_start == NULL) {
+        perror("calloc has failed");
+        exit(1);
+    }
+
+    for(unsigned int i = 0;i < number_of_rows;i++) {
+        for(unsigned int k = matrix.row_start[i];k < matrix.row_start[i + 1];k++) {
+            if(matrix.column[k] < i) backward.row_start[return_of[matrix.column[k]] + 1] += 1;
+        }
+    }
+
+    for(unsigned int a = 0;a < number_of_returns;a++) {
+        backward.row_start[a + 1] += backward.row_start[a];
+    }
+
+    unsigned int* fill = _allocate(number_of_returns * sizeof(unsigned int));
+    memcpy(fill,backward.row_start,number_of_returns * sizeof(unsigned int));
+
+    for(unsigned int i = 0;i < number_of_rows;i++) {
+        for(unsigned int k = matrix.row_start[i];k < matrix.row_start[i + 1];k++) {
+            if(matrix.column[k] >= i) continue;
+
+            const unsigned int slot = fill[return_of[matrix.column[k]]]++;
+
+            backward.column[slot] = i;
+            backward.probability[slot] = matrix.probability[k];
+        }
+    }
+
+    free(fill);
+    free(return_of);
+
+    factorization.backward = backward;
+
+    // Column `a` of the system over the returns is the identity minus U⁻¹ L e_a, read at the returns,
+    // and `_SYSTEM_COLUMNS_AT_ONCE` columns are substituted side by side
+    const size_t size = number_of_returns;
+    double* system = _allocate(size * size * sizeof(double));
+    double* columns = calloc((size_t) number_of_rows * _SYSTEM_COLUMNS_AT_ONCE,sizeof(double));
+
+    if(columns == NULL) {
+        perror("calloc has failed");
+        exit(1);
+    }
+
+    for(unsigned int first = 0;first < number_of_returns;first += _SYSTEM_COLUMNS_AT_ONCE) {
+        const unsigned int width = number_of_returns - first < _SYSTEM_COLUMNS_AT_ONCE ? number_of_returns - first : _SYSTEM_COLUMNS_AT_ONCE;
+        unsigned int highest = 0;
+
+        for(unsigned int w = 0;w < width;w++) {
+            for(unsigned int k = backward.row_start[first + w];k < backward.row_start[first + w + 1];k++) {
+                columns[(size_t) backward.column[k] * _SYSTEM_COLUMNS_AT_ONCE + w] = backward.probability[k];
+                if(backward.column[k] > highest) highest = backward.column[k];
+            }
+        }
+
+        _back_substitute(&factorization,columns,_SYSTEM_COLUMNS_AT_ONCE,highest);
+
+        for(unsigned int w = 0;w < width;w++) {
+            for(unsigned int b = 0;b < number_of_returns;b++) {
+                system[b * size + first + w] = (first + w == b) - columns[(size_t) factorization.return_state[b] * _SYSTEM_COLUMNS_AT_ONCE + w];
+            }
+        }
+
+        memset(columns,0,((size_t) highest + 1) * _SYSTEM_COLUMNS_AT_ONCE * sizeof(double));
+    }
+
+    free(columns);
+
+    // LU factors with partial pivoting, the system is small and dense
+    factorization.pivot = _allocate(size * sizeof(unsigned int));
+
+    for(unsigned int k = 0;k < number_of_returns;k++) {
+        unsigned int pivot = k;
+
+        for(unsigned int i = k + 1;i < number_of_returns;i++) {
+            if(fabs(system[i * size + k]) > fabs(system[pivot * size + k])) pivot = i;
+        }
+
+        factorization.pivot[k] = pivot;
+
+        if(pivot != k) {
+            for(unsigned int j = 0;j < number_of_returns;j++) {
+                const double swap = system[k * size + j];
+                system[k * size + j] = system[pivot * size + j];
+                system[pivot * size + j] = swap;
+            }
+        }
+
+        for(unsigned int i = k + 1;i < number_of_returns;i++) {
+            const double factor = system[i * size + k] / system[k * size + k];
+            system[i * size + k] = factor;
+
+            if(factor == 0) continue;
+
+            for(unsigned int j = k + 1;j < number_of_returns;j++) {
+                system[i * size + j] -= factor * system[k * size + j];
+            }
+        }
+    }
+
+    factorization.returns_system = system;
+
+    return factorization;
+}
+
+void _free_absorbing_factorization(absorbing_factorization factorization) {
+    _free_transition_matrix(factorization.forward);
+    _free_transition_matrix(factorization.backward);
+    free(factorization.leave);
+    free(factorization.return_state);
+    free(factorization.returns_system);
+    free(factorization.pivot);
+}
+
+void _back_substitute(const absorbing_factorization* factorization, double* vector, const unsigned int width, const unsigned int highest) {
+    const unsigned int* restrict row_start = factorization->forward.row_start;
+    const unsigned int* restrict column = factorization->forward.column;
+    const double* restrict probability = factorization->forward.probability;
+
+    // Every move up the board leads to a state that is already solved. Rows of the roll matrix hold a few entries,
+    // too few for `_row_dot` to gather them, and the vectors side by side hide the latency of the division
+    for(unsigned int i = highest + 1;i-- > 0;) {
+        const double leave = factorization->leave[i];
+        double* restrict row = vector + (size_t) i * width;
+
+        for(unsigned int k = row_start[i];k < row_start[i + 1];k++) {
+            const double* restrict above = vector + (size_t) column[k] * width;
+
+            for(unsigned int w = 0;w < width;w++) row[w] += probability[k] * above[w];
+        }
+
+        for(unsigned int w = 0;w < width;w++) row[w] *= leave;
+    }
+}
+
+void _solve_absorbing(const absorbing_factorization* factorization, const double* right_hand_side, double* solution) {
+    const unsigned int number_of_rows = factorization->forward.number_of_rows;
+    const unsigned int number_of_returns = factorization->number_of_returns;
+
+    memcpy(solution,right_hand_side,number_of_rows * sizeof(double));
+    _back_substitute(factorization,solution,1,number_of_rows - 1);
+
+    // Without snakes the board only leads up, and the substitution is the solution
+    if(number_of_returns == 0) return;
+
+    const size_t size = number_of_returns;
+    const double* system = factorization->returns_system;
+
+    double* at_returns = _allocate(size * sizeof(double));
+
+    for(unsigned int a = 0;a < number_of_returns;a++) {
+        at_returns[a] = solution[factorization->return_state[a]];
+    }
+
+    for(unsigned int k = 0;k < number_of_returns;k++) {
+        const double swap = at_returns[k];
+        at_returns[k] = at_returns[factorization->pivot[k]];
+        at_returns[factorization->pivot[k]] = swap;
+    }
+
+    for(unsigned int i = 0;i < number_of_returns;i++) {
+        for(unsigned int j = 0;j < i;j++) at_returns[i] -= system[i * size + j] * at_returns[j];
+    }
+
+    for(unsigned int i = number_of_returns;i-- > 0;) {
+        for(unsigned int j = i + 1;j < number_of_returns;j++) at_returns[i] -= system[i * size + j] * at_returns[j];
+
+        at_returns[i] /= system[i * size + i];
+    }
+
+    // Add what the moves back down onto the returns contribute
+    const transition_matrix backward = factorization->backward;
+    const unsigned int highest = factorization->highest_source;
+
+    // Moves up from below `highest` read the states above it, which have to be 0
+    double* correction = calloc(number_of_rows,sizeof(double));
+
+    if(correction == NULL) {
+        perror("calloc has failed");
+        exit(1);
+    }
+
+    for(unsigned int a = 0;a < number_of_returns;a++) {
+        for(unsigned int k = backward.row_start[a];k < backward.row_start[a + 1];k++) {
+            correction[backward.column[k]] += backward.probability[k] * at_returns[a];
+        }
+    }
+
+    _back_substitute(factorization,correction,1,highest);
+
+    for(unsigned int i = 0;i <= highest;i++) {
+        solution[i] += correction[i];
+    }
+
+    free(correction);
+    free(at_returns);
+}
@@ -0,0 +1,166 @@
+/**
+ * @file CSnakeLadderSolver.h
+ * @brief Header file containing the exact Markov chain solver for Snake and Ladder boards.
+ *
+ * Snake and Ladder is an absorbing Markov chain: every turn moves a player from one cell to another with probabilities fixed by the board, until the final cell is reached. This header file defines functions that build the sparse turn transition matrix of a board (including the six-chain and three-sixes rules) and solve it for the expected game length, its variance and the full distribution of turns to finish, without playing a single game.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_SOLVER_H
+#define CSNAKE_LADDER_SOLVER_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+#if defined(__AVX2__)
+    # include <immintrin.h>
+#endif
+
+#include "types.h"
+#include "board.h"
+
+/**
+ * @def SOLVER_TOLERANCE
+ * @brief The probability left undecided at which the turn distribution is cut off.
+ */
+#define SOLVER_TOLERANCE 1e-12
+
+/**
+ * @def SOLVER_TAIL_TOLERANCE
+ * @brief How closely a geometric tail that makes up the rest of the expected turns has to make up the rest of the second moment as well, relative to that rest, for the distribution to be cut off with it.
+ */
+#define SOLVER_TAIL_TOLERANCE 1e-6
+
+/**
+ * @def SOLVER_TAIL_TURNS
+ * @brief The number of turns in a row the tail has to stay within `SOLVER_TAIL_TOLERANCE` before the distribution is cut off.
+ */
+#define SOLVER_TAIL_TURNS 8
+
+/**
+ * @def SOLVER_MAXIMUM_TURNS
+ * @brief The largest number of turns the turn distribution is computed for.
+ */
+#define SOLVER_MAXIMUM_TURNS 1000000
+
+/**
+ * @brief Function to compute the exact game length statistics of a board.
+ *
+ * The expected number of turns and its variance are solved directly. The distribution is pushed forward turn by turn until almost nothing is left, or until the probability left shrinks by the same factor every turn, from where on it is a geometric tail (see `board_solution.tail_ratio`). The factor is the one that makes the tail add up to the expected turns, and the tail is taken once it adds up to the second moment as well. Long games on large boards therefore cost a few thousand turns rather than the hundreds of thousands their tail would take.
+ *
+ * @param board The `board` structure representing the game board, with its `jumps` compiled.
+ * @return A `board_solution` with the expected number of turns, its variance and the distribution of turns to finish. (Caller needs to release it with `free_board_solution`)
+ */
+board_solution solve_board(const board board);
+
+/**
+ * @brief Function to compute only the expected number of turns a single player needs on a board.
+ *
+ * This is the first step of `solve_board`, without the variance and the distribution, for callers that only rank boards.
+ *
+ * @param board The `board` structure representing the game board, with its `jumps` compiled.
+ * @return The expected number of turns.
+ */
+double solve_expected_turns(const board board);
+
+/**
+ * @brief Frees the memory allocated for a `board_solution`.
+ */
+void free_board_solution(board_solution solution);
+
+/**
+ * @brief Function to compute the expected number of rounds of a game between several players.
+ *
+ * A game ends in the first round in which any player finishes, so the probability that it lasts more than `k` rounds is the probability that a single player needs more than `k` turns, to the power of the number of players. The geometric tail of the distribution is summed in closed form.
+ *
+ * @param solution The `board_solution` of the board.
+ * @param number_of_players The number of players in the game.
+ * @return The expected number of rounds.
+ */
+double expected_rounds_for_players(const board_solution solution, const unsigned int number_of_players);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief Function to build the turn transition matrix of a board.
+ *
+ * A turn is enumerated roll by roll: a six moves the player and rolls again, and the third six in a row leaves the player where the second one put them. The chance to reach the final cell is not stored in the matrix but in `absorption`.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param absorption Pointer to `number_of_cells - 1` elements, filled with the probability of finishing within one turn from each state.
+ * @return The `transition_matrix` between the transient states. (Caller needs to release it with `_free_transition_matrix`)
+ */
+transition_matrix _build_turn_matrix(const board board, double* absorption);
+
+/**
+ * @brief Function to build the roll transition matrix of a board, whose states are a label and the number of sixes rolled so far in the turn (see `_ROLL_STATE`).
+ *
+ * A turn that goes down a snake on a six carries on from the tail, so the turn matrix moves back to a spread of cells above every tail. Roll by roll, only the snakes themselves lead back down, which keeps the returns of `_factor_absorbing` to a few per snake.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param turn_end Pointer to `3 * (number_of_cells - 1)` elements, filled with the probability that the next roll from each state ends the turn, reaching the final cell included.
+ * @return The `transition_matrix` between the transient roll states. (Caller needs to release it with `_free_transition_matrix`)
+ */
+transition_matrix _build_roll_matrix(const board board, double* turn_end);
+
+/**
+ * @brief Function to transpose a `transition_matrix`, so that the entries flowing into a state form a row.
+ *
+ * @param matrix The matrix to transpose.
+ * @return The transposed matrix. (Caller needs to release it with `_free_transition_matrix`)
+ */
+transition_matrix _transpose_matrix(const transition_matrix matrix);
+
+/**
+ * @brief Frees the memory allocated for a `transition_matrix`.
+ */
+void _free_transition_matrix(transition_matrix matrix);
+
+/**
+ * @brief Function to compute the dot product of one row of a matrix with a dense vector.
+ *
+ * This is the kernel of every matrix operation in the solver. It gathers four elements of `vector` at a time when AVX2 is available.
+ *
+ * @param matrix The matrix.
+ * @param row The row to multiply.
+ * @param vector Pointer to the dense vector.
+ * @return The dot product.
+ */
+double _row_dot(const transition_matrix matrix, const unsigned int row, const double* vector);
+
+/**
+ * @brief Function to prepare the transient matrix `Q` for `_solve_absorbing`.
+ *
+ * `I - Q` is split into its upper triangle `U`, the moves up the board and staying put, and the moves back down, which only end on the returns `S`. A solution is `x = U⁻¹ b + U⁻¹ L x_S`, where `L` holds the moves back down, so `x_S` solves the dense system `(I - (U⁻¹ L)_S) x_S = (U⁻¹ b)_S`. Its matrix takes one backward substitution per return to build, and is factored once for every right hand side.
+ *
+ * @param matrix The transient `transition_matrix` `Q`.
+ * @return The `absorbing_factorization`. (Caller needs to release it with `_free_absorbing_factorization`)
+ */
+absorbing_factorization _factor_absorbing(const transition_matrix matrix);
+
+/**
+ * @brief Frees the memory allocated for an `absorbing_factorization`.
+ */
+void _free_absorbing_factorization(absorbing_factorization factorization);
+
+/**
+ * @brief Function to solve `U y = v` in place for `width` vectors side by side, from state `highest` down to the first one, for vectors that are 0 above `highest`.
+ *
+ * @param factorization Pointer to the `absorbing_factorization`.
+ * @param vector Pointer to the vectors, interleaved so that state `i` of vector `w` is at `i * width + w`, which receive the solutions.
+ * @param width The number of vectors.
+ * @param highest The highest state that the vectors may be nonzero in.
+ */
+void _back_substitute(const absorbing_factorization* factorization, double* vector, const unsigned int width, const unsigned int highest);
+
+/**
+ * @brief Function to solve `x = right_hand_side + Q x` for the transient matrix `Q` directly, with two backward substitutions and the factored system over the returns.
+ *
+ * @param factorization Pointer to the `absorbing_factorization` of `Q`.
+ * @param right_hand_side Pointer to the right hand side.
+ * @param solution Pointer to the solution.
+ */
+void _solve_absorbing(const absorbing_factorization* factorization, const double* right_hand_side, double* solution);
+
+#endif // CSNAKE_LADDER_SOLVER_H
@@ -0,0 +1,321 @@
+#include "storage.h"
+
+#ifdef _WIN32
+    # include <windows.h>
+#else
+    # include <fcntl.h>
+    # include <sys/mman.h>
+    # include <sys/stat.h>
+    # include <unistd.h>
+#endif
+
+// The arrays are written as they are in memory, which only works with these layouts
+_Static_assert(sizeof(unsigned int) == 4,"board files store labels as 32-bit integers");
+_Static_assert(sizeof(board_cell) == 8,"board files store a cell as a label and a role");
+_Static_assert(sizeof(ladder) == 16 && sizeof(snake) == 16,"board files store ladders and snakes as two points");
+_Static_assert(sizeof(board_file_header) % 8 == 0,"sections after the header start at a multiple of 8");
+
+static const char _magic[8] = { 'C', 'S', 'L', 'B', 'O', 'A', 'R', 'D' };
+
+#define _BYTE_ORDER_MARK 0x01020304u
+
+static inline uint64_t _aligned(const uint64_t size) {
+    return (size + 7) / 8 * 8;
+}
+
+static inline uint64_t _grids_size(const unsigned int board_size) {
+    return (uint64_t)(1 + NUMBER_OF_ROLES) * occupancy_grid_words(board_size) * sizeof(uint64_t);
+}
+
+validate_message save_board(const board board, const char *const path) {
+    // The format is the dense layout, mapped as it is
+    if(board_is_sparse(board)) return "Sparse boards cannot be saved!\n";
+
+    board_file_header header = _board_file_layout(board);
+    const uint64_t number_of_cells = (uint64_t) board.board_size * board.board_size;
+
+    // The whole file is put together in memory, so it is written with a single call
+    unsigned char* image = calloc(header.file_size,1);
+
+    if(image == NULL) {
+        perror("calloc has failed");
+        exit(1);
+    }
+
+    const size_t grid_bytes = occupancy_grid_words(board.board_size) * sizeof(uint64_t);
+
+    memcpy(image + header.grids_offset,board.occupied.words,grid_bytes);
+    for(int role = 0;role < NUMBER_OF_ROLES;role++) {
+        memcpy(image + header.grids_offset + (1 + role) * grid_bytes,board.role_grids[role].words,grid_bytes);
+    }
+
+    memcpy(image + header.cells_offset,board.inner_board,number_of_cells * sizeof(board_cell));
+    memcpy(image + header.ladders_offset,board.ladders,board.number_of_ladders * sizeof(ladder));
+    memcpy(image + header.snakes_offset,board.snakes,board.number_of_snakes * sizeof(snake));
+    memcpy(image + header.jumps_offset,board.jumps.destination,(number_of_cells + 1) * sizeof(unsigned int));
+
+    header.checksum = board_file_checksum(image + sizeof(board_file_header),header.file_size - sizeof(board_file_header));
+    memcpy(image,&header,sizeof(board_file_header));
+
+    // Write next to the file and rename, so that nobody ever maps half a board
+    const validate_message error = _write_file_atomically(path,image,header.file_size);
+
+    free(image);
+
+    return error;
+}
+
+board load_board(const char *const path, const bool verify_checksum, validate_message* error) {
+    const board empty = { 0 };
+    const board_mapping mapping = _map_file(path);
+
+    if(mapping.address == NULL) {
+        *error = "The board file could not be mapped!\n";
+        return empty;
+    }
+
+    *error = _check_board_file_header(mapping);
+
+    const unsigned char* base = mapping.address;
+    const board_file_header* header = mapping.address;
+
+    if(*error == NULL && verify_checksum) {
+        const uint64_t checksum = board_file_checksum(base + sizeof(board_file_header),header->file_size - sizeof(board_file_header));
+
+        if(checksum != header->checksum) *error = "The board file is corrupt, its checksum does not match!\n";
+    }
+
+    if(*error != NULL) {
+        unmap_board_file(mapping);
+        return empty;
+    }
+
+    const unsigned int board_size = header->board_size;
+    const size_t grid_words = occupancy_grid_words(board_size);
+    uint64_t* grids = (uint64_t*)(base + header->grids_offset);
+
+    const config config = {
+        .number_of_players = header->number_of_players,
+        .difficulty = header->difficulty,
+        .seed = header->seed,
+        .parameters = &header->parameters,
+    };
+
+    // Everything but the players points into the mapping
+    board board = {
+        .board_size = board_size,
+        .players = _create_players(header->number_of_players),
+        .number_of_players = header->number_of_players,
+        .inner_board = (board_cell*)(base + header->cells_offset),
+        .ladders = (ladder*)(base + header->ladders_offset),
+        .number_of_ladders = header->number_of_ladders,
+        .requested_ladders = header->requested_ladders,
+        .snakes = (snake*)(base + header->snakes_offset),
+        .number_of_snakes = header->number_of_snakes,
+        .requested_snakes = header->requested_snakes,
+        .config = config,
+        .mapping = mapping,
+    };
+
+    board.occupied = (occupancy_grid) {
+        .board_size = board_size,
+        .words_per_row = occupancy_words_per_row(board_size),
+        .words = grids,
+    };
+
+    for(int role = 0;role < NUMBER_OF_ROLES;role++) {
+        board.role_grids[role] = board.occupied;
+        board.role_grids[role].words = grids + (1 + role) * grid_words;
+    }
+
+    board.jumps = (jump_table) {
+        .number_of_cells = board_size * board_size,
+        .destination = (unsigned int*)(base + header->jumps_offset),
+    };
+
+    return board;
+}
+
+void unmap_board_file(board_mapping mapping) {
+    if(mapping.address == NULL) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(mapping.address);
+#else
+    munmap((void*) mapping.address,mapping.length);
+#endif
+}
+
+uint64_t board_file_checksum(const void* data, const size_t length) {
+    const uint64_t* words = data;
+    const size_t number_of_words = length / 8;
+
+    // Four independent lanes, so the multiplications of neighbouring words overlap
+    uint64_t lanes[4] = { 0x9E3779B97F4A7C15u, 0xBF58476D1CE4E5B9u, 0x94D049BB133111EBu, 0x2545F4914F6CDD1Du };
+    size_t i = 0;
+
+    for(;i + 4 <= number_of_words;i += 4) {
+        for(int lane = 0;lane < 4;lane++) {
+            const uint64_t mixed = (lanes[lane] ^ words[i + lane]) * 0xFF51AFD7ED558CCDu;
+            lanes[lane] = (mixed << 31) | (mixed >> 33);
+        }
+    }
+
+    for(;i < number_of_words;i++) {
+        const uint64_t mixed = (lanes[0] ^ words[i]) * 0xFF51AFD7ED558CCDu;
+        lanes[0] = (mixed << 31) | (mixed >> 33);
+    }
+
+    uint64_t checksum = length;
+
+    for(int lane = 0;lane < 4;lane++) {
+        checksum = (checksum ^ lanes[lane]) * 0xC4CEB9FE1A85EC53u;
+        checksum ^= checksum >> 29;
+    }
+
+    return checksum;
+}
+
+board_file_header _board_file_layout(const board board) {
+    const uint64_t number_of_cells = (uint64_t) board.board_size * board.board_size;
+
+    board_file_header header = {
+        .version = BOARD_FILE_VERSION,
+        .byte_order = _BYTE_ORDER_MARK,
+        .seed = board.config.seed,
+        .number_of_players = board.config.number_of_players,
+        .difficulty = board.config.difficulty,
+        .board_size = board.board_size,
+        .number_of_ladders = board.number_of_ladders,
+        .requested_ladders = board.requested_ladders,
+        .number_of_snakes = board.number_of_snakes,
+        .requested_snakes = board.requested_snakes,
+        .parameters = generation_parameters_of(board.config),
+    };
+
+    memcpy(header.magic,_magic,sizeof(_magic));
+
+    header.grids_offset = sizeof(board_file_header);
+    header.cells_offset = header.grids_offset + _grids_size(board.board_size);
+    header.ladders_offset = header.cells_offset + _aligned(number_of_cells * sizeof(board_cell));
+    header.snakes_offset = header.ladders_offset + _aligned((uint64_t) board.number_of_ladders * sizeof(ladder));
+    header.jumps_offset = header.snakes_offset + _aligned((uint64_t) board.number_of_snakes * sizeof(snake));
+    header.file_size = header.jumps_offset + _aligned((number_of_cells + 1) * sizeof(unsigned int));
+
+    return header;
+}
+
+board_mapping _map_file(const char *const path) {
+    board_mapping mapping = { 0 };
+
+#ifdef _WIN32
+    const HANDLE file = CreateFileA(path,GENERIC_READ,FILE_SHARE_READ | FILE_SHARE_DELETE,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,NULL);
+    if(file == INVALID_HANDLE_VALUE) return mapping;
+
+    LARGE_INTEGER size;
+    if(GetFileSizeEx(file,&size) && size.QuadPart != 0) {
+        const HANDLE view = CreateFileMappingA(file,NULL,PAGE_READONLY,0,0,NULL);
+
+        if(view != NULL) {
+            mapping.address = MapViewOfFile(view,FILE_MAP_READ,0,0,0);
+            mapping.length = (size_t) size.QuadPart;
+
+            // The view keeps the mapping alive
+            CloseHandle(view);
+        }
+    }
+
+    CloseHandle(file);
+#else
+    const int file = open(path,O_RDONLY);
+    if(file < 0) return mapping;
+
+    struct stat status;
+    if(fstat(file,&status) == 0 && status.st_size != 0) {
+        void* address = mmap(NULL,status.st_size,PROT_READ,MAP_SHARED,file,0);
+
+        if(address != MAP_FAILED) {
+            mapping.address = address;
+            mapping.length = status.st_size;
+        }
+    }
+
+    // The mapping keeps the file alive
+    close(file);
+#endif
+
+    if(mapping.address == NULL) mapping.length = 0;
+
+    return mapping;
+}
+
+validate_message _write_file_atomically(const char *const path, const void* data, const size_t size) {
+    const size_t path_length = strlen(path);
+    char* temporary_path = malloc(path_length + 5);
+
+    if(temporary_path == NULL) {
+        perror("malloc has failed");
+        exit(1);
+    }
+
+    memcpy(temporary_path,path,path_length);
+    memcpy(temporary_path + path_length,".tmp",5);
+
+    validate_message error = NULL;
+    FILE* file = fopen(temporary_path,"wb");
+
+    if(file == NULL) {
+        error = "The file could not be created!\n";
+    } else {
+        const bool written = fwrite(data,1,size,file) == size;
+
+        if(fclose(file) != 0 || !written) error = "The file could not be written!\n";
+    }
+
+#ifdef _WIN32
+    if(error == NULL && !MoveFileExA(temporary_path,path,MOVEFILE_REPLACE_EXISTING)) error = "The file could not be replaced!\n";
+#else
+    if(error == NULL && rename(temporary_path,path) != 0) error = "The file could not be replaced!\n";
+#endif
+
+    if(error != NULL) remove(temporary_path);
+
+    free(temporary_path);
+
+    return error;
+}
+
+validate_message _check_board_file_header(const board_mapping mapping) {
+    if(mapping.length < sizeof(board_file_header)) return "The board file is too short!\n";
+
+    const board_file_header* header = mapping.address;
+
+    if(memcmp(header->magic,_magic,sizeof(_magic)) != 0) return "The file is not a board file!\n";
+    if(header->byte_order != _BYTE_ORDER_MARK) return "The board file was saved with a different byte order!\n";
+    if(header->version != BOARD_FILE_VERSION) return "The board file was saved by a different version!\n";
+    if(header->file_size != mapping.length) return "The board file is truncated!\n";
+
+    if(header->board_size == 0 || header->board_size > 65535) return "The board file has an invalid board size!\n";
+    if(header->number_of_players < 1 || header->number_of_players > MAXIMUM_NUMBER_OF_PLAYERS) return "The board file has an invalid number of players!\n";
+
+    const uint64_t number_of_cells = (uint64_t) header->board_size * header->board_size;
+
+    // Every section has to start at a multiple of 8 and fit before the next one
+    const uint64_t starts[] = { header->grids_offset, header->cells_offset, header->ladders_offset, header->snakes_offset, header->jumps_offset, header->file_size };
+    const uint64_t sizes[] = {
+        _grids_size(header->board_size),
+        number_of_cells * sizeof(board_cell),
+        (uint64_t) header->number_of_ladders * sizeof(ladder),
+        (uint64_t) header->number_of_snakes * sizeof(snake),
+        (number_of_cells + 1) * sizeof(unsigned int),
+    };
+
+    if(starts[0] < sizeof(board_file_header)) return "The board file has overlapping sections!\n";
+
+    for(int section = 0;section < 5;section++) {
+        if(starts[section] % 8 != 0) return "The board file has misaligned sections!\n";
+        if(starts[section] > starts[section + 1] || sizes[section] > starts[section + 1] - starts[section]) return "The board file has overlapping sections!\n";
+    }
+
+    return NULL;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file CSnakeLadderStorage.h
+ * @brief Header file containing the on-disk format of Snake and Ladder boards.
+ *
+ * This header file defines functions that save a generated board, together with the configuration and seed it was generated from, and load it back by mapping the file into memory. The file holds the arrays of the board exactly as they are laid out in memory (see `board_file_header`), so loading involves no parsing and no copying: the loaded board points straight into the mapping, and every process that maps the same file shares its pages.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_STORAGE_H
+#define CSNAKE_LADDER_STORAGE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "board.h"
+
+/**
+ * @def BOARD_FILE_VERSION
+ * @brief The version of the board file format written by `save_board`. Files of other versions are refused.
+ */
+#define BOARD_FILE_VERSION 2
+
+/**
+ * @brief Function to save a board to a file.
+ *
+ * The file is written next to `path` first and then renamed over it, so processes that have the old file mapped keep seeing a complete board. Only dense boards can be saved, the file holds their arrays as they are.
+ *
+ * @param board The `board` structure representing the game board.
+ * @param path The path of the file.
+ * @return A message describing why the board could not be saved, or `NULL` on success.
+ */
+validate_message save_board(const board board, const char *const path);
+
+/**
+ * @brief Function to load a board saved with `save_board` by mapping its file read-only.
+ *
+ * The header is checked in constant time: magic, version, byte order, the size of the file and the bounds of every section. Checking the checksum reads the whole file, which is what mapping avoids, so it is optional.
+ *
+ * The loaded board is read-only, only its `players` are allocated. It has to be released with `free_board`, which unmaps the file. The `parameters` of its `config` point into the file as well, so a copy of the config must not be generated from after the board is freed.
+ *
+ * @param path The path of the file.
+ * @param verify_checksum Whether to verify the checksum of the file.
+ * @param error Pointer that receives a message describing why the board could not be loaded, or `NULL` on success.
+ * @return The loaded `board`, or a board with a `board_size` of 0 if it could not be loaded.
+ */
+board load_board(const char *const path, const bool verify_checksum, validate_message* error);
+
+/**
+ * @brief Unmaps the file of a loaded board. (Called by `free_board`)
+ */
+void unmap_board_file(board_mapping mapping);
+
+/**
+ * @brief Function to compute the checksum of a board file section.
+ *
+ * @param data Pointer to the data, aligned to 8 bytes.
+ * @param length The number of bytes, a multiple of 8.
+ * @return The checksum.
+ */
+uint64_t board_file_checksum(const void* data, const size_t length);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief Function to compute the layout of the file of a board.
+ *
+ * @param board The `board` structure representing the game board.
+ * @return A `board_file_header` with the counts and offsets of the sections filled in, but no checksum.
+ */
+board_file_header _board_file_layout(const board board);
+
+/**
+ * @brief Function to map a whole file read-only.
+ *
+ * @param path The path of the file.
+ * @return The `board_mapping`, whose `address` is `NULL` if the file could not be mapped.
+ */
+board_mapping _map_file(const char *const path);
+
+/**
+ * @brief Function to write a file by writing a temporary file next to it and renaming it over the old one, so readers never see a partial file.
+ *
+ * @param path The path of the file.
+ * @param data Pointer to the contents.
+ * @param size The number of bytes.
+ * @return A message describing why the file could not be written, or `NULL` on success.
+ */
+validate_message _write_file_atomically(const char *const path, const void* data, const size_t size);
+
+/**
+ * @brief Function to check that the header of a mapped file describes a board this version can use.
+ *
+ * @param mapping The mapping of the file.
+ * @return A message describing what is wrong, or `NULL` if the header is valid.
+ */
+validate_message _check_board_file_header(const board_mapping mapping);
+
+#endif // CSNAKE_LADDER_STORAGE_H
@@ -0,0 +1,24 @@
+#include "timer.h"
+
+#ifdef _WIN32
+    # include <windows.h>
+#else
+    # include <time.h>
+#endif
+
+uint64_t monotonic_nanoseconds() {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+
+    if(frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+
+    return (uint64_t)((double) counter.QuadPart * 1e9 / (double) frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC,&now);
+
+    return (uint64_t) now.tv_sec * 1000000000u + now.tv_nsec;
+#endif
+}
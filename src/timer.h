@@ -0,0 +1,22 @@
+/**
+ * @file CSnakeLadderTimer.h
+ * @brief Header file containing the monotonic clock used for measurements.
+ *
+ * This header file defines a single function returning a monotonic timestamp in nanoseconds, hiding the differences between the platforms the game builds on.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_TIMER_H
+#define CSNAKE_LADDER_TIMER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Function to read the monotonic clock.
+ *
+ * The clock never jumps backwards, but its zero is arbitrary, so only differences between two readings are meaningful.
+ *
+ * @return The current time in nanoseconds.
+ */
+uint64_t monotonic_nanoseconds();
+
+#endif // CSNAKE_LADDER_TIMER_H
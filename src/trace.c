@@ -0,0 +1,203 @@
+#include "trace.h"
+
+static const char *const _span_names[number_of_trace_spans] = {
+    "create_labeled_board",
+    "generate_ladders",
+    "generate_snakes",
+    "suggested_end_point",
+    "draw_line",
+    "compile_jump_table",
+    "apply_roll",
+    "simulate_game",
+    "render_board",
+    "run_timers",
+    "wait_for_input",
+};
+
+static const char *const _counter_names[number_of_trace_counters] = {
+    "start_retries",
+    "end_candidates",
+    "end_rejections",
+    "shortened_lines",
+    "rolls",
+    "rolls_again",
+    "three_sixes",
+    "moves_past_finish",
+    "ladder_hits",
+    "snake_hits",
+    "timers_fired",
+};
+
+const char* trace_span_name(const trace_span span) {
+    return _span_names[span];
+}
+
+const char* trace_counter_name(const trace_counter counter) {
+    return _counter_names[counter];
+}
+
+uint64_t _trace_percentile(const trace_histogram histogram, const double percentile) {
+    if(histogram.count == 0) return 0;
+
+    // Nearest rank, counted through the buckets
+    unsigned long long rank = (unsigned long long)(percentile * histogram.count + 0.999999);
+    if(rank == 0) rank = 1;
+
+    unsigned long long seen = 0;
+
+    for(unsigned int bucket = 0;bucket < TRACE_HISTOGRAM_BUCKETS;bucket++) {
+        seen += histogram.buckets[bucket];
+
+        if(seen >= rank) {
+            const uint64_t upper = bucket == 0 ? 0 : (UINT64_C(1) << bucket) - 1;
+            return upper < histogram.maximum_nanoseconds ? upper : histogram.maximum_nanoseconds;
+        }
+    }
+
+    return histogram.maximum_nanoseconds;
+}
+
+#if defined(CSNAKE_TRACE)
+
+// Everything is recorded per thread, like the generation stats, so recording never takes a lock
+static _Thread_local trace_stats _trace;
+static _Thread_local trace_event* _events;
+static _Thread_local size_t _number_of_events;
+static _Thread_local size_t _events_capacity;
+static _Thread_local const char* _events_path;
+
+void trace_record(const trace_span span, const uint64_t started, const uint64_t finished) {
+    const uint64_t duration = finished - started;
+    trace_histogram* histogram = &_trace.histograms[span];
+
+    if(histogram->count == 0 || duration < histogram->minimum_nanoseconds) histogram->minimum_nanoseconds = duration;
+    if(duration > histogram->maximum_nanoseconds) histogram->maximum_nanoseconds = duration;
+
+    histogram->count += 1;
+    histogram->total_nanoseconds += duration;
+    histogram->buckets[_trace_bucket(duration)] += 1;
+
+    if(_events_path == NULL || _number_of_events == TRACE_MAXIMUM_EVENTS) return;
+
+    if(_number_of_events == _events_capacity) {
+        _events_capacity = _events_capacity == 0 ? 4096 : _events_capacity * 2;
+        _events = realloc(_events,_events_capacity * sizeof(trace_event));
+
+        if(_events == NULL) {
+            perror("realloc has failed");
+            exit(1);
+        }
+    }
+
+    const trace_event event = {
+        .span = span,
+        .started = started,
+        .duration = duration,
+    };
+
+    _events[_number_of_events++] = event;
+}
+
+void trace_count(const trace_counter counter, const unsigned long long amount) {
+    _trace.counters[counter] += amount;
+}
+
+trace_stats current_trace_stats() {
+    return _trace;
+}
+
+void trace_begin_session(const char *const events_path) {
+    const trace_stats empty = { 0 };
+
+    _trace = empty;
+    _number_of_events = 0;
+    _events_path = events_path != NULL && *events_path != '\0' ? events_path : NULL;
+}
+
+void trace_end_session(FILE* report) {
+    fprintf(report,"%-22s %14s\n","counter","value");
+
+    for(int counter = 0;counter < number_of_trace_counters;counter++) {
+        fprintf(report,"%-22s %14llu\n",_counter_names[counter],_trace.counters[counter]);
+    }
+
+    fprintf(report,"\n%-22s %12s %14s %10s %10s %10s %10s %12s\n","span","count","total ns","mean ns","min ns","p50 ns","p99 ns","max ns");
+
+    for(int span = 0;span < number_of_trace_spans;span++) {
+        const trace_histogram histogram = _trace.histograms[span];
+        if(histogram.count == 0) continue;
+
+        fprintf(report,"%-22s %12llu %14llu %10.0f %10llu %10llu %10llu %12llu\n",
+            _span_names[span],histogram.count,histogram.total_nanoseconds,
+            (double) histogram.total_nanoseconds / histogram.count,
+            (unsigned long long) histogram.minimum_nanoseconds,
+            (unsigned long long) _trace_percentile(histogram,0.50),
+            (unsigned long long) _trace_percentile(histogram,0.99),
+            (unsigned long long) histogram.maximum_nanoseconds
+        );
+    }
+
+    // The histograms themselves, one line per span with the count of every bucket up to the last used one
+    fprintf(report,"\nhistograms (bucket i counts durations below 2^i ns):\n");
+
+    for(int span = 0;span < number_of_trace_spans;span++) {
+        const trace_histogram histogram = _trace.histograms[span];
+        if(histogram.count == 0) continue;
+
+        unsigned int last = TRACE_HISTOGRAM_BUCKETS - 1;
+        while(histogram.buckets[last] == 0) last--;
+
+        fprintf(report,"%-22s",_span_names[span]);
+        for(unsigned int bucket = 0;bucket <= last;bucket++) fprintf(report," %llu",histogram.buckets[bucket]);
+        fputc('\n',report);
+    }
+
+    if(_events_path != NULL) {
+        if(_trace_write_events(_events_path,_trace)) {
+            fprintf(report,"\n%zu events written to %s\n",_number_of_events,_events_path);
+        } else perror("Writing the trace events has failed");
+    }
+
+    free(_events);
+    _events = NULL;
+    _number_of_events = _events_capacity = 0;
+    _events_path = NULL;
+}
+
+bool _trace_write_events(const char *const path, const trace_stats stats) {
+    FILE* file = fopen(path,"w");
+    if(file == NULL) return false;
+
+    // Complete ("X") events in microseconds, relative to the earliest start. Events are recorded as they
+    // finish, so an enclosing span comes after the spans inside it
+    uint64_t origin = UINT64_MAX;
+    for(size_t i = 0;i < _number_of_events;i++) if(_events[i].started < origin) origin = _events[i].started;
+
+    fprintf(file,"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+    for(size_t i = 0;i < _number_of_events;i++) {
+        const trace_event event = _events[i];
+        const uint64_t started = event.started - origin;
+
+        fprintf(file,"%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}\n",
+            i == 0 ? "" : ",",
+            _span_names[event.span],
+            event.span <= span_compile_jump_table ? "generation" : "game",
+            started / 1000.0,
+            event.duration / 1000.0
+        );
+    }
+
+    fprintf(file,"],\"otherData\":{");
+
+    for(int counter = 0;counter < number_of_trace_counters;counter++) {
+        fprintf(file,"%s\"%s\":%llu",counter == 0 ? "" : ",",_counter_names[counter],stats.counters[counter]);
+    }
+
+    fprintf(file,"}}\n");
+
+    const bool written = !ferror(file);
+    return fclose(file) == 0 && written;
+}
+
+#endif // CSNAKE_TRACE
@@ -0,0 +1,147 @@
+/**
+ * @file CSnakeLadderTrace.h
+ * @brief Header file containing the optional instrumentation of board generation and the game loop.
+ *
+ * The instrumentation counts the retries of the generator and the steps of the game (see `trace_counter`), keeps a latency histogram of every generation phase and game-loop step (see `trace_span`), and can record every span as a Chrome trace, to be opened in `chrome://tracing` or Perfetto.
+ *
+ * It is only compiled in when `CSNAKE_TRACE` is defined (`-DCSNAKE_TRACE`). Otherwise the `TRACE_*` macros expand to nothing and the functions below are empty inline stubs, so the generator and the game loop do not read a single clock or touch a single counter for it.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_TRACE_H
+#define CSNAKE_LADDER_TRACE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "timer.h"
+
+/**
+ * @def TRACE_EVENTS_VARIABLE
+ * @brief The environment variable the tools read the path of the Chrome trace from.
+ */
+#define TRACE_EVENTS_VARIABLE "CSNAKE_TRACE_EVENTS"
+
+/**
+ * @def TRACE_MAXIMUM_EVENTS
+ * @brief The most events a session records, later ones are only counted in the histograms.
+ */
+#define TRACE_MAXIMUM_EVENTS (1 << 22)
+
+#if defined(CSNAKE_TRACE)
+
+/**
+ * @def TRACE_BEGIN
+ * @brief Starts timing a span under the local name `name`.
+ */
+#define TRACE_BEGIN(name) const uint64_t _trace_started_##name = monotonic_nanoseconds()
+
+/**
+ * @def TRACE_END
+ * @brief Finishes timing the span started under `name` and records it as `span`.
+ */
+#define TRACE_END(span, name) trace_record(span,_trace_started_##name,monotonic_nanoseconds())
+
+/**
+ * @def TRACE_COUNT
+ * @brief Adds one to a `trace_counter`.
+ */
+#define TRACE_COUNT(counter) trace_count(counter,1)
+
+/**
+ * @brief Function to record a finished span in its histogram, and as an event while a session records events.
+ *
+ * @param span The `trace_span`.
+ * @param started The monotonic time the span started at.
+ * @param finished The monotonic time the span finished at.
+ */
+void trace_record(const trace_span span, const uint64_t started, const uint64_t finished);
+
+/**
+ * @brief Function to add to a counter.
+ */
+void trace_count(const trace_counter counter, const unsigned long long amount);
+
+/**
+ * @brief Function to return what was recorded on the current thread since the last `trace_begin_session`.
+ */
+trace_stats current_trace_stats();
+
+/**
+ * @brief Function to start a session: clears the counters and histograms of the current thread.
+ *
+ * @param events_path The path the Chrome trace is written to by `trace_end_session`, or `NULL` not to record events.
+ */
+void trace_begin_session(const char *const events_path);
+
+/**
+ * @brief Function to end a session: prints the counters and histograms to `report` and writes the Chrome trace, if one was asked for.
+ *
+ * @param report The stream the report is printed to.
+ */
+void trace_end_session(FILE* report);
+
+#else
+
+#define TRACE_BEGIN(name) ((void) 0)
+#define TRACE_END(span, name) ((void) 0)
+#define TRACE_COUNT(counter) ((void) 0)
+
+static inline trace_stats current_trace_stats() {
+  const trace_stats empty = { 0 };
+  return empty;
+}
+
+static inline void trace_begin_session(const char *const events_path) {
+  (void) events_path;
+}
+
+static inline void trace_end_session(FILE* report) {
+  (void) report;
+}
+
+#endif // CSNAKE_TRACE
+
+/**
+ * @brief Returns the name of a `trace_span`.
+ */
+const char* trace_span_name(const trace_span span);
+
+/**
+ * @brief Returns the name of a `trace_counter`.
+ */
+const char* trace_counter_name(const trace_counter counter);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief Returns the histogram bucket of a duration.
+ */
+static inline unsigned int _trace_bucket(const uint64_t nanoseconds) {
+  unsigned int bucket = 0;
+
+  while(bucket < TRACE_HISTOGRAM_BUCKETS - 1 && (nanoseconds >> bucket) != 0) bucket++;
+
+  return bucket;
+}
+
+/**
+ * @brief Function to estimate a percentile of a histogram, as the upper bound of the bucket it falls into.
+ *
+ * @param histogram The `trace_histogram`.
+ * @param percentile The percentile (0-1).
+ * @return The estimate in nanoseconds, never more than the longest recorded duration.
+ */
+uint64_t _trace_percentile(const trace_histogram histogram, const double percentile);
+
+/**
+ * @brief Function to write the recorded events as a Chrome trace.
+ *
+ * @param path The path of the file.
+ * @param stats The `trace_stats`, whose counters are added as metadata.
+ * @return `true` if the file was written.
+ */
+bool _trace_write_events(const char *const path, const trace_stats stats);
+
+#endif // CSNAKE_LADDER_TRACE_H
@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "types.h"
+#include "config.h"
+#include "board.h"
+#include "library.h"
+#include "tuning.h"
+#include "timer.h"
+
+// Calibrates the generation parameters of every difficulty x players combination the config accepts.
+//
+// Usage: tuner <table.csv> <library directory> [shortest rounds] [longest rounds] [threads]
+//
+// Every difficulty level gets a target length in rounds, growing geometrically from `shortest rounds` at
+// difficulty 1 to `longest rounds` at difficulty 10, and `tune_generation_parameters` searches the parameters
+// whose boards play closest to it. The levels of a number of players are tuned in order, each search
+// starting from the parameters of the level below. The parameters are written as one CSV row per combination to
+// `table.csv`, and the boards they were measured on are added to the board library in `library directory`.
+// The library keys them by their configuration, seed and parameters, so they sit next to the default boards
+// of the same seeds instead of replacing them. The exit code is 2 if any level still does not
+// play longer than the level below it.
+
+#define TUNER_DEFAULT_SHORTEST_ROUNDS 30
+#define TUNER_DEFAULT_LONGEST_ROUNDS 300
+#define TUNER_DEFAULT_THREADS 4
+#define TUNER_CANDIDATES 16
+#define TUNER_GENERATIONS 4
+#define TUNER_BOARDS 4
+#define TUNER_GAMES 256
+#define TUNER_SEED 1
+
+int main(int argc, char** argv) {
+    if(argc < 3) {
+        fprintf(stderr,"Usage: %s <table.csv> <library directory> [shortest rounds] [longest rounds] [threads]\n",argv[0]);
+        return 1;
+    }
+
+    const char *const table_path = argv[1];
+    const char *const directory = argv[2];
+    const double shortest = argc > 3 ? strtod(argv[3],NULL) : TUNER_DEFAULT_SHORTEST_ROUNDS;
+    const double longest = argc > 4 ? strtod(argv[4],NULL) : TUNER_DEFAULT_LONGEST_ROUNDS;
+    const unsigned int threads = argc > 5 ? (unsigned int) strtoul(argv[5],NULL,10) : TUNER_DEFAULT_THREADS;
+
+    if(shortest < 1 || longest < shortest || threads < 1) {
+        fprintf(stderr,"The rounds have to be at least 1 and grow with the difficulty, and at least one thread is needed!\n");
+        return 1;
+    }
+
+    FILE* table = fopen(table_path,"w");
+
+    if(table == NULL) {
+        perror("Opening the table has failed");
+        return 1;
+    }
+
+    fprintf(table,"difficulty,players,target_rounds,mean_rounds,error,board_size,board_size_base,board_size_growth,ladder_divisor,snake_divisor,players_modifier\n");
+
+    const uint64_t started = monotonic_nanoseconds();
+    unsigned int levels = 0;
+    unsigned int added = 0;
+    unsigned int out_of_order = 0;
+
+    for(unsigned int players = 0;players <= 11;players++) {
+        if(ensure_players_within_1_10(players) != NULL) continue;
+
+        // Every search of a number of players starts where the previous level ended
+        const config default_config = { .number_of_players = players, .difficulty = 1 };
+        generation_parameters start = generation_parameters_of(default_config);
+        double previous_rounds = 0;
+
+        for(unsigned int difficulty = 0;difficulty <= 11;difficulty++) {
+            if(ensure_difficulty_within_1_10(difficulty) != NULL) continue;
+
+            const tuning_options options = {
+                .number_of_players = players,
+                .difficulty = difficulty,
+                .target_rounds = target_rounds_for_difficulty(difficulty,shortest,longest),
+                .start = start,
+                .candidates = TUNER_CANDIDATES,
+                .generations = TUNER_GENERATIONS,
+                .boards = TUNER_BOARDS,
+                .games = TUNER_GAMES,
+                .threads = threads,
+                .seed = rng_stream_seed(TUNER_SEED,players * 100 + difficulty),
+            };
+
+            const tuning_result result = tune_generation_parameters(options);
+            const generation_parameters parameters = result.parameters;
+
+            board boards[TUNING_MAXIMUM_BOARDS];
+
+            for(unsigned int i = 0;i < result.number_of_boards;i++) {
+                const config config = {
+                    .number_of_players = players,
+                    .difficulty = difficulty,
+                    .seed = result.seeds[i],
+                    .representation = representation_dense,
+                    .parameters = &result.parameters,
+                };
+
+                // `board` has constant members, so it is built in place
+                const board board = generate_board_from_config(config);
+                memcpy(&boards[i],&board,sizeof(board));
+            }
+
+            fprintf(table,"%u,%u,%.1f,%.1f,%.4f,%u,%.6f,%.6f,%.6f,%.6f,%.6f\n",
+                difficulty,players,options.target_rounds,result.mean_rounds,result.error,boards[0].board_size,
+                parameters.board_size_base,parameters.board_size_growth,parameters.ladder_divisor,parameters.snake_divisor,parameters.players_modifier
+            );
+
+            const validate_message error = add_to_board_library(directory,boards,result.number_of_boards);
+
+            for(unsigned int i = 0;i < result.number_of_boards;i++) free_board(boards[i]);
+
+            if(error != NULL) {
+                fprintf(stderr,"%s",error);
+                fclose(table);
+                return 1;
+            }
+
+            levels += 1;
+            added += result.number_of_boards;
+
+            // The whole point of the targets is that a harder level plays longer
+            const bool in_order = result.mean_rounds > previous_rounds;
+            if(!in_order) out_of_order += 1;
+
+            printf("difficulty %2u, %2u players: %7.1f rounds for a target of %7.1f (%.1f%% off)%s\n",
+                difficulty,players,result.mean_rounds,options.target_rounds,(exp(result.error) - 1) * 100,
+                in_order ? "" : ", not longer than the level below"
+            );
+
+            start = parameters;
+            previous_rounds = result.mean_rounds;
+        }
+    }
+
+    if(fclose(table) != 0) {
+        perror("Writing the table has failed");
+        return 1;
+    }
+
+    printf("Tuned %u levels in %.1fs, %u boards added to the library, %u levels not longer than the one below\n",
+        levels,(monotonic_nanoseconds() - started) / 1e9,added,out_of_order
+    );
+
+    return out_of_order == 0 ? 0 : 2;
+}
@@ -0,0 +1,183 @@
+#include "tuning.h"
+
+double target_rounds_for_difficulty(const unsigned int difficulty, const double shortest, const double longest) {
+    return shortest * pow(longest / shortest,(difficulty - 1) / 9.0);
+}
+
+tuning_result tune_generation_parameters(const tuning_options options) {
+    const unsigned int boards = options.boards < TUNING_MAXIMUM_BOARDS ? options.boards : TUNING_MAXIMUM_BOARDS;
+    const unsigned int number_of_measurements = options.candidates * boards;
+
+    tuning_measurement* measurements = malloc(number_of_measurements * sizeof(tuning_measurement));
+
+    if(measurements == NULL) {
+        perror("malloc has failed");
+        exit(1);
+    }
+
+    tuning_result best = {
+        .parameters = options.start,
+        .mean_rounds = 0,
+        .error = INFINITY,
+        .number_of_boards = boards,
+    };
+
+    rng rng = rng_from_seed(options.seed);
+    double spread = TUNING_INITIAL_SPREAD;
+
+    for(unsigned int generation = 0;generation < options.generations;generation++) {
+        // Draw every candidate of the generation before measuring any, so the threads cannot change the draws
+        for(unsigned int candidate = 0;candidate < options.candidates;candidate++) {
+            // The best candidate is measured again on new boards, so one lucky board does not keep it on top
+            const generation_parameters parameters = candidate == 0 ? best.parameters : _jitter_parameters(&rng,best.parameters,spread);
+
+            for(unsigned int i = 0;i < boards;i++) {
+                const unsigned int index = candidate * boards + i;
+
+                const tuning_measurement measurement = {
+                    .parameters = parameters,
+                    .seed = rng_stream_seed(options.seed,(uint64_t) generation * number_of_measurements + index + 1),
+                    .rounds = 0,
+                };
+
+                measurements[index] = measurement;
+            }
+        }
+
+        _measure_boards(measurements,number_of_measurements,options);
+
+        for(unsigned int candidate = 0;candidate < options.candidates;candidate++) {
+            const tuning_measurement* candidate_boards = measurements + candidate * boards;
+
+            double total_rounds = 0;
+            double total_error = 0;
+
+            for(unsigned int i = 0;i < boards;i++) {
+                total_rounds += candidate_boards[i].rounds;
+                total_error += fabs(log(candidate_boards[i].rounds / options.target_rounds));
+            }
+
+            // Ties go to the earlier candidate, which keeps the search reproducible
+            if(total_error / boards < best.error) {
+                best.parameters = candidate_boards[0].parameters;
+                best.mean_rounds = total_rounds / boards;
+                best.error = total_error / boards;
+
+                for(unsigned int i = 0;i < boards;i++) {
+                    best.seeds[i] = candidate_boards[i].seed;
+                    best.rounds[i] = candidate_boards[i].rounds;
+                }
+            }
+        }
+
+        spread /= 2;
+    }
+
+    free(measurements);
+
+    return best;
+}
+
+generation_parameters _jitter_parameters(rng* rng, const generation_parameters center, const double spread) {
+    generation_parameters jittered = center;
+
+    double *const parameters[] = {
+        &jittered.board_size_base,
+        &jittered.board_size_growth,
+        &jittered.ladder_divisor,
+        &jittered.snake_divisor,
+        &jittered.players_modifier,
+    };
+
+    for(unsigned int i = 0;i < sizeof(parameters) / sizeof(parameters[0]);i++) {
+        // A uniform double in [-1, 1) from the top 53 bits
+        const double uniform = (rng_next(rng) >> 11) * 0x1.0p-52 - 1;
+
+        *parameters[i] *= exp(spread * uniform);
+    }
+
+    return jittered;
+}
+
+void _measure_boards(tuning_measurement* measurements, const unsigned int number_of_measurements, const tuning_options options) {
+    tuning_work work = {
+        .measurements = measurements,
+        .number_of_measurements = number_of_measurements,
+        .next = 0,
+        .options = options,
+    };
+
+    const unsigned int threads = options.threads < number_of_measurements ? options.threads : number_of_measurements;
+
+    // The calling thread is one of the workers
+    pthread_t* workers = malloc((threads > 1 ? threads - 1 : 1) * sizeof(pthread_t));
+
+    if(workers == NULL) {
+        perror("malloc has failed");
+        exit(1);
+    }
+
+    unsigned int started = 0;
+
+    // A thread that cannot be started only means fewer workers
+    while(started + 1 < threads && pthread_create(&workers[started],NULL,_measure_boards_worker,&work) == 0) started++;
+
+    _measure_boards_worker(&work);
+
+    for(unsigned int i = 0;i < started;i++) pthread_join(workers[i],NULL);
+
+    free(workers);
+}
+
+double _measure_board(const tuning_measurement* measurement, const tuning_options options, arena* boards) {
+    const config config = {
+        .number_of_players = options.number_of_players,
+        .difficulty = options.difficulty,
+        .seed = measurement->seed,
+        .representation = representation_dense,
+        .parameters = &measurement->parameters,
+    };
+
+    const unsigned int board_size = board_size_of(config);
+    if(board_size < TUNING_MINIMUM_BOARD_SIZE || board_size > TUNING_MAXIMUM_BOARD_SIZE) return INFINITY;
+
+    const board board = generate_board_in_arena(config,boards);
+
+    const simulation_options simulation = {
+        .maximum_rounds = (unsigned int) ceil(options.target_rounds * TUNING_ROUNDS_CAP),
+    };
+
+    game_result results[SIMULATION_BATCH_SIZE];
+    double total_rounds = 0;
+
+    for(unsigned int first = 0;first < options.games;first += SIMULATION_BATCH_SIZE) {
+        const unsigned int count = options.games - first < SIMULATION_BATCH_SIZE ? options.games - first : SIMULATION_BATCH_SIZE;
+
+        simulate_games(board,first,count,simulation,results);
+
+        for(unsigned int i = 0;i < count;i++) total_rounds += results[i].rounds;
+    }
+
+    arena_reset(boards);
+
+    return options.games != 0 ? total_rounds / options.games : 0;
+}
+
+void* _measure_boards_worker(void* work) {
+    tuning_work* shared = work;
+
+    // Every thread generates into its own arena, the generation state is per thread as well
+    arena boards = create_arena(0);
+
+    while(true) {
+        const unsigned int index = atomic_fetch_add(&shared->next,1);
+        if(index >= shared->number_of_measurements) break;
+
+        tuning_measurement* measurement = shared->measurements + index;
+        measurement->rounds = _measure_board(measurement,shared->options,&boards);
+    }
+
+    free_arena(boards);
+
+    return NULL;
+}
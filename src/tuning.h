@@ -0,0 +1,100 @@
+/**
+ * @file CSnakeLadderTuning.h
+ * @brief Header file containing the difficulty autotuner of Snake and Ladder.
+ *
+ * A difficulty level is turned into a board by the constants in `generation_parameters`, and nothing about them makes a higher level play longer than a lower one. This header file defines a search that, for one difficulty level and number of players, generates many candidate boards, measures how many rounds their games last by playing them, and keeps the parameters whose boards come closest to a target length.
+ *
+ * Every generation of the search draws `candidates` parameter sets around the best one so far (the first is the best itself) and halves the spread for the next one. The candidates and the seeds of their boards are drawn from `tuning_options.seed` before any of them is measured, and the boards are measured by `tuning_options.threads` threads at once, so the result does not depend on the number of threads.
+ */
+#pragma once
+#ifndef CSNAKE_LADDER_TUNING_H
+#define CSNAKE_LADDER_TUNING_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "types.h"
+#include "board.h"
+#include "arena.h"
+#include "rng.h"
+#include "simulation.h"
+
+/**
+ * @def TUNING_INITIAL_SPREAD
+ * @brief The natural logarithm of the largest factor a parameter is changed by in the first generation, 0.5 is about 1.65.
+ */
+#define TUNING_INITIAL_SPREAD 0.5
+
+/**
+ * @def TUNING_MINIMUM_BOARD_SIZE
+ * @brief The narrowest board a candidate may generate, narrower candidates are rejected without being measured.
+ */
+#define TUNING_MINIMUM_BOARD_SIZE 6
+
+/**
+ * @def TUNING_MAXIMUM_BOARD_SIZE
+ * @brief The widest board a candidate may generate, wider candidates are rejected without being measured.
+ */
+#define TUNING_MAXIMUM_BOARD_SIZE 256
+
+/**
+ * @def TUNING_ROUNDS_CAP
+ * @brief Games are abandoned after this many times the target rounds, so that a candidate far too hard does not stall the search.
+ */
+#define TUNING_ROUNDS_CAP 8
+
+/**
+ * @brief Function to compute the default target length of a difficulty level.
+ *
+ * The targets grow geometrically from `shortest` at difficulty 1 to `longest` at difficulty 10, so every level plays the same factor longer than the one below it.
+ *
+ * @param difficulty The difficulty level, between 1 and 10.
+ * @param shortest The target rounds of difficulty 1.
+ * @param longest The target rounds of difficulty 10.
+ * @return The target rounds of the level.
+ */
+double target_rounds_for_difficulty(const unsigned int difficulty, const double shortest, const double longest);
+
+/**
+ * @brief Function to search the generation parameters whose boards play closest to a target length.
+ *
+ * @param options The `tuning_options` describing the search.
+ * @return The `tuning_result` of the best candidate, with the seeds of the boards it was measured on. They are regenerated from `config.parameters = &result.parameters` and those seeds.
+ */
+tuning_result tune_generation_parameters(const tuning_options options);
+
+// Function prototypes for internal helper functions:
+
+/**
+ * @brief Function to draw a candidate around the best parameters so far, changing every parameter by a factor between `exp(-spread)` and `exp(spread)`.
+ */
+generation_parameters _jitter_parameters(rng* rng, const generation_parameters center, const double spread);
+
+/**
+ * @brief Function to measure every board of a generation, on up to `options.threads` threads.
+ *
+ * @param measurements Pointer to the boards to measure, their `rounds` are filled in.
+ * @param number_of_measurements The number of boards.
+ * @param options The `tuning_options` of the search.
+ */
+void _measure_boards(tuning_measurement* measurements, const unsigned int number_of_measurements, const tuning_options options);
+
+/**
+ * @brief Function to generate one board and play `options.games` games on it.
+ *
+ * @param measurement Pointer to the board to measure.
+ * @param options The `tuning_options` of the search.
+ * @param boards Pointer to the `arena` the board is generated into, it is reset afterwards.
+ * @return The mean number of rounds, or `INFINITY` if the board would be narrower than `TUNING_MINIMUM_BOARD_SIZE` or wider than `TUNING_MAXIMUM_BOARD_SIZE`.
+ */
+double _measure_board(const tuning_measurement* measurement, const tuning_options options, arena* boards);
+
+/**
+ * @brief The thread function of `_measure_boards`, which takes boards from a shared counter until none are left.
+ */
+void* _measure_boards_worker(void* work);
+
+#endif // CSNAKE_LADDER_TUNING_H
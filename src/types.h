@@ -9,6 +9,25 @@
 #ifndef CSNAKE_LADDER_TYPES_H
 #define CSNAKE_LADDER_TYPES_H
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <pthread.h>
+
+/**
+ * @def MAXIMUM_NUMBER_OF_PLAYERS
+ * @brief The largest number of players a single game can hold (see `ensure_players_within_1_10`).
+ */
+#define MAXIMUM_NUMBER_OF_PLAYERS 10
+
+/**
+ * @def INVALID_COORDINATE
+ * @brief Coordinate of a `point` that does not lie on the board, returned when no suitable point exists.
+ */
+#define INVALID_COORDINATE UINT_MAX
+
 /**
  * @typedef validate_int
  * @brief Unsigned integer type used for validation functions.
@@ -32,11 +51,11 @@ typedef validate_message (*validate)(validate_int input);
 
 /**
  * @typedef board_cell_array_pointer
- * @brief Constant pointer to a pointer to a 2D array of `board_cell` structures.
+ * @brief Pointer to a contiguous, row-major array of `board_cell` structures.
  *
- * This complex type represents a pointer to a pointer to a 2D array of `board_cell` structures. It essentially holds the game board itself.
+ * The whole game board lives in a single allocation of `board_size * board_size` cells. The cell at column `x` and row `y` is stored at index `y * board_size + x`; use the accessors in "board.h" instead of indexing it by hand.
  */
-typedef struct board_cell** *const board_cell_array_pointer;
+typedef struct board_cell* board_cell_array_pointer;
 
 /**
  * @typedef players_array_pointer
@@ -54,6 +73,27 @@ typedef struct player* players_array_pointer;
  */
 typedef struct ladder* ladders_array_pointer;
 
+/**
+ * @typedef snakes_array_pointer
+ * @brief Constant pointer to an array of `snake` structures.
+ *
+ * This type defines a constant pointer to an array of `snake` structures, representing all snakes present on the game board.
+ */
+typedef struct snake* snakes_array_pointer;
+
+/**
+ * @typedef rng
+ * @brief Structure holding the state of a xoshiro256** random number generator.
+ *
+ * Every random choice in the game draws from an explicit `rng`, so that each thread or game can own its stream and the results are reproducible from a seed.
+ */
+typedef struct rng {
+  /**
+   * @brief The 256 bits of generator state, which must not be all zero.
+   */
+  uint64_t state[4];
+} rng;
+
 /**
  * @enum role
  * @brief Enumeration representing the role of a point on the board (ladder or snake).
@@ -72,19 +112,139 @@ typedef enum role {
 } role;
 
 /**
- * @typedef player
- * @brief Structure representing a player in the Snake and Ladder game.
+ * @def NUMBER_OF_ROLES
+ * @brief The number of roles a cell can take on, i.e. every `role` except `none`.
  */
-typedef struct player {
+#define NUMBER_OF_ROLES none
+
+/**
+ * @typedef arena_block
+ * @brief Structure representing one block of memory owned by an `arena`.
+ */
+typedef struct arena_block {
+  /**
+   * @brief The next block of the chain, or `NULL`.
+   */
+  struct arena_block* next;
+
+  /**
+   * @brief The number of bytes in `memory`.
+   */
+  size_t capacity;
+
+  /**
+   * @brief The number of bytes of `memory` handed out since the block was last entered.
+   */
+  size_t used;
+
+  /**
+   * @brief The memory of the block.
+   */
+  max_align_t memory[];
+} arena_block;
+
+/**
+ * @typedef arena_stats
+ * @brief Structure counting the work done by an `arena`.
+ */
+typedef struct arena_stats {
+  /**
+   * @brief The number of allocations carved from the arena.
+   */
+  unsigned long long allocations;
+
+  /**
+   * @brief The number of blocks requested from the system allocator. Once an arena has warmed up, this stops growing.
+   */
+  unsigned long long system_allocations;
+
+  /**
+   * @brief The number of times the arena was reset.
+   */
+  unsigned long long resets;
+
+  /**
+   * @brief The number of bytes held in blocks.
+   */
+  size_t reserved_bytes;
+} arena_stats;
+
+/**
+ * @typedef arena
+ * @brief Structure representing a region allocator, from which memory is carved by bumping a pointer and given back all at once.
+ *
+ * The memory lives in a chain of blocks that are kept across resets, so an arena that is reset between boards stops calling the system allocator once its blocks are big enough.
+ */
+typedef struct arena {
+  /**
+   * @brief The first block of the chain, or `NULL` before the first allocation.
+   */
+  arena_block* first;
+
+  /**
+   * @brief The block allocations are currently carved from.
+   */
+  arena_block* current;
+
+  /**
+   * @brief The smallest capacity of a new block.
+   */
+  size_t block_size;
+
+  /**
+   * @brief The counters of the arena.
+   */
+  arena_stats stats;
+} arena;
+
+/**
+ * @typedef arena_mark
+ * @brief Structure recording a position in an `arena`, to give back everything allocated after it.
+ */
+typedef struct arena_mark {
+  /**
+   * @brief The block that was current.
+   */
+  arena_block* block;
+
+  /**
+   * @brief The bytes of `block` that were in use.
+   */
+  size_t used;
+} arena_mark;
+
+/**
+ * @typedef occupancy_grid
+ * @brief Structure holding one bit per cell of a board, packed into 64-bit words.
+ *
+ * The grid is padded with an empty row below and above the board and an empty column to its left and right: board cell (x, y) is bit `x + 1` of padded row `y + 1`. Neighbourhood checks at the edge of the board therefore read padding instead of branching on the bounds. Every padded row also ends in a spare word, so that 64 bits can be read starting at any column.
+ */
+typedef struct occupancy_grid {
+  /**
+   * @brief The size of the board the grid covers.
+   */
+  unsigned int board_size;
+
+  /**
+   * @brief The number of 64-bit words of every padded row.
+   */
+  unsigned int words_per_row;
+
   /**
-   * @brief The position of the player on the game grid (X-coordinate).
+   * @brief Pointer to the `(board_size + 2) * words_per_row` words of the grid.
    */
-  unsigned int position_x;
+  uint64_t* words;
+} occupancy_grid;
 
+/**
+ * @typedef player
+ * @brief Structure representing a player in the Snake and Ladder game.
+ */
+typedef struct player {
   /**
-   * @brief The position of the player on the game grid (Y-coordinate).
+   * @brief The label of the cell the player stands on, starting from 1. Use `point_for_label` for its coordinates.
    */
-  unsigned int position_y;
+  unsigned int position;
 } player;
 
 /**
@@ -103,6 +263,160 @@ typedef struct board_cell {
   role role;
 } board_cell;
 
+/**
+ * @def SEGMENT_BUCKET_SIZE
+ * @brief The width and height, in cells, of the square buckets a `segment_index` files its segments under.
+ */
+#define SEGMENT_BUCKET_SIZE 16
+
+/**
+ * @enum entity_kind
+ * @brief Enumeration of the kinds of entities that cover cells of a board.
+ */
+typedef enum entity_kind {
+  /// @brief No entity, the cell only carries its label.
+  entity_none,
+  /// @brief A ladder, from `board.ladders`.
+  entity_ladder,
+  /// @brief A snake, from `board.snakes`.
+  entity_snake,
+} entity_kind;
+
+/**
+ * @typedef board_entity
+ * @brief Structure naming a ladder or snake of a board.
+ */
+typedef struct board_entity {
+  /**
+   * @brief Whether the entity is a ladder or a snake, or `entity_none` if there is none.
+   */
+  entity_kind kind;
+
+  /**
+   * @brief The index of the entity in `board.ladders` or `board.snakes`.
+   */
+  unsigned int index;
+} board_entity;
+
+/**
+ * @typedef segment_run
+ * @brief Structure holding the cells a segment covers in one row, from `first_x` to `last_x` inclusive.
+ */
+typedef struct segment_run {
+  unsigned int first_x;
+  unsigned int last_x;
+} segment_run;
+
+/**
+ * @typedef segment
+ * @brief Structure holding the cells of one ladder or snake as one `segment_run` per row, from its lowest row up.
+ */
+typedef struct segment {
+  /**
+   * @brief The entity the segment belongs to.
+   */
+  board_entity entity;
+
+  /**
+   * @brief The lowest row of the segment.
+   */
+  unsigned int first_row;
+
+  /**
+   * @brief The number of rows the segment covers.
+   */
+  unsigned int number_of_rows;
+
+  /**
+   * @brief The index of the run of `first_row` in the `runs` of the `segment_index`.
+   */
+  unsigned int first_run;
+} segment;
+
+/**
+ * @typedef segment_link
+ * @brief Structure linking a segment into the list of a bucket of a `segment_index`.
+ */
+typedef struct segment_link {
+  /**
+   * @brief The index of the segment in `segments`.
+   */
+  unsigned int segment;
+
+  /**
+   * @brief The index of the next link of the bucket in `links`, or `UINT_MAX` at the end.
+   */
+  unsigned int next;
+} segment_link;
+
+/**
+ * @typedef segment_index
+ * @brief Structure holding a spatial index of the ladders and snakes of a board.
+ *
+ * The board is cut into square buckets of `SEGMENT_BUCKET_SIZE` cells, and every segment is linked into the list of each bucket it passes through. A question about a cell, or a line, only looks at the few segments of the buckets it touches, and then at their runs in the rows it touches.
+ */
+typedef struct segment_index {
+  /**
+   * @brief The size of the board the index covers.
+   */
+  unsigned int board_size;
+
+  /**
+   * @brief The number of buckets per row and column.
+   */
+  unsigned int buckets_per_row;
+
+  /**
+   * @brief Pointer to the first link of every bucket, row by row, or `UINT_MAX` for an empty bucket.
+   */
+  unsigned int* bucket_heads;
+
+  /**
+   * @brief Pointer to the segments, in the order they were added.
+   */
+  segment* segments;
+
+  /**
+   * @brief The number of elements in `segments`.
+   */
+  unsigned int number_of_segments;
+
+  /**
+   * @brief The number of elements `segments` has room for.
+   */
+  unsigned int segments_capacity;
+
+  /**
+   * @brief Pointer to the runs of all segments.
+   */
+  segment_run* runs;
+
+  /**
+   * @brief The number of elements in `runs`.
+   */
+  unsigned int number_of_runs;
+
+  /**
+   * @brief The number of elements `runs` has room for.
+   */
+  unsigned int runs_capacity;
+
+  /**
+   * @brief Pointer to the links of all buckets.
+   */
+  segment_link* links;
+
+  /**
+   * @brief The number of elements in `links`.
+   */
+  unsigned int number_of_links;
+
+  /**
+   * @brief The number of elements `links` has room for.
+   */
+  unsigned int links_capacity;
+} segment_index;
+
 
 /**
  * @typedef point
@@ -122,6 +436,87 @@ typedef struct point {
   const unsigned int y;
 } point;
 
+/**
+ * @typedef bresenham_line
+ * @brief Structure holding the state of a walk along a line with [Bresenham's line algorithm](https://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm), one cell at a time.
+ */
+typedef struct bresenham_line {
+  /**
+   * @brief The current cell (X-coordinate).
+   */
+  int x;
+
+  /**
+   * @brief The current cell (Y-coordinate).
+   */
+  int y;
+
+  /**
+   * @brief The last cell of the line (X-coordinate).
+   */
+  int end_x;
+
+  /**
+   * @brief The last cell of the line (Y-coordinate).
+   */
+  int end_y;
+
+  /**
+   * @brief The horizontal distance between the ends.
+   */
+  int dx;
+
+  /**
+   * @brief The negated vertical distance between the ends.
+   */
+  int dy;
+
+  /**
+   * @brief The horizontal step, 1 or -1.
+   */
+  int sx;
+
+  /**
+   * @brief The vertical step, 1 or -1.
+   */
+  int sy;
+
+  /**
+   * @brief The accumulated error of the walk.
+   */
+  int error;
+} bresenham_line;
+
+/**
+ * @typedef cell_index
+ * @brief Structure holding a set of cells that supports constant time insertion, removal and uniform sampling.
+ *
+ * The members are packed at the front of `cells`, and `slot` remembers where each cell is stored so that removal can swap the last member into its place.
+ *
+ * A sampled index, which sparse boards and `regenerate_board` use, stores nothing: its `cells` are `NULL` and members are found by sampling cells at random until a free one turns up (see `_cell_index_sample`).
+ */
+typedef struct cell_index {
+  /**
+   * @brief Pointer to the row-major indices of the cells in the set, the first `count` of which are valid.
+   */
+  unsigned int* cells;
+
+  /**
+   * @brief Pointer to the position of every cell of the board within `cells`, or `UINT_MAX` if it is not in the set.
+   */
+  unsigned int* slot;
+
+  /**
+   * @brief The number of cells in the set. For a sampled index it is only 0 once sampling has given up.
+   */
+  unsigned int count;
+
+  /**
+   * @brief The number of samples of a sampled index since a cell was last taken.
+   */
+  unsigned int misses;
+} cell_index;
+
 /**
  * @typedef ladder
  * @brief Structure representing a ladder on the game board.
@@ -138,51 +533,2278 @@ typedef struct ladder {
   point end;
 } ladder;
 
+/**
+ * @typedef snake
+ * @brief Structure representing a snake on the game board.
+ */
+typedef struct snake {
+  /**
+   * @brief The head (top) of the snake, where a player gets bitten.
+   */
+  point head;
+
+  /**
+   * @brief The tail (bottom) of the snake, where a bitten player ends up.
+   */
+  point tail;
+} snake;
+
 
 /**
- * @typedef board
- * @brief Structure representing the game board.
+ * @typedef jump_table
+ * @brief Structure holding the compiled, one dimensional view of a board used to resolve moves.
  *
- * This structure encapsulates all the essential elements of the game board for Snake and Ladder.
+ * A player landing on the cell labeled `label` ends up on `destination[label]`, which is the top of a ladder, the tail of a snake or the cell itself. Moving by a roll is therefore a single array lookup.
+ *
+ * A sparse board only stores its jumps, as sorted `from` and `to` arrays that are binary searched (see `jump_destination`).
  */
-typedef struct board {
+typedef struct jump_table {
   /**
-   * @brief Pointer to a pointer to an array of `player` structures, representing all players in the game.
+   * @brief The number of cells on the board, which is also the label of the final cell.
    */
-  players_array_pointer players;
+  unsigned int number_of_cells;
 
   /**
-   * @brief The size of the game board (number of squares on each side, assuming a square board).
+   * @brief Pointer to `number_of_cells + 1` destination labels, indexed by label (index 0 is unused), or `NULL` for a sparse board.
    */
-  const unsigned int board_size;
+  unsigned int* destination;
 
   /**
-   * @brief Pointer to a pointer to a 2D array of `board_cell` structures, representing the actual game board cells.
+   * @brief The number of elements in `from` and `to`.
    */
-  board_cell_array_pointer inner_board;
+  unsigned int number_of_jumps;
 
   /**
-   * @brief Pointer to an array of `ladder` structures, representing all ladders present on the game board.
+   * @brief Pointer to the labels of the ladder starts and snake heads of a sparse board in ascending order, or `NULL` for a dense board.
    */
-  ladders_array_pointer ladders;
-} board;
+  unsigned int* from;
+
+  /**
+   * @brief Pointer to the label each element of `from` leads to.
+   */
+  unsigned int* to;
+} jump_table;
 
 /**
- * @typedef config
- * @brief Structure representing the configuration for a game of Snake and Ladder.
+ * @typedef board_mapping
+ * @brief Structure representing a read-only memory mapping of a board file.
+ */
+typedef struct board_mapping {
+  /**
+   * @brief The first byte of the mapping, or `NULL`.
+   */
+  const void* address;
+
+  /**
+   * @brief The number of bytes mapped.
+   */
+  size_t length;
+} board_mapping;
+
+/**
+ * @enum board_representation
+ * @brief Enumeration of the ways the cells of a board can be stored.
+ */
+typedef enum board_representation {
+  /// @brief Dense below `SPARSE_BOARD_MINIMUM_SIZE`, sparse from there on.
+  representation_automatic,
+  /// @brief A row-major array of every `board_cell`, with occupancy grids and a jump for every label.
+  representation_dense,
+  /// @brief Only the ladders and snakes, as segments of a `segment_index` with no cells behind them, and only the jumps.
+  representation_sparse,
+} board_representation;
+
+/**
+ * @def SPARSE_BOARD_MINIMUM_SIZE
+ * @brief The board size from which `representation_automatic` generates sparse boards.
+ */
+#define SPARSE_BOARD_MINIMUM_SIZE 1024
+
+/**
+ * @typedef generation_parameters
+ * @brief Structure holding the constants that turn a difficulty level into the shape of a board.
  *
- * This structure holds information about the game setup, such as the number of players and difficulty level.
+ * For `d` = difficulty and `p` = number of players, the board is `(1 + (d - 1) * board_size_growth) * sqrt(p) * board_size_base` cells wide, with `|d * size / ladder_divisor - sqrt(p) * players_modifier|` ladders and `d * floor(size / snake_divisor) + sqrt(p) * players_modifier` snakes.
  */
-typedef struct config {
+typedef struct generation_parameters {
   /**
-   * @brief The number of players participating in the game.
+   * @brief The width of a difficulty 1 board for a single player, 10 by default.
    */
-  unsigned int number_of_players;
+  double board_size_base;
 
   /**
-   * @brief The difficulty level of the game (implementation-specific, could be integer or enum).
+   * @brief How much wider the board gets with every difficulty level, relative to `board_size_base`, 0.15 by default.
    */
-  const unsigned int difficulty;
-} config;
+  double board_size_growth;
+
+  /**
+   * @brief The number of cells of the board width per ladder and difficulty level, 7.5 by default.
+   */
+  double ladder_divisor;
+
+  /**
+   * @brief The number of cells of the board width per snake and difficulty level, 10 by default.
+   */
+  double snake_divisor;
+
+  /**
+   * @brief How many ladders are traded for snakes per square root of the number of players, 10 by default.
+   */
+  double players_modifier;
+} generation_parameters;
+
+/**
+ * @typedef config
+ * @brief Structure representing the configuration for a game of Snake and Ladder.
+ *
+ * This structure holds information about the game setup, such as the number of players and difficulty level.
+ */
+typedef struct config {
+  /**
+   * @brief The number of players participating in the game.
+   */
+  unsigned int number_of_players;
+
+  /**
+   * @brief The difficulty level of the game (implementation-specific, could be integer or enum).
+   */
+  const unsigned int difficulty;
+
+  /**
+   * @brief The seed the board and the dice rolls are generated from.
+   */
+  uint64_t seed;
+
+  /**
+   * @brief How the cells of the board are stored. A sparse board is generated differently, so the same seed gives another board than a dense one.
+   */
+  board_representation representation;
+
+  /**
+   * @brief The `generation_parameters` of the board, or `NULL` for the defaults. Only read while the board is generated, the same seed with other parameters gives another board.
+   */
+  const generation_parameters* parameters;
+} config;
+
+/**
+ * @typedef board
+ * @brief Structure representing the game board.
+ *
+ * This structure encapsulates all the essential elements of the game board for Snake and Ladder.
+ */
+typedef struct board {
+  /**
+   * @brief Pointer to a pointer to an array of `player` structures, representing all players in the game.
+   */
+  players_array_pointer players;
+
+  /**
+   * @brief The size of the game board (number of squares on each side, assuming a square board).
+   */
+  const unsigned int board_size;
+
+  /**
+   * @brief Pointer to the contiguous row-major array of `board_cell` structures, representing the actual game board cells, or `NULL` for a sparse board.
+   */
+  board_cell_array_pointer inner_board;
+
+  /**
+   * @brief Pointer to the `segment_index` of the ladders and snakes, or `NULL` for a loaded board. The roles of the cells of a sparse board are only known from it.
+   */
+  segment_index* segments;
+
+  /**
+   * @brief Pointer to an array of `ladder` structures, representing all ladders present on the game board.
+   */
+  ladders_array_pointer ladders;
+
+  /**
+   * @brief The number of elements in `ladders`.
+   */
+  unsigned int number_of_ladders;
+
+  /**
+   * @brief The number of ladders the configuration asked for. When the board fills up first, `number_of_ladders` is smaller.
+   */
+  unsigned int requested_ladders;
+
+  /**
+   * @brief Pointer to the point every ladder was drawn towards, or `NULL` for a loaded board. A ladder covers the cells of the line from its `start` towards this point, up to its `end`.
+   */
+  point* ladder_aims;
+
+  /**
+   * @brief Pointer to an array of `snake` structures, representing all snakes present on the game board.
+   */
+  snakes_array_pointer snakes;
+
+  /**
+   * @brief The number of elements in `snakes`.
+   */
+  unsigned int number_of_snakes;
+
+  /**
+   * @brief The number of snakes the configuration asked for. When the board fills up first, `number_of_snakes` is smaller.
+   */
+  unsigned int requested_snakes;
+
+  /**
+   * @brief Pointer to the point every snake was drawn towards, or `NULL` for a loaded board. A snake covers the cells of the line from its `tail` towards this point, up to its `head`.
+   */
+  point* snake_aims;
+
+  /**
+   * @brief The number of times the board has been changed with `regenerate_board` since it was generated.
+   */
+  unsigned int revision;
+
+  /**
+   * @brief The number of elements in `players`.
+   */
+  unsigned int number_of_players;
+
+  /**
+   * @brief Pointer to the `arena` all memory of the board was carved from, or `NULL` if the board owns its memory.
+   */
+  arena* arena;
+
+  /**
+   * @brief The `jump_table` compiled from the ladders and snakes once they have been placed.
+   */
+  jump_table jumps;
+
+  /**
+   * @brief The `occupancy_grid` of every cell whose role is not `none`, kept in step with `inner_board`. A sparse board has no grids.
+   */
+  occupancy_grid occupied;
+
+  /**
+   * @brief One `occupancy_grid` per `role` (except `none`), kept in step with `inner_board`.
+   */
+  occupancy_grid role_grids[NUMBER_OF_ROLES];
+
+  /**
+   * @brief The configuration the board was generated from.
+   */
+  config config;
+
+  /**
+   * @brief The file mapping the board was loaded from, whose `address` is `NULL` if the board was generated.
+   */
+  board_mapping mapping;
+} board;
+
+/**
+ * @enum move_result
+ * @brief Enumeration describing what happened when a player was moved by a roll.
+ */
+typedef enum move_result {
+  /// @brief The player moved forward onto an ordinary cell.
+  moved,
+  /// @brief The player landed on the start of a ladder and climbed it.
+  climbed_ladder,
+  /// @brief The player landed on the head of a snake and slid down it.
+  bitten_by_snake,
+  /// @brief The roll would take the player past the final cell, so the move was invalidated.
+  move_past_finish,
+} move_result;
+
+/**
+ * @enum turn_outcome
+ * @brief Enumeration describing the state of the game after a roll has been applied.
+ */
+typedef enum turn_outcome {
+  /// @brief The player rolled a six and rolls again.
+  roll_again,
+  /// @brief The turn is over and has passed to the next player.
+  turn_over,
+  /// @brief The player rolled three consecutive sixes, so the last move was invalidated and the turn is over.
+  three_sixes,
+  /// @brief The player reached the final cell and won the game.
+  game_won,
+} turn_outcome;
+
+/**
+ * @typedef game
+ * @brief Structure holding the turn state of a single game of Snake and Ladder.
+ *
+ * The rules only ever read the `board`, so many games (each with their own `players` array) can share one board.
+ */
+typedef struct game {
+  /**
+   * @brief The board this game is played on.
+   */
+  board board;
+
+  /**
+   * @brief Pointer to the positions of the players taking part in this game.
+   */
+  players_array_pointer players;
+
+  /**
+   * @brief The round being played, starting from 0.
+   */
+  unsigned int round;
+
+  /**
+   * @brief The index of the player whose turn it is.
+   */
+  unsigned int current_player;
+
+  /**
+   * @brief The number of sixes the current player has rolled in a row during this turn.
+   */
+  unsigned int consecutive_sixes;
+
+  /**
+   * @brief The result of the most recent move.
+   */
+  move_result last_move;
+
+  /**
+   * @brief Whether a player has reached the final cell.
+   */
+  bool finished;
+
+  /**
+   * @brief The index of the winning player, only meaningful once `finished` is set.
+   */
+  unsigned int winner;
+
+  /**
+   * @brief The number of player turns that have been completed.
+   */
+  unsigned int turns;
+
+  /**
+   * @brief The number of dice rolls that have been applied.
+   */
+  unsigned int rolls;
+
+  /**
+   * @brief The number of times any player has climbed a ladder.
+   */
+  unsigned int ladder_hits;
+
+  /**
+   * @brief The number of times any player has been bitten by a snake.
+   */
+  unsigned int snake_hits;
+
+  /**
+   * @brief The number of moves that were invalidated (past the finish line or by three consecutive sixes).
+   */
+  unsigned int invalidated_moves;
+} game;
+
+/**
+ * @typedef timer_callback
+ * @brief Function pointer type called when a timer of an `event_loop` is due.
+ */
+typedef void (*timer_callback)(void* context);
+
+/**
+ * @typedef input_callback
+ * @brief Function pointer type called with the input an `event_loop` has read, as soon as it is available.
+ *
+ * A `length` of 0 means the input has ended.
+ */
+typedef void (*input_callback)(void* context, const char* input, const size_t length);
+
+/**
+ * @typedef loop_timer
+ * @brief Structure representing a single pending timer of an `event_loop`.
+ */
+typedef struct loop_timer {
+  /**
+   * @brief The monotonic time, in nanoseconds, at which the timer is due.
+   */
+  uint64_t deadline;
+
+  /**
+   * @brief The function to call.
+   */
+  timer_callback callback;
+
+  /**
+   * @brief The context to call `callback` with.
+   */
+  void* context;
+
+  /**
+   * @brief Whether the timer is pending.
+   */
+  bool active;
+} loop_timer;
+
+/**
+ * @def EVENT_LOOP_MAXIMUM_TIMERS
+ * @brief The largest number of timers an `event_loop` can have pending at once.
+ */
+#define EVENT_LOOP_MAXIMUM_TIMERS 16
+
+/**
+ * @typedef event_loop
+ * @brief Structure holding the state of a single threaded event loop driven by a monotonic timer and non-blocking input.
+ */
+typedef struct event_loop {
+  /**
+   * @brief The timers, pending or free.
+   */
+  loop_timer timers[EVENT_LOOP_MAXIMUM_TIMERS];
+
+  /**
+   * @brief The file descriptor input is read from, or -1 when no input is watched.
+   */
+  int input;
+
+  /**
+   * @brief The function called with new input.
+   */
+  input_callback on_input;
+
+  /**
+   * @brief The context to call `on_input` with.
+   */
+  void* input_context;
+
+  /**
+   * @brief Whether the loop keeps running.
+   */
+  bool running;
+} event_loop;
+
+/**
+ * @typedef renderer
+ * @brief Structure holding the state of the terminal renderer of a board.
+ *
+ * The renderer remembers where it last drew every player, so that a new frame only has to touch the cells whose tokens changed.
+ */
+typedef struct renderer {
+  /**
+   * @brief The file descriptor frames are written to.
+   */
+  int output;
+
+  /**
+   * @brief The size of the board being drawn.
+   */
+  unsigned int board_size;
+
+  /**
+   * @brief The number of characters of the widest label.
+   */
+  unsigned int label_width;
+
+  /**
+   * @brief The number of players being drawn.
+   */
+  unsigned int number_of_players;
+
+  /**
+   * @brief The position of every player in the last frame that was written.
+   */
+  unsigned int positions[MAXIMUM_NUMBER_OF_PLAYERS];
+
+  /**
+   * @brief Whether the whole board has been drawn, so that frames can be diffs.
+   */
+  bool drawn;
+
+  /**
+   * @brief Whether the board and a message line fitted on the terminal at the last whole drawing. Only then are cells patched in place, otherwise every frame redraws the whole board into the scrolling output.
+   */
+  bool fits;
+
+  /**
+   * @brief Pointer to the reusable buffer a frame is formatted into.
+   */
+  char* frame;
+
+  /**
+   * @brief The number of characters of the current frame.
+   */
+  size_t frame_length;
+
+  /**
+   * @brief The number of characters `frame` can hold.
+   */
+  size_t frame_capacity;
+
+  /**
+   * @brief The number of frames written.
+   */
+  unsigned long long frames;
+
+  /**
+   * @brief The number of bytes written.
+   */
+  unsigned long long bytes_written;
+} renderer;
+
+/**
+ * @typedef replay_writer
+ * @brief Structure holding a replay log that games are appended to.
+ */
+typedef struct replay_writer {
+  /**
+   * @brief The log, opened for appending.
+   */
+  FILE* file;
+
+  /**
+   * @brief The codes of the word that is being filled.
+   */
+  uint64_t word;
+
+  /**
+   * @brief The number of codes in `word`.
+   */
+  unsigned int codes;
+} replay_writer;
+
+/**
+ * @typedef interactive_game
+ * @brief Structure holding the state of a game played in the terminal, advanced by the callbacks of its `event_loop`.
+ */
+typedef struct interactive_game {
+  /**
+   * @brief The game being played.
+   */
+  game game;
+
+  /**
+   * @brief The renderer drawing the board.
+   */
+  renderer renderer;
+
+  /**
+   * @brief The generator the dice are rolled with.
+   */
+  rng dice;
+
+  /**
+   * @brief The event loop driving the game.
+   */
+  event_loop loop;
+
+  /**
+   * @brief The delay between two frames of the dice animation, in nanoseconds. With 0 the game runs at full speed.
+   */
+  uint64_t frame_delay;
+
+  /**
+   * @brief The frame of the dice animation being shown.
+   */
+  unsigned int frame;
+
+  /**
+   * @brief The timer of the next frame of the dice animation, or `NO_TIMER`.
+   */
+  unsigned int animation_timer;
+
+  /**
+   * @brief The replay log the game is recorded to, its `file` is `NULL` if it is not recorded.
+   */
+  replay_writer log;
+} interactive_game;
+
+/**
+ * @typedef board_file_header
+ * @brief Structure representing the header at the start of a board file.
+ *
+ * The header is followed by sections that hold the arrays of a `board` exactly as they are laid out in memory, each starting at a multiple of 8 bytes, so a mapped file is used as it is.
+ */
+typedef struct board_file_header {
+  /**
+   * @brief The bytes `CSLBOARD`.
+   */
+  char magic[8];
+
+  /**
+   * @brief The version of the format, `BOARD_FILE_VERSION` when written.
+   */
+  uint32_t version;
+
+  /**
+   * @brief The value 0x01020304 as written by the machine that saved the file, to detect a different byte order.
+   */
+  uint32_t byte_order;
+
+  /**
+   * @brief The size of the file in bytes.
+   */
+  uint64_t file_size;
+
+  /**
+   * @brief The checksum of everything after the header.
+   */
+  uint64_t checksum;
+
+  /**
+   * @brief The seed of the configuration the board was generated from.
+   */
+  uint64_t seed;
+
+  /**
+   * @brief The number of players of the configuration.
+   */
+  uint32_t number_of_players;
+
+  /**
+   * @brief The difficulty of the configuration.
+   */
+  uint32_t difficulty;
+
+  /**
+   * @brief The size of the board.
+   */
+  uint32_t board_size;
+
+  /**
+   * @brief The number of ladders placed.
+   */
+  uint32_t number_of_ladders;
+
+  /**
+   * @brief The number of ladders the configuration asked for.
+   */
+  uint32_t requested_ladders;
+
+  /**
+   * @brief The number of snakes placed.
+   */
+  uint32_t number_of_snakes;
+
+  /**
+   * @brief The number of snakes the configuration asked for.
+   */
+  uint32_t requested_snakes;
+
+  /**
+   * @brief Unused, always 0.
+   */
+  uint32_t reserved;
+
+  /**
+   * @brief The `generation_parameters` the board was generated with, the same seed with other parameters gives another board.
+   */
+  generation_parameters parameters;
+
+  /**
+   * @brief The offset of the occupancy grids: the `occupied` grid followed by one grid per role.
+   */
+  uint64_t grids_offset;
+
+  /**
+   * @brief The offset of the `board_cell` array.
+   */
+  uint64_t cells_offset;
+
+  /**
+   * @brief The offset of the `ladder` array.
+   */
+  uint64_t ladders_offset;
+
+  /**
+   * @brief The offset of the `snake` array.
+   */
+  uint64_t snakes_offset;
+
+  /**
+   * @brief The offset of the destinations of the `jump_table`.
+   */
+  uint64_t jumps_offset;
+} board_file_header;
+
+/**
+ * @enum board_metric
+ * @brief Enumeration of the measured properties a `board_library` is indexed on.
+ */
+typedef enum board_metric {
+  /// @brief The number of ladders.
+  metric_ladders,
+  /// @brief The number of snakes.
+  metric_snakes,
+  /// @brief The number of cells climbed by all ladders together.
+  metric_total_climb,
+  /// @brief The number of cells fallen down all snakes together.
+  metric_total_fall,
+  /// @brief The expected number of turns a single player needs to finish.
+  metric_expected_turns,
+  /// @brief The number of metrics.
+  number_of_board_metrics,
+} board_metric;
+
+/**
+ * @typedef library_entry
+ * @brief Structure describing one board of a `board_library`.
+ */
+typedef struct library_entry {
+  /**
+   * @brief The number of players of the configuration the board was generated from.
+   */
+  uint32_t number_of_players;
+
+  /**
+   * @brief The difficulty of the configuration.
+   */
+  uint32_t difficulty;
+
+  /**
+   * @brief The seed of the configuration.
+   */
+  uint64_t seed;
+
+  /**
+   * @brief The size of the board.
+   */
+  uint32_t board_size;
+
+  /**
+   * @brief Unused, always 0.
+   */
+  uint32_t reserved;
+
+  /**
+   * @brief The `generation_parameters` the board was generated with, the last part of the key after the seed.
+   */
+  generation_parameters parameters;
+
+  /**
+   * @brief The measured value of every `board_metric`.
+   */
+  double metrics[number_of_board_metrics];
+} library_entry;
+
+/**
+ * @typedef library_file_header
+ * @brief Structure representing the header of the index file of a `board_library`.
+ *
+ * The header is followed by the `library_entry` array, sorted by players, difficulty, seed and parameters, and then by one permutation of the entries per `board_metric`, sorted by that metric.
+ */
+typedef struct library_file_header {
+  /**
+   * @brief The bytes `CSLINDEX`.
+   */
+  char magic[8];
+
+  /**
+   * @brief The version of the format, `LIBRARY_FILE_VERSION` when written.
+   */
+  uint32_t version;
+
+  /**
+   * @brief The value 0x01020304 as written by the machine that saved the file.
+   */
+  uint32_t byte_order;
+
+  /**
+   * @brief The number of entries.
+   */
+  uint64_t number_of_entries;
+
+  /**
+   * @brief The size of the file in bytes.
+   */
+  uint64_t file_size;
+
+  /**
+   * @brief The checksum of everything after the header.
+   */
+  uint64_t checksum;
+} library_file_header;
+
+/**
+ * @typedef board_library
+ * @brief Structure representing an open board library: a directory of board files and the mapped index over them.
+ */
+typedef struct board_library {
+  /**
+   * @brief The directory of the library.
+   */
+  char* directory;
+
+  /**
+   * @brief The mapping of the index file.
+   */
+  board_mapping index;
+
+  /**
+   * @brief The number of entries.
+   */
+  unsigned int number_of_entries;
+
+  /**
+   * @brief Pointer to the entries in the mapping, sorted by players, difficulty and seed.
+   */
+  const library_entry* entries;
+
+  /**
+   * @brief Pointers to one permutation of the entries per `board_metric`, sorted by that metric.
+   */
+  const uint32_t* by_metric[number_of_board_metrics];
+} board_library;
+
+/**
+ * @enum job_output
+ * @brief Enumeration of what a batch job writes to the output stream.
+ */
+typedef enum job_output {
+  /// @brief One line summarising all games of the job.
+  output_summary,
+  /// @brief One line per game, followed by the summary line.
+  output_games,
+  /// @brief Nothing, e.g. for jobs that only save their board.
+  output_none,
+} job_output;
+
+/**
+ * @typedef job
+ * @brief Structure describing one line of a job stream: a board to generate and the games to play on it.
+ */
+typedef struct job {
+  /**
+   * @brief The number of players.
+   */
+  unsigned int number_of_players;
+
+  /**
+   * @brief The difficulty level.
+   */
+  unsigned int difficulty;
+
+  /**
+   * @brief The seed the board is generated from, game `i` is seeded with stream `i + 1` of it.
+   */
+  uint64_t seed;
+
+  /**
+   * @brief The number of games to play on the board.
+   */
+  unsigned int number_of_games;
+
+  /**
+   * @brief The number of rounds after which an unfinished game is abandoned, or 0 to play until someone wins.
+   */
+  unsigned int maximum_rounds;
+
+  /**
+   * @brief What is written to the output stream for this job.
+   */
+  job_output output;
+
+  /**
+   * @brief How the cells of the board are stored.
+   */
+  board_representation representation;
+
+  /**
+   * @brief The path the board is saved to with `save_board`, or `NULL`. It points into the line buffer of the `job_reader`, so it is only valid until the next job is read.
+   */
+  const char* save_path;
+} job;
+
+/**
+ * @typedef job_reader
+ * @brief Structure representing a stream of jobs, one per line, read from a file or stdin.
+ */
+typedef struct job_reader {
+  /**
+   * @brief The stream the jobs are read from.
+   */
+  FILE* input;
+
+  /**
+   * @brief Pointer to the buffer holding the current line, grown to fit the longest line.
+   */
+  char* line;
+
+  /**
+   * @brief The capacity of `line` in bytes.
+   */
+  size_t capacity;
+
+  /**
+   * @brief The number of the current line, counting from 1.
+   */
+  unsigned long line_number;
+} job_reader;
+
+/**
+ * @enum generation_phase
+ * @brief Enumeration of the steps of board generation that can be timed.
+ */
+typedef enum generation_phase {
+  /// @brief `_create_labeled_board`.
+  phase_create_labeled_board,
+  /// @brief `_genereate_ladders`, including the calls below.
+  phase_generate_ladders,
+  /// @brief `_generate_snakes`, including the calls below.
+  phase_generate_snakes,
+  /// @brief A single call of `_suggested_end_point_for`.
+  phase_suggested_end_point,
+  /// @brief A single call of `_draw_line_on_board`.
+  phase_draw_line,
+  /// @brief The number of phases.
+  number_of_generation_phases,
+} generation_phase;
+
+/**
+ * @typedef generation_probe
+ * @brief Function pointer type receiving the duration of every timed generation phase.
+ */
+typedef void (*generation_probe)(const generation_phase phase, const uint64_t nanoseconds);
+
+/**
+ * @typedef generation_stats
+ * @brief Structure counting the work done while generating boards on the current thread.
+ */
+typedef struct generation_stats {
+  /**
+   * @brief The number of memory allocations.
+   */
+  unsigned long long allocations;
+
+  /**
+   * @brief The number of ladder and snake starts dropped from the free-cell index, because they lie below the minimum row or no end fits around them.
+   */
+  unsigned long long start_retries;
+
+  /**
+   * @brief The number of candidate ends rejected by `_suggested_end_point_for`.
+   */
+  unsigned long long end_retries;
+
+  /**
+   * @brief The number of times `_draw_line_on_board` stopped early on an occupied cell.
+   */
+  unsigned long long shortened_lines;
+} generation_stats;
+
+/**
+ * @enum trace_span
+ * @brief Enumeration of the timed spans of the instrumentation (see trace.h).
+ *
+ * The generation spans have the same values as the `generation_phase`s they time.
+ */
+typedef enum trace_span {
+  /// @brief `_create_labeled_board`.
+  span_create_labeled_board = phase_create_labeled_board,
+  /// @brief `_genereate_ladders`.
+  span_generate_ladders = phase_generate_ladders,
+  /// @brief `_generate_snakes`.
+  span_generate_snakes = phase_generate_snakes,
+  /// @brief A single call of `_suggested_end_point_for`.
+  span_suggested_end_point = phase_suggested_end_point,
+  /// @brief A single call of `_draw_line_on_board`.
+  span_draw_line = phase_draw_line,
+  /// @brief `_compile_jump_table`.
+  span_compile_jump_table,
+  /// @brief A single call of `game_apply_roll`.
+  span_apply_roll,
+  /// @brief A single call of `simulate_game`.
+  span_simulate_game,
+  /// @brief A single call of `render_board`.
+  span_render_board,
+  /// @brief The timer callbacks run by one pass of the event loop.
+  span_run_timers,
+  /// @brief The event loop waiting for input or the next timer.
+  span_wait_for_input,
+  /// @brief The number of spans.
+  number_of_trace_spans,
+} trace_span;
+
+/**
+ * @enum trace_counter
+ * @brief Enumeration of the counters of the instrumentation (see trace.h).
+ */
+typedef enum trace_counter {
+  /// @brief Ladder and snake starts dropped because they lie below the minimum row or no end fits around them.
+  counter_start_retries,
+  /// @brief Candidate ends tried by `_suggested_end_point_for`, one per `_point_in_direction`.
+  counter_end_candidates,
+  /// @brief Candidate ends rejected because `all_neighbors_have_labels` failed.
+  counter_end_rejections,
+  /// @brief Lines `_draw_line_on_board` stopped early on an occupied cell.
+  counter_shortened_lines,
+  /// @brief Dice rolls applied with `game_apply_roll`.
+  counter_rolls,
+  /// @brief Rolls of six that let the player roll again.
+  counter_rolls_again,
+  /// @brief Turns lost to three sixes in a row.
+  counter_three_sixes,
+  /// @brief Moves invalidated because they went past the final cell.
+  counter_moves_past_finish,
+  /// @brief Ladders climbed.
+  counter_ladder_hits,
+  /// @brief Snakes that bit a player.
+  counter_snake_hits,
+  /// @brief Timer callbacks run by the event loop.
+  counter_timers_fired,
+  /// @brief The number of counters.
+  number_of_trace_counters,
+} trace_counter;
+
+/**
+ * @def TRACE_HISTOGRAM_BUCKETS
+ * @brief The number of buckets of a `trace_histogram`; bucket `i` holds durations of less than `2^i` nanoseconds, the last one everything longer.
+ */
+#define TRACE_HISTOGRAM_BUCKETS 40
+
+/**
+ * @typedef trace_histogram
+ * @brief Structure holding the latency histogram of a `trace_span`, in power of two buckets.
+ */
+typedef struct trace_histogram {
+  /**
+   * @brief The number of recorded durations.
+   */
+  unsigned long long count;
+
+  /**
+   * @brief The sum of the recorded durations in nanoseconds.
+   */
+  unsigned long long total_nanoseconds;
+
+  /**
+   * @brief The shortest recorded duration in nanoseconds.
+   */
+  uint64_t minimum_nanoseconds;
+
+  /**
+   * @brief The longest recorded duration in nanoseconds.
+   */
+  uint64_t maximum_nanoseconds;
+
+  /**
+   * @brief The number of durations in each bucket.
+   */
+  unsigned long long buckets[TRACE_HISTOGRAM_BUCKETS];
+} trace_histogram;
+
+/**
+ * @typedef trace_event
+ * @brief Structure holding one recorded span, as written to a Chrome trace.
+ */
+typedef struct trace_event {
+  /**
+   * @brief The span.
+   */
+  trace_span span;
+
+  /**
+   * @brief The monotonic time the span started at, in nanoseconds.
+   */
+  uint64_t started;
+
+  /**
+   * @brief The duration of the span in nanoseconds.
+   */
+  uint64_t duration;
+} trace_event;
+
+/**
+ * @typedef trace_stats
+ * @brief Structure holding everything the instrumentation recorded on the current thread.
+ */
+typedef struct trace_stats {
+  /**
+   * @brief The value of every `trace_counter`.
+   */
+  unsigned long long counters[number_of_trace_counters];
+
+  /**
+   * @brief The histogram of every `trace_span`.
+   */
+  trace_histogram histograms[number_of_trace_spans];
+} trace_stats;
+
+/**
+ * @typedef simulation_options
+ * @brief Structure holding the knobs of a headless simulation.
+ */
+typedef struct simulation_options {
+  /**
+   * @brief The number of rounds after which an unfinished game is abandoned, or 0 to play until someone wins.
+   */
+  unsigned int maximum_rounds;
+} simulation_options;
+
+/**
+ * @typedef game_result
+ * @brief Structure describing the outcome of a single simulated game.
+ */
+typedef struct game_result {
+  /**
+   * @brief Whether a player reached the final cell before `maximum_rounds` ran out.
+   */
+  bool finished;
+
+  /**
+   * @brief The index of the winning player, only meaningful if `finished` is set.
+   */
+  unsigned int winner;
+
+  /**
+   * @brief The number of rounds that were started.
+   */
+  unsigned int rounds;
+
+  /**
+   * @brief The number of player turns that were completed.
+   */
+  unsigned int turns;
+
+  /**
+   * @brief The number of dice rolls.
+   */
+  unsigned int rolls;
+
+  /**
+   * @brief The number of ladders climbed by all players.
+   */
+  unsigned int ladder_hits;
+
+  /**
+   * @brief The number of snakes that bit any player.
+   */
+  unsigned int snake_hits;
+
+  /**
+   * @brief The number of invalidated moves.
+   */
+  unsigned int invalidated_moves;
+} game_result;
+
+/**
+ * @typedef simulation_summary
+ * @brief Structure aggregating the results of many simulated games on one board.
+ */
+typedef struct simulation_summary {
+  /**
+   * @brief The number of games that were simulated.
+   */
+  unsigned int games;
+
+  /**
+   * @brief The number of games in which a player reached the final cell.
+   */
+  unsigned int finished_games;
+
+  /**
+   * @brief The number of games won by each player.
+   */
+  unsigned int wins[MAXIMUM_NUMBER_OF_PLAYERS];
+
+  /**
+   * @brief The fewest rounds any game took.
+   */
+  unsigned int minimum_rounds;
+
+  /**
+   * @brief The most rounds any game took.
+   */
+  unsigned int maximum_rounds;
+
+  /**
+   * @brief The sum of `rounds` over all games.
+   */
+  unsigned long long total_rounds;
+
+  /**
+   * @brief The sum of `turns` over all games.
+   */
+  unsigned long long total_turns;
+
+  /**
+   * @brief The sum of `rolls` over all games.
+   */
+  unsigned long long total_rolls;
+
+  /**
+   * @brief The sum of `ladder_hits` over all games.
+   */
+  unsigned long long total_ladder_hits;
+
+  /**
+   * @brief The sum of `snake_hits` over all games.
+   */
+  unsigned long long total_snake_hits;
+
+  /**
+   * @brief The processor time spent playing the games, in seconds.
+   */
+  double elapsed_seconds;
+} simulation_summary;
+
+/**
+ * @def GAME_LANES
+ * @brief The number of games a `game_lanes` block advances together, one per 32-bit lane of an AVX2 register.
+ */
+#define GAME_LANES 8
+
+/**
+ * @typedef game_lanes
+ * @brief Structure holding the state of `GAME_LANES` independent games in structure-of-arrays form, so that one vector instruction advances all of them.
+ *
+ * Element `lane` of every array belongs to the game played in that lane.
+ */
+typedef struct game_lanes {
+  /**
+   * @brief Word `k` of the dice `rng` of every lane.
+   */
+  _Alignas(32) uint64_t rng[4][GAME_LANES];
+
+  /**
+   * @brief The position of every player of every lane.
+   */
+  _Alignas(32) uint32_t positions[MAXIMUM_NUMBER_OF_PLAYERS][GAME_LANES];
+
+  /**
+   * @brief The player whose turn it is.
+   */
+  _Alignas(32) uint32_t current_player[GAME_LANES];
+
+  /**
+   * @brief The number of sixes rolled in a row in the current turn.
+   */
+  _Alignas(32) uint32_t consecutive_sixes[GAME_LANES];
+
+  /**
+   * @brief The number of completed rounds.
+   */
+  _Alignas(32) uint32_t round[GAME_LANES];
+
+  /**
+   * @brief The number of completed turns.
+   */
+  _Alignas(32) uint32_t turns[GAME_LANES];
+
+  /**
+   * @brief The number of dice rolls.
+   */
+  _Alignas(32) uint32_t rolls[GAME_LANES];
+
+  /**
+   * @brief The number of ladders climbed.
+   */
+  _Alignas(32) uint32_t ladder_hits[GAME_LANES];
+
+  /**
+   * @brief The number of snakes that bit a player.
+   */
+  _Alignas(32) uint32_t snake_hits[GAME_LANES];
+
+  /**
+   * @brief The number of invalidated moves.
+   */
+  _Alignas(32) uint32_t invalidated_moves[GAME_LANES];
+
+  /**
+   * @brief All bits set once a player of the lane has reached the final cell.
+   */
+  _Alignas(32) uint32_t finished[GAME_LANES];
+
+  /**
+   * @brief All bits set while the lane plays a game, 0 once no game is left for it.
+   */
+  _Alignas(32) uint32_t active[GAME_LANES];
+
+  /**
+   * @brief The index of the game played in the lane.
+   */
+  uint32_t game[GAME_LANES];
+} game_lanes;
+
+/**
+ * @typedef transition_matrix
+ * @brief Structure holding a sparse matrix in compressed sparse row (CSR) form.
+ *
+ * It is used for the transitions between the transient states of the Markov chain of a board, where state `i` is the cell labeled `i + 1`.
+ */
+typedef struct transition_matrix {
+  /**
+   * @brief The number of rows (and columns) of the matrix.
+   */
+  unsigned int number_of_rows;
+
+  /**
+   * @brief Pointer to `number_of_rows + 1` offsets into `column` and `probability`, row `i` spans `row_start[i]` to `row_start[i + 1]`.
+   */
+  unsigned int* row_start;
+
+  /**
+   * @brief Pointer to the column of every stored entry.
+   */
+  unsigned int* column;
+
+  /**
+   * @brief Pointer to the value of every stored entry.
+   */
+  double* probability;
+} transition_matrix;
+
+/**
+ * @typedef absorbing_factorization
+ * @brief Structure holding a transient `transition_matrix` `Q` prepared for solving `x = b + Q x` directly.
+ *
+ * Moves that lead up the board make `I - Q` upper triangular, which is solved by one backward substitution along the labels. The moves that lead back down, down snakes, only end on a few states, the returns, so their effect is solved as a small dense system over the returns (see `_factor_absorbing`).
+ */
+typedef struct absorbing_factorization {
+  /**
+   * @brief The entries of `Q` whose column is above their row.
+   */
+  transition_matrix forward;
+
+  /**
+   * @brief Pointer to `1 / (1 - p)` for every state, where `p` is its probability to stay where it is.
+   */
+  double* leave;
+
+  /**
+   * @brief The number of returns, the states that moves back down the board end on.
+   */
+  unsigned int number_of_returns;
+
+  /**
+   * @brief Pointer to the returns, in ascending order.
+   */
+  unsigned int* return_state;
+
+  /**
+   * @brief The entries of `Q` whose column is below their row, grouped by return: row `a` holds the states that move back to `return_state[a]`, and their probabilities.
+   */
+  transition_matrix backward;
+
+  /**
+   * @brief The highest state with a move back down, where the backward substitutions of the returns start.
+   */
+  unsigned int highest_source;
+
+  /**
+   * @brief Pointer to the LU factors of the `number_of_returns` x `number_of_returns` system over the returns, row by row.
+   */
+  double* returns_system;
+
+  /**
+   * @brief Pointer to the row swapped into every row of `returns_system` while it was factored.
+   */
+  unsigned int* pivot;
+} absorbing_factorization;
+
+/**
+ * @typedef board_solution
+ * @brief Structure holding the exact game length statistics of a board, as computed by `solve_board`.
+ *
+ * The statistics are for the turns a single player needs to reach the final cell. Players do not interact, so the length of a game between several players follows from them (see `expected_rounds_for_players`).
+ */
+typedef struct board_solution {
+  /**
+   * @brief The expected number of turns to reach the final cell.
+   */
+  double expected_turns;
+
+  /**
+   * @brief The variance of the number of turns to reach the final cell.
+   */
+  double variance;
+
+  /**
+   * @brief The number of elements in `finish_probability`.
+   */
+  unsigned int number_of_turns;
+
+  /**
+   * @brief Pointer to the probability of reaching the final cell on exactly turn `k`, indexed by `k` (index 0 is always 0).
+   */
+  double* finish_probability;
+
+  /**
+   * @brief The probability of needing more than `number_of_turns - 1` turns, which is left out of `finish_probability`.
+   */
+  double remaining_probability;
+
+  /**
+   * @brief The factor by which the probability of not having finished shrinks every turn past the end of `finish_probability`, where the distribution goes on as a geometric tail.
+   */
+  double tail_ratio;
+} board_solution;
+
+/**
+ * @def TUNING_MAXIMUM_BOARDS
+ * @brief The largest number of boards a tuning candidate is measured on.
+ */
+#define TUNING_MAXIMUM_BOARDS 16
+
+/**
+ * @typedef tuning_options
+ * @brief Structure describing the search of `tune_generation_parameters` for one difficulty level and number of players.
+ */
+typedef struct tuning_options {
+  /**
+   * @brief The number of players the boards are generated and played for.
+   */
+  unsigned int number_of_players;
+
+  /**
+   * @brief The difficulty level the boards are generated for.
+   */
+  unsigned int difficulty;
+
+  /**
+   * @brief The expected number of rounds the boards should play for.
+   */
+  double target_rounds;
+
+  /**
+   * @brief The parameters the search starts from, they are always the first candidate.
+   */
+  generation_parameters start;
+
+  /**
+   * @brief The number of candidate parameters per generation of the search.
+   */
+  unsigned int candidates;
+
+  /**
+   * @brief The number of generations, each one searches closer around the best candidate so far.
+   */
+  unsigned int generations;
+
+  /**
+   * @brief The number of boards (one per seed) every candidate is measured on, at most `TUNING_MAXIMUM_BOARDS`.
+   */
+  unsigned int boards;
+
+  /**
+   * @brief The number of games played on every board.
+   */
+  unsigned int games;
+
+  /**
+   * @brief The number of threads measuring candidates.
+   */
+  unsigned int threads;
+
+  /**
+   * @brief The seed the candidates and the seeds of their boards are drawn from.
+   */
+  uint64_t seed;
+} tuning_options;
+
+/**
+ * @typedef tuning_result
+ * @brief Structure holding the best candidate found by `tune_generation_parameters`.
+ */
+typedef struct tuning_result {
+  /**
+   * @brief The parameters of the candidate.
+   */
+  generation_parameters parameters;
+
+  /**
+   * @brief The mean of `rounds`.
+   */
+  double mean_rounds;
+
+  /**
+   * @brief The mean distance of `rounds` from the target, as the absolute logarithm of their ratio. 0 is a perfect match, 0.1 is about 10% off.
+   */
+  double error;
+
+  /**
+   * @brief The number of boards the candidate was measured on.
+   */
+  unsigned int number_of_boards;
+
+  /**
+   * @brief The seeds of the boards.
+   */
+  uint64_t seeds[TUNING_MAXIMUM_BOARDS];
+
+  /**
+   * @brief The measured mean number of rounds of every board.
+   */
+  double rounds[TUNING_MAXIMUM_BOARDS];
+} tuning_result;
+
+/**
+ * @typedef tuning_measurement
+ * @brief Structure describing one board of a tuning candidate and how long its games lasted.
+ */
+typedef struct tuning_measurement {
+  /**
+   * @brief The parameters of the candidate.
+   */
+  generation_parameters parameters;
+
+  /**
+   * @brief The seed of the board.
+   */
+  uint64_t seed;
+
+  /**
+   * @brief The measured mean number of rounds.
+   */
+  double rounds;
+} tuning_measurement;
+
+/**
+ * @typedef tuning_work
+ * @brief Structure shared by the threads measuring the boards of one generation of a tuning search.
+ */
+typedef struct tuning_work {
+  /**
+   * @brief Pointer to the boards to measure.
+   */
+  tuning_measurement* measurements;
+
+  /**
+   * @brief The number of boards.
+   */
+  unsigned int number_of_measurements;
+
+  /**
+   * @brief The index of the next board to measure, taken by the threads one at a time.
+   */
+  _Atomic unsigned int next;
+
+  /**
+   * @brief The options of the search.
+   */
+  tuning_options options;
+} tuning_work;
+
+/**
+ * @def REPLAY_CODES_PER_WORD
+ * @brief The number of 3-bit `replay_code`s packed into each 64-bit word of a replay log, bit 63 stays clear.
+ */
+#define REPLAY_CODES_PER_WORD 21
+
+/**
+ * @def REPLAY_GAME_MARKER
+ * @brief The first word of every `replay_game_header`. Its top bit is set, which no word of codes has, so a game cut short by a crash is told apart from the game appended after it.
+ */
+#define REPLAY_GAME_MARKER UINT64_C(0xC51A00474D414745)
+
+/**
+ * @def REPLAY_BOARD_CACHE_SIZE
+ * @brief The number of boards the replayer keeps, so that the games of one board do not load it again.
+ */
+#define REPLAY_BOARD_CACHE_SIZE 64
+
+/**
+ * @enum replay_code
+ * @brief Enumeration of the 3-bit codes of a replay log. The codes 1 to 6 are the dice rolls themselves.
+ */
+typedef enum replay_code {
+  /// @brief The game is over (won or quit), the rest of the word is padding.
+  replay_end = 0,
+  /// @brief The turn of the current player is over.
+  replay_turn = 7,
+} replay_code;
+
+/**
+ * @typedef replay_file_header
+ * @brief Structure representing the header at the start of a replay log, which is followed by the games appended to it.
+ */
+typedef struct replay_file_header {
+  /**
+   * @brief The bytes `CSLREPLY`.
+   */
+  char magic[8];
+
+  /**
+   * @brief The version of the format, `REPLAY_FILE_VERSION` when written.
+   */
+  uint32_t version;
+
+  /**
+   * @brief The value 0x01020304 as written by the machine that created the log, to detect a different byte order.
+   */
+  uint32_t byte_order;
+} replay_file_header;
+
+/**
+ * @typedef replay_game_header
+ * @brief Structure representing the start of a game in a replay log, which is followed by the words of its codes.
+ *
+ * The board is only referenced: it is generated again from the configuration, or looked up in a board library if `from_library` is set, and has to match `fingerprint`.
+ */
+typedef struct replay_game_header {
+  /**
+   * @brief `REPLAY_GAME_MARKER`.
+   */
+  uint64_t marker;
+
+  /**
+   * @brief The seed of the configuration of the board.
+   */
+  uint64_t seed;
+
+  /**
+   * @brief The number of players of the configuration.
+   */
+  uint32_t number_of_players;
+
+  /**
+   * @brief The difficulty of the configuration.
+   */
+  uint32_t difficulty;
+
+  /**
+   * @brief The size of the board.
+   */
+  uint32_t board_size;
+
+  /**
+   * @brief 1 if the board was taken from a board library, 0 if it was generated.
+   */
+  uint32_t from_library;
+
+  /**
+   * @brief A hash of the jump table of the board, see `board_fingerprint`.
+   */
+  uint64_t fingerprint;
+} replay_game_header;
+
+/**
+ * @typedef replay_cached_board
+ * @brief Structure holding a board the replayer has loaded or generated.
+ */
+typedef struct replay_cached_board {
+  /**
+   * @brief Whether the slot holds a board.
+   */
+  bool used;
+
+  /**
+   * @brief The header of the game the board was loaded for, which identifies it.
+   */
+  replay_game_header reference;
+
+  /**
+   * @brief The board, if the reference could be resolved.
+   */
+  board board;
+
+  /**
+   * @brief A message describing why the board could not be resolved, or `NULL`.
+   */
+  validate_message error;
+} replay_cached_board;
+
+/**
+ * @typedef replay_summary
+ * @brief Structure aggregating a replayed log.
+ */
+typedef struct replay_summary {
+  /**
+   * @brief The results of the complete games that matched their boards.
+   */
+  simulation_summary results;
+
+  /**
+   * @brief The number of games in the log.
+   */
+  unsigned long long games;
+
+  /**
+   * @brief The number of rolls replayed.
+   */
+  unsigned long long rolls;
+
+  /**
+   * @brief The number of games whose turn markers or end do not match the move logic, as after a change of the rules.
+   */
+  unsigned long long diverged;
+
+  /**
+   * @brief The number of games cut short, because the process writing the log ended during them.
+   */
+  unsigned long long incomplete;
+
+  /**
+   * @brief The number of games skipped because their board could not be resolved or does not match its fingerprint.
+   */
+  unsigned long long missing_boards;
+
+  /**
+   * @brief The number of boards that were loaded or generated.
+   */
+  unsigned long long boards_resolved;
+} replay_summary;
+
+/**
+ * @def CAMPAIGN_HISTOGRAM_EXACT_ROUNDS
+ * @brief The rounds below which the rounds histogram of a `shard_result` has a bucket for every number of rounds.
+ */
+#define CAMPAIGN_HISTOGRAM_EXACT_ROUNDS 256
+
+/**
+ * @def CAMPAIGN_HISTOGRAM_BUCKETS_PER_DOUBLING
+ * @brief The number of buckets the rounds histogram of a `shard_result` splits every doubling of the rounds into, from `CAMPAIGN_HISTOGRAM_EXACT_ROUNDS` on.
+ */
+#define CAMPAIGN_HISTOGRAM_BUCKETS_PER_DOUBLING 32
+
+/**
+ * @def CAMPAIGN_HISTOGRAM_BUCKETS
+ * @brief The number of buckets of the rounds histogram of a `shard_result`. Bucket `i` below `CAMPAIGN_HISTOGRAM_EXACT_ROUNDS` counts the games that took `i` rounds, the buckets above are log-linear: each covers 1/32 of a doubling, and the 24 doublings from 2^8 to 2^32 reach the largest `uint32_t`, so no number of rounds falls past the last bucket (see `_rounds_bucket`).
+ */
+#define CAMPAIGN_HISTOGRAM_BUCKETS 1024
+
+/**
+ * @typedef campaign
+ * @brief Structure describing a simulation campaign: the games of one configuration played on a range of board seeds.
+ *
+ * Its games are numbered as units: unit `u` is game `u % games_per_seed` on the board of seed `first_seed + u / games_per_seed`, played exactly as `simulate_games` plays it.
+ */
+typedef struct campaign {
+  /**
+   * @brief The number of players.
+   */
+  uint32_t number_of_players;
+
+  /**
+   * @brief The difficulty level.
+   */
+  uint32_t difficulty;
+
+  /**
+   * @brief The seed of the first board.
+   */
+  uint64_t first_seed;
+
+  /**
+   * @brief The number of boards, with consecutive seeds.
+   */
+  uint64_t number_of_seeds;
+
+  /**
+   * @brief The number of games played on every board.
+   */
+  uint32_t games_per_seed;
+
+  /**
+   * @brief The round after which a game is abandoned, or 0 to play every game until a player wins.
+   */
+  uint32_t maximum_rounds;
+} campaign;
+
+/**
+ * @typedef shard_result
+ * @brief Structure holding the partial result of the games of one shard of a `campaign`.
+ *
+ * Every field is a count, a sum or an extreme, so the results of neighbouring shards are merged by adding them up, and the result of all shards merged is the same, byte for byte, as the result of a single shard holding the whole campaign.
+ */
+typedef struct shard_result {
+  /**
+   * @brief The campaign the games belong to.
+   */
+  campaign campaign;
+
+  /**
+   * @brief The first unit of the shard.
+   */
+  uint64_t first_unit;
+
+  /**
+   * @brief The unit after the last one of the shard.
+   */
+  uint64_t last_unit;
+
+  /**
+   * @brief The index of the shard, 0 for a merged result.
+   */
+  uint32_t shard;
+
+  /**
+   * @brief The number of shards the campaign was split into, 1 for a merged result.
+   */
+  uint32_t shards;
+
+  /**
+   * @brief The number of games played.
+   */
+  uint64_t games;
+
+  /**
+   * @brief The number of games in which a player reached the final cell.
+   */
+  uint64_t finished_games;
+
+  /**
+   * @brief The number of games won by each player.
+   */
+  uint64_t wins[MAXIMUM_NUMBER_OF_PLAYERS];
+
+  /**
+   * @brief The fewest rounds any game took.
+   */
+  uint32_t minimum_rounds;
+
+  /**
+   * @brief The most rounds any game took.
+   */
+  uint32_t maximum_rounds;
+
+  /**
+   * @brief The sum of `rounds` over all games.
+   */
+  uint64_t total_rounds;
+
+  /**
+   * @brief The sum of `turns` over all games.
+   */
+  uint64_t total_turns;
+
+  /**
+   * @brief The sum of `rolls` over all games.
+   */
+  uint64_t total_rolls;
+
+  /**
+   * @brief The sum of `ladder_hits` over all games.
+   */
+  uint64_t total_ladder_hits;
+
+  /**
+   * @brief The sum of `snake_hits` over all games.
+   */
+  uint64_t total_snake_hits;
+
+  /**
+   * @brief The sum of `invalidated_moves` over all games.
+   */
+  uint64_t total_invalidated_moves;
+
+  /**
+   * @brief The number of games by the rounds they took, see `CAMPAIGN_HISTOGRAM_BUCKETS`.
+   */
+  uint64_t rounds_histogram[CAMPAIGN_HISTOGRAM_BUCKETS];
+} shard_result;
+
+/**
+ * @typedef shard_file_header
+ * @brief Structure representing the header at the start of a shard file, which is followed by its `shard_result`.
+ */
+typedef struct shard_file_header {
+  /**
+   * @brief The bytes `CSLSHARD`.
+   */
+  char magic[8];
+
+  /**
+   * @brief The version of the format, `SHARD_FILE_VERSION` when written.
+   */
+  uint32_t version;
+
+  /**
+   * @brief The value 0x01020304 as written by the machine that saved the file, to detect a different byte order.
+   */
+  uint32_t byte_order;
+
+  /**
+   * @brief The checksum of the `shard_result`.
+   */
+  uint64_t checksum;
+} shard_file_header;
+
+/**
+ * @def SERVER_INPUT_BUFFER_SIZE
+ * @brief The size of the input buffer of a `server_connection`, which is also the longest request accepted.
+ */
+#define SERVER_INPUT_BUFFER_SIZE 256
+
+/**
+ * @def SERVER_OUTPUT_BUFFER_SIZE
+ * @brief The size of the output buffer of a `server_connection`.
+ */
+#define SERVER_OUTPUT_BUFFER_SIZE 4096
+
+/**
+ * @def SERVER_MAXIMUM_REPLY
+ * @brief The longest reply to a single request. A request is only handled while the output buffer has this much room, so a client that does not read its replies stops being read instead of growing the buffer.
+ */
+#define SERVER_MAXIMUM_REPLY 192
+
+/**
+ * @def SERVER_ARENA_BLOCK_SIZE
+ * @brief The block size of the arena every connection generates its boards into, small so that thousands of idle connections cost little.
+ */
+#define SERVER_ARENA_BLOCK_SIZE (16 * 1024)
+
+/**
+ * @typedef server_connection
+ * @brief Structure holding a client connection of a `game_server` and the game it plays.
+ *
+ * Connections live in a pool that is allocated once; a closed connection keeps its buffers and its arena for the next client that takes its slot.
+ */
+typedef struct server_connection {
+  /**
+   * @brief The socket of the client, or -1 if the slot is free.
+   */
+  int socket;
+
+  /**
+   * @brief The next slot of the list of freed slots, while this one is free.
+   */
+  unsigned int next_free;
+
+  /**
+   * @brief Whether the connection waits for the socket to take more output, instead of for input.
+   */
+  bool waiting_to_write;
+
+  /**
+   * @brief The number of bytes in `input`, a partial request at most once all complete ones are handled.
+   */
+  unsigned int input_length;
+
+  /**
+   * @brief The offset of the first byte of `output` that has not been sent.
+   */
+  unsigned int output_start;
+
+  /**
+   * @brief The offset after the last byte of `output`.
+   */
+  unsigned int output_end;
+
+  /**
+   * @brief The requests read but not handled yet.
+   */
+  char input[SERVER_INPUT_BUFFER_SIZE];
+
+  /**
+   * @brief The replies not sent yet.
+   */
+  char output[SERVER_OUTPUT_BUFFER_SIZE];
+
+  /**
+   * @brief The arena the board of the game is generated into, reset for every new game.
+   */
+  arena boards;
+
+  /**
+   * @brief Whether a game has been started on this connection.
+   */
+  bool playing;
+
+  /**
+   * @brief The positions of the players of the game.
+   */
+  player players[MAXIMUM_NUMBER_OF_PLAYERS];
+
+  /**
+   * @brief The game, whose `players` point to `players`.
+   */
+  game game;
+
+  /**
+   * @brief The dice of the game.
+   */
+  rng dice;
+} server_connection;
+
+/**
+ * @typedef game_server
+ * @brief Structure holding the state of one event loop thread of the game server.
+ */
+typedef struct game_server {
+  /**
+   * @brief The epoll instance of the thread.
+   */
+  int epoll;
+
+  /**
+   * @brief The listening socket, of this thread alone for TCP, shared by every thread for a Unix socket.
+   */
+  int listener;
+
+  /**
+   * @brief The descriptor that becomes readable when the server has to stop, shared by every thread.
+   */
+  int wake;
+
+  /**
+   * @brief The pool of connections.
+   */
+  server_connection* connections;
+
+  /**
+   * @brief The number of slots of the pool.
+   */
+  unsigned int maximum_connections;
+
+  /**
+   * @brief The number of slots that have ever been taken. The slots above it have never been touched, so their memory is not committed yet.
+   */
+  unsigned int slots_used;
+
+  /**
+   * @brief The first slot of the list of slots that were taken and freed again, or `maximum_connections` if there is none.
+   */
+  unsigned int first_free;
+
+  /**
+   * @brief The number of connections accepted.
+   */
+  unsigned long long accepted;
+
+  /**
+   * @brief The number of connections closed at once because the pool was full.
+   */
+  unsigned long long refused;
+
+  /**
+   * @brief The number of requests handled.
+   */
+  unsigned long long requests;
+
+  /**
+   * @brief The number of games won.
+   */
+  unsigned long long games_won;
+} game_server;
+
+/**
+ * @def SESSION_QUEUE_CAPACITY
+ * @brief The number of sessions the run queue of one worker of a `session_scheduler` holds, a power of two. Sessions that do not fit go to the shared queue.
+ */
+#define SESSION_QUEUE_CAPACITY 256
+
+/**
+ * @def SESSION_QUANTUM
+ * @brief The most rolls a worker plays in a session before it goes to the back of the run queue, so that no session holds a worker for long.
+ */
+#define SESSION_QUANTUM 32
+
+/**
+ * @def SESSION_SHARED_INTERVAL
+ * @brief Every this many quanta a worker looks at the shared queue before its own, so sessions submitted from outside are not starved by busy run queues.
+ */
+#define SESSION_SHARED_INTERVAL 61
+
+/**
+ * @enum session_controller
+ * @brief Enumeration of who rolls the dice for a player of a session.
+ */
+typedef enum session_controller {
+  /// @brief The session rolls for the player as soon as it is the player's turn.
+  controller_bot,
+  /// @brief The session waits at the player's turn until a roll is requested with `request_session_roll`.
+  controller_human,
+} session_controller;
+
+/**
+ * @enum session_state
+ * @brief Enumeration of what a session needs after a step.
+ */
+typedef enum session_state {
+  /// @brief The session can go on right away.
+  session_runnable,
+  /// @brief It is the turn of a human player who has not asked for a roll yet.
+  session_waiting,
+  /// @brief A player has won.
+  session_finished,
+} session_state;
+
+/**
+ * @typedef session
+ * @brief Structure holding one game as a resumable state machine: everything needed to play its next roll, on whichever thread picks it up.
+ */
+typedef struct session {
+  /**
+   * @brief The turn state of the game, whose `players` point to `players`.
+   */
+  game game;
+
+  /**
+   * @brief The positions of the players.
+   */
+  player players[MAXIMUM_NUMBER_OF_PLAYERS];
+
+  /**
+   * @brief Who rolls for each player.
+   */
+  session_controller controllers[MAXIMUM_NUMBER_OF_PLAYERS];
+
+  /**
+   * @brief The dice of the game.
+   */
+  rng dice;
+
+  /**
+   * @brief The rolls human players have asked for and the session has not played yet.
+   */
+  _Atomic unsigned int requested_rolls;
+
+  /**
+   * @brief Whether the session waits for a human and is in no run queue, so that whoever clears it has to schedule it.
+   */
+  _Atomic bool parked;
+
+  /**
+   * @brief The next session in the shared queue of the scheduler.
+   */
+  struct session* next;
+
+  /**
+   * @brief The monotonic time the session was last put into a run queue.
+   */
+  uint64_t queued_at;
+
+  /**
+   * @brief The number of quanta the session was run for.
+   */
+  unsigned int quanta;
+
+  /**
+   * @brief The total time the session spent runnable in run queues, in nanoseconds.
+   */
+  uint64_t total_wait;
+
+  /**
+   * @brief The longest time the session spent runnable in a run queue at once, in nanoseconds.
+   */
+  uint64_t longest_wait;
+} session;
+
+/**
+ * @typedef session_queue
+ * @brief Structure holding the run queue of one worker: a ring that only the worker pushes to, and that the worker and thieves take from the front of.
+ *
+ * Taking from the front for both keeps the queue first in, first out, so a session that used up its quantum goes behind every other runnable one.
+ */
+typedef struct session_queue {
+  /**
+   * @brief The number of sessions ever taken, advanced with a compare-and-swap by whoever takes one.
+   */
+  _Alignas(64) _Atomic uint64_t head;
+
+  /**
+   * @brief The number of sessions ever pushed, only written by the owner.
+   */
+  _Alignas(64) _Atomic uint64_t tail;
+
+  /**
+   * @brief The sessions, session `i` is at `slots[i % SESSION_QUEUE_CAPACITY]`.
+   */
+  _Alignas(64) struct session* _Atomic slots[SESSION_QUEUE_CAPACITY];
+} session_queue;
+
+/**
+ * @typedef session_worker
+ * @brief Structure holding one worker thread of a `session_scheduler`.
+ */
+typedef struct session_worker {
+  /**
+   * @brief The run queue of the worker.
+   */
+  session_queue queue;
+
+  /**
+   * @brief The scheduler the worker belongs to.
+   */
+  struct session_scheduler* scheduler;
+
+  /**
+   * @brief The index of the worker.
+   */
+  unsigned int index;
+
+  /**
+   * @brief The generator picking the workers to steal from.
+   */
+  rng victims;
+
+  /**
+   * @brief The thread of the worker.
+   */
+  pthread_t thread;
+
+  /**
+   * @brief The number of rolls played by the worker.
+   */
+  unsigned long long rolls;
+
+  /**
+   * @brief The number of quanta run by the worker.
+   */
+  unsigned long long quanta;
+
+  /**
+   * @brief The number of sessions the worker stole from other workers.
+   */
+  unsigned long long steals;
+
+  /**
+   * @brief The number of times the worker went to sleep for lack of work.
+   */
+  unsigned long long sleeps;
+} session_worker;
+
+/**
+ * @typedef session_scheduler
+ * @brief Structure holding a pool of worker threads that play sessions, stealing runnable sessions from each other when they run out.
+ */
+typedef struct session_scheduler {
+  /**
+   * @brief The workers.
+   */
+  session_worker* workers;
+
+  /**
+   * @brief The number of workers.
+   */
+  unsigned int number_of_workers;
+
+  /**
+   * @brief The lock of the shared queue, the sleeping workers and the waiters.
+   */
+  pthread_mutex_t lock;
+
+  /**
+   * @brief Signalled when there is work for a sleeping worker, or the scheduler stops.
+   */
+  pthread_cond_t work;
+
+  /**
+   * @brief Signalled when the last session has finished.
+   */
+  pthread_cond_t drained;
+
+  /**
+   * @brief The first session of the shared queue, which holds sessions submitted from outside the workers.
+   */
+  session* shared_first;
+
+  /**
+   * @brief The last session of the shared queue.
+   */
+  session* shared_last;
+
+  /**
+   * @brief Whether the shared queue holds any session, read without the lock.
+   */
+  _Atomic bool shared_pending;
+
+  /**
+   * @brief The number of workers that are asleep or about to be.
+   */
+  _Atomic unsigned int sleeping;
+
+  /**
+   * @brief The number of sessions submitted and not finished.
+   */
+  _Atomic unsigned long long unfinished;
+
+  /**
+   * @brief Whether the workers have to stop.
+   */
+  _Atomic bool stopping;
+} session_scheduler;
 
 #endif //CSNAKE_LADDER_TYPES_H
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "types.h"
+#include "campaign.h"
+#include "arena.h"
+#include "timer.h"
+
+// Plays one shard of a simulation campaign and writes its partial result, see campaign.h.
+//
+// Usage: worker <shard> <shards> <shard file> <players> <difficulty> <first seed> <seeds> <games per seed> [maximum rounds]
+//
+// The campaign plays `games per seed` games on each of the boards with seeds `first seed`..`first seed + seeds - 1`.
+// Every worker of a campaign is started with the same campaign and its own `shard` out of `shards`, on this machine
+// or any other, and they need not talk to each other: the shard alone decides which games a worker plays. The
+// shard files are brought together and combined with merger.c, e.g. for four local workers:
+//
+//     for shard in 0 1 2 3; do ./worker $shard 4 part$shard.shard 4 7 1 100 1000 & done; wait
+//     ./merger campaign.shard part*.shard
+//
+// Games are abandoned after `maximum rounds` rounds, or never with 0 (the default).
+
+int main(int argc, char** argv) {
+    if(argc < 9 || argc > 10) {
+        fprintf(stderr,"Usage: %s <shard> <shards> <shard file> <players> <difficulty> <first seed> <seeds> <games per seed> [maximum rounds]\n",argv[0]);
+        return 1;
+    }
+
+    const unsigned int shard = (unsigned int) strtoul(argv[1],NULL,10);
+    const unsigned int shards = (unsigned int) strtoul(argv[2],NULL,10);
+    const char *const path = argv[3];
+
+    const campaign campaign = {
+        .number_of_players = (uint32_t) strtoul(argv[4],NULL,10),
+        .difficulty = (uint32_t) strtoul(argv[5],NULL,10),
+        .first_seed = strtoull(argv[6],NULL,10),
+        .number_of_seeds = strtoull(argv[7],NULL,10),
+        .games_per_seed = (uint32_t) strtoul(argv[8],NULL,10),
+        .maximum_rounds = argc > 9 ? (uint32_t) strtoul(argv[9],NULL,10) : 0,
+    };
+
+    if(shards == 0 || shard >= shards) {
+        fprintf(stderr,"The shard has to be below the number of shards!\n");
+        return 1;
+    }
+
+    const validate_message message = check_campaign(campaign);
+
+    if(message != NULL) {
+        fprintf(stderr,"%s",message);
+        return 1;
+    }
+
+    shard_result* result = malloc(sizeof(shard_result));
+
+    if(result == NULL) {
+        perror("malloc has failed");
+        return 1;
+    }
+
+    arena boards = create_arena(0);
+
+    const uint64_t started = monotonic_nanoseconds();
+
+    run_campaign_shard(campaign,shard,shards,&boards,result);
+
+    const double seconds = (monotonic_nanoseconds() - started) / 1e9;
+
+    free_arena(boards);
+
+    const validate_message error = save_shard_result(result,path);
+
+    if(error != NULL) {
+        fprintf(stderr,"%s: %s",path,error);
+        free(result);
+        return 1;
+    }
+
+    fprintf(stderr,"shard %u/%u: games %llu..%llu, %llu games in %.2fs (%.0f games per second)\n",
+        shard,shards,(unsigned long long) result->first_unit,(unsigned long long) result->last_unit,
+        (unsigned long long) result->games,seconds,seconds > 0 ? result->games / seconds : 0
+    );
+
+    free(result);
+
+    return 0;
+}